@@ -0,0 +1,35 @@
+#!/bin/bash
+# Offline DSP harness (Linux / macOS): WAV or generated signal -> spectrum/beat frames
+# Usage: ./build-harness.sh && ./bin/dsp_harness --gen clicks:120 --expect-bpm 120
+#        ./bin/gif_harness --check (GIF decoder conformance) / --bench FILE.gif...
+
+set -e
+cd "$(dirname "$0")"
+mkdir -p bin
+
+CXX=${CXX:-g++}
+$CXX -O2 -std=c++17 -Wall -Isrc -o bin/dsp_harness \
+    src/dsp_harness.cpp \
+    src/audio_pipeline.cpp \
+    src/auto_gain.cpp \
+    src/bar_mapper.cpp \
+    src/beat_tracker.cpp \
+    src/constant_q.cpp \
+    src/decimator.cpp \
+    src/dsp_kernels.cpp \
+    src/fft.cpp \
+    src/hpss.cpp \
+    src/sample_convert.cpp \
+    src/spectral_features.cpp \
+    src/spectrogram.cpp \
+    src/spsc_ring.cpp \
+    src/stft.cpp \
+    -lpthread -lm
+
+$CXX -O2 -std=c++17 -Wall -Isrc -o bin/gif_harness \
+    src/gif_harness.cpp \
+    src/gif_decoder.cpp \
+    src/dsp_kernels.cpp \
+    src/frame_cache.cpp
+
+echo "Built bin/dsp_harness bin/gif_harness"
@@ -16,6 +16,23 @@ if not exist releases mkdir releases
 echo Compiling (Release with static runtime)...
 cl /nologo /W3 /O2 /EHsc /std:c++17 /MT /c /I"C:\Program Files (x86)\Windows Kits\10\Include\10.0.22621.0\cppwinrt" /Fo:obj\media_info.obj src\media_info.cpp
 cl /nologo /W3 /O2 /EHsc /MT /c /Fo:obj\gif_player.obj src\gif_player.cpp
+cl /nologo /W3 /O2 /EHsc /MT /c /Fo:obj\audio_capture.obj src\audio_capture.cpp
+cl /nologo /W3 /O2 /EHsc /MT /c /Fo:obj\fft.obj src\fft.cpp
+cl /nologo /W3 /O2 /EHsc /MT /c /Fo:obj\dsp_kernels.obj src\dsp_kernels.cpp
+cl /nologo /W3 /O2 /EHsc /MT /c /Fo:obj\stft.obj src\stft.cpp
+cl /nologo /W3 /O2 /EHsc /MT /c /Fo:obj\spsc_ring.obj src\spsc_ring.cpp
+cl /nologo /W3 /O2 /EHsc /MT /c /Fo:obj\audio_pipeline.obj src\audio_pipeline.cpp
+cl /nologo /W3 /O2 /EHsc /MT /c /Fo:obj\bar_mapper.obj src\bar_mapper.cpp
+cl /nologo /W3 /O2 /EHsc /MT /c /Fo:obj\beat_tracker.obj src\beat_tracker.cpp
+cl /nologo /W3 /O2 /EHsc /MT /c /Fo:obj\sample_convert.obj src\sample_convert.cpp
+cl /nologo /W3 /O2 /EHsc /MT /c /Fo:obj\auto_gain.obj src\auto_gain.cpp
+cl /nologo /W3 /O2 /EHsc /MT /c /Fo:obj\spectral_features.obj src\spectral_features.cpp
+cl /nologo /W3 /O2 /EHsc /MT /c /Fo:obj\decimator.obj src\decimator.cpp
+cl /nologo /W3 /O2 /EHsc /MT /c /Fo:obj\constant_q.obj src\constant_q.cpp
+cl /nologo /W3 /O2 /EHsc /MT /c /Fo:obj\spectrogram.obj src\spectrogram.cpp
+cl /nologo /W3 /O2 /EHsc /MT /c /Fo:obj\hpss.obj src\hpss.cpp
+cl /nologo /W3 /O2 /EHsc /MT /c /Fo:obj\gif_decoder.obj src\gif_decoder.cpp
+cl /nologo /W3 /O2 /EHsc /MT /c /Fo:obj\frame_cache.obj src\frame_cache.cpp
 cl /nologo /W3 /O2 /MT /c /I src /Fo:obj\settings.obj src\settings.c
 cl /nologo /W3 /O2 /MT /c /I src /Fo:obj\main.obj src\main.c
 
@@ -24,10 +41,10 @@ rc /nologo /fo obj\resource.res src\resource.rc
 
 if exist obj\resource.res (
     echo Linking with icon...
-    link /nologo /OUT:bin\MusicWidget.exe obj\main.obj obj\media_info.obj obj\gif_player.obj obj\settings.obj obj\resource.res user32.lib gdi32.lib ole32.lib gdiplus.lib shell32.lib windowsapp.lib runtimeobject.lib advapi32.lib dwmapi.lib /SUBSYSTEM:WINDOWS
+    link /nologo /OUT:bin\MusicWidget.exe obj\main.obj obj\media_info.obj obj\gif_player.obj obj\settings.obj obj\audio_capture.obj obj\fft.obj obj\dsp_kernels.obj obj\stft.obj obj\spsc_ring.obj obj\audio_pipeline.obj obj\bar_mapper.obj obj\beat_tracker.obj obj\sample_convert.obj obj\auto_gain.obj obj\spectral_features.obj obj\decimator.obj obj\constant_q.obj obj\spectrogram.obj obj\hpss.obj obj\gif_decoder.obj obj\frame_cache.obj obj\resource.res user32.lib gdi32.lib ole32.lib gdiplus.lib shell32.lib windowsapp.lib runtimeobject.lib advapi32.lib dwmapi.lib /SUBSYSTEM:WINDOWS
 ) else (
     echo Linking without icon...
-    link /nologo /OUT:bin\MusicWidget.exe obj\main.obj obj\media_info.obj obj\gif_player.obj obj\settings.obj user32.lib gdi32.lib ole32.lib gdiplus.lib shell32.lib windowsapp.lib runtimeobject.lib advapi32.lib dwmapi.lib /SUBSYSTEM:WINDOWS
+    link /nologo /OUT:bin\MusicWidget.exe obj\main.obj obj\media_info.obj obj\gif_player.obj obj\settings.obj obj\audio_capture.obj obj\fft.obj obj\dsp_kernels.obj obj\stft.obj obj\spsc_ring.obj obj\audio_pipeline.obj obj\bar_mapper.obj obj\beat_tracker.obj obj\sample_convert.obj obj\auto_gain.obj obj\spectral_features.obj obj\decimator.obj obj\constant_q.obj obj\spectrogram.obj obj\hpss.obj obj\gif_decoder.obj obj\frame_cache.obj user32.lib gdi32.lib ole32.lib gdiplus.lib shell32.lib windowsapp.lib runtimeobject.lib advapi32.lib dwmapi.lib /SUBSYSTEM:WINDOWS
 )
 
 if %errorlevel% neq 0 (
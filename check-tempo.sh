@@ -0,0 +1,142 @@
+#!/bin/bash
+# Known-tempo check: synthesizes short drum loops as WAV files (various formats / patterns)
+# and runs each through the DSP harness with --expect-bpm; exits 1 if any tempo is off.
+# Loops listed in XFAIL are known misreads: they print XFAIL with the reason and do not fail
+# the check, but an XFAIL loop that starts passing does (so the list is kept current).
+# Usage: ./build-harness.sh && ./check-tempo.sh [TOLERANCE_BPM]
+
+set -e
+cd "$(dirname "$0")"
+
+TOLERANCE=${1:-2}
+HARNESS=bin/dsp_harness
+if [ ! -x "$HARNESS" ]; then
+    echo "error: $HARNESS not found, run ./build-harness.sh first" >&2
+    exit 2
+fi
+
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+
+# name,bpm,pattern,rate,channels,format (pcm16 / pcm24 / float32)
+CORPUS="
+ballad-72,72,ballad,44100,2,pcm16
+hiphop-90,90,backbeat,48000,1,pcm24
+lofi-96,96,backbeat,22050,1,pcm16
+pop-120,120,backbeat,48000,2,float32
+house-128,128,four,44100,2,pcm16
+trance-140,140,four,48000,1,pcm16
+hardcore-160,160,kicks,44100,2,pcm24
+techno-150,150,four,48000,2,pcm16
+hardstyle-150,150,kicks,48000,1,pcm16
+gabber-170,170,kicks,44100,2,pcm16
+punk-160,160,backbeat,48000,2,pcm16
+punk-170,170,backbeat,44100,2,pcm16
+breaks-100,100,breakbeat,22050,1,pcm16
+breaks-110,110,breakbeat,22050,1,pcm16
+breaks-125,125,breakbeat,22050,1,pcm16
+"
+
+# name -> reason the tracker still reads the wrong tempo
+declare -A XFAIL=(
+    [punk-160]="kick on 1/3 and snare on 2/4 this fast reads as half time (prior centred on 120 BPM)"
+    [punk-170]="kick on 1/3 and snare on 2/4 this fast reads as half time (prior centred on 120 BPM)"
+    [breaks-100]="dotted kick (16ths 0 and 10) makes 1.5 beats the strongest period, locks at 2/3 tempo"
+    [breaks-110]="dotted kick (16ths 0 and 10) makes 1.5 beats the strongest period, locks at 2/3 tempo"
+    [breaks-125]="dotted kick (16ths 0 and 10) makes 1.5 beats the strongest period, locks at 2/3 tempo"
+)
+
+python3 - "$DIR" "$CORPUS" <<'PY'
+import math, random, struct, sys
+
+out, corpus = sys.argv[1], sys.argv[2]
+SECONDS = 20.0
+
+def kick(t):
+    return math.sin(2 * math.pi * (50 + 80 * math.exp(-t * 30)) * t) * math.exp(-t * 12)
+
+def snare(t, rng):
+    return (0.6 * (rng.random() * 2 - 1) + 0.4 * math.sin(2 * math.pi * 190 * t)) * math.exp(-t * 20)
+
+def hat(t, rng):
+    return (rng.random() * 2 - 1) * math.exp(-t * 90)
+
+# 16분음표 격자 위의 (종류, 위치) 한 마디
+PATTERNS = {
+    "ballad": [("k", 0), ("k", 8), ("s", 4), ("s", 12)] + [("h", i) for i in range(0, 16, 4)],
+    "backbeat": [("k", 0), ("k", 8), ("k", 10), ("s", 4), ("s", 12)] + [("h", i) for i in range(0, 16, 2)],
+    "four": [("k", i) for i in range(0, 16, 4)] + [("s", 4), ("s", 12)] + [("h", i) for i in range(2, 16, 4)],
+    "breakbeat": [("k", 0), ("k", 10), ("s", 4), ("s", 12), ("s", 15)] + [("h", i) for i in range(0, 16, 2)],
+    "kicks": [("k", i) for i in range(0, 16, 4)] + [("h", i) for i in range(2, 16, 4)],
+}
+
+def render(bpm, pattern, rate):
+    rng = random.Random(bpm)
+    n = int(SECONDS * rate)
+    data = [0.0] * n
+    step = 60.0 / bpm / 4
+    hit_len = int(0.4 * rate)
+    bars = int(SECONDS / (step * 16)) + 1
+    for bar in range(bars):
+        for kind, pos in PATTERNS[pattern]:
+            start = int((bar * 16 + pos) * step * rate)
+            gain = {"k": 0.7, "s": 0.45, "h": 0.15}[kind]
+            for i in range(min(hit_len, n - start) if start < n else 0):
+                t = i / rate
+                v = kick(t) if kind == "k" else snare(t, rng) if kind == "s" else hat(t, rng)
+                data[start + i] += gain * v
+    return data
+
+def write_wav(path, data, rate, channels, fmt):
+    bits = {"pcm16": 16, "pcm24": 24, "float32": 32}[fmt]
+    frames = bytearray()
+    for v in data:
+        v = max(-1.0, min(1.0, v))
+        if fmt == "float32":
+            sample = struct.pack("<f", v)
+        elif fmt == "pcm24":
+            sample = struct.pack("<i", int(v * 8388607))[:3]
+        else:
+            sample = struct.pack("<h", int(v * 32767))
+        frames += sample * channels
+    tag = 3 if fmt == "float32" else 1
+    align = channels * bits // 8
+    with open(path, "wb") as f:
+        f.write(b"RIFF" + struct.pack("<I", 36 + len(frames)) + b"WAVE")
+        f.write(b"fmt " + struct.pack("<IHHIIHH", 16, tag, channels, rate, rate * align, align, bits))
+        f.write(b"data" + struct.pack("<I", len(frames)) + frames)
+
+for line in corpus.split():
+    name, bpm, pattern, rate, channels, fmt = line.split(",")
+    write_wav("%s/%s.wav" % (out, name), render(float(bpm), pattern, int(rate)), int(rate), int(channels), fmt)
+PY
+
+FAILED=0
+XFAILED=0
+for LINE in $CORPUS; do
+    IFS=, read -r NAME BPM PATTERN RATE CHANNELS FORMAT <<< "$LINE"
+    RESULT=$("$HARNESS" "$DIR/$NAME.wav" --expect-bpm "$BPM:$TOLERANCE" | grep -E '^(tempo|expect)') || true
+    TEMPO=$(echo "$RESULT" | sed -n 's/^tempo *\([0-9.]*\).*/\1/p')
+    REASON=${XFAIL[$NAME]:-}
+    if echo "$RESULT" | grep -q ': ok$'; then
+        if [ -n "$REASON" ]; then
+            STATUS="XPASS (remove from XFAIL)"
+            FAILED=1
+        else
+            STATUS="ok"
+        fi
+    elif [ -n "$REASON" ]; then
+        STATUS="XFAIL: $REASON"
+        XFAILED=$((XFAILED + 1))
+    else
+        STATUS="FAIL"
+        FAILED=1
+    fi
+    printf "%-13s %3s bpm  %-9s %5s Hz %d ch %-7s  -> %6s bpm  %s\n" "$NAME" "$BPM" "$PATTERN" "$RATE" "$CHANNELS" "$FORMAT" "$TEMPO" "$STATUS"
+done
+
+if [ $FAILED -ne 0 ]; then
+    echo "tempo check FAILED"
+    exit 1
+fi
+echo "tempo check passed ($XFAILED expected failures)"
@@ -1,20 +1,39 @@
 /*
  * audio_capture.cpp - WASAPI Loopback Audio Capture
+ * 캡처 스레드(이벤트 구동, MMCSS) -> SPSC 링 -> DSP 스레드 -> 최근 프레임 링 -> UI
  */
 
 #include "audio_capture.h"
+#include "audio_pipeline.h"
+#include "sample_convert.h"
+#include "fft.h"
 
 #include <windows.h>
 #include <mmdeviceapi.h>
 #include <audioclient.h>
+#include <endpointvolume.h>
+#include <mmreg.h>
+#include <avrt.h>
 #include <math.h>
+#include <string.h>
+#include <atomic>
+#include <mutex>
 
 #pragma comment(lib, "ole32.lib")
+#pragma comment(lib, "avrt.lib")
 
 #define REFTIMES_PER_SEC  10000000
 #define REFTIMES_PER_MILLISEC  10000
-#define SAMPLE_BUFFER_SIZE 2048
-#define PI 3.14159265358979323846
+#define CAPTURE_BUFFER_DURATION (100 * REFTIMES_PER_MILLISEC)
+#define CAPTURE_WAIT_TIMEOUT 20   // 루프백 이벤트가 안 오는 경우 대비 폴링 간격 (ms)
+#define DSP_WAIT_TIMEOUT 100
+#define DEFAULT_FFT_SIZE 2048
+#define DEFAULT_HOP_SIZE 512
+#define DEFAULT_BAR_SCALE BAR_SCALE_OCTAVE
+#define MONO_CHUNK_SIZE 1024
+#define DEFAULT_IDLE_TIMEOUT 5000   // 이만큼 조용하면 WASAPI 클라이언트 정지 (ms)
+#define PACKET_IDLE_TIMEOUT 100     // 루프백은 아무것도 재생하지 않으면 패킷을 보내지 않음 (ms)
+#define METER_WAKE_LEVEL 0.0003f    // 정지 중 이 이상의 장치 피크면 재개 (약 -70 dBFS)
 
 // 전역 변수
 static IMMDeviceEnumerator* g_pEnumerator = NULL;
@@ -23,128 +42,459 @@ static IAudioClient* g_pAudioClient = NULL;
 static IAudioCaptureClient* g_pCaptureClient = NULL;
 static WAVEFORMATEX* g_pwfx = NULL;
 static bool g_initialized = false;
+static bool g_pipelineReady = false;
 
-// 샘플 버퍼
-static float g_sampleBuffer[SAMPLE_BUFFER_SIZE];
-static int g_sampleIndex = 0;
-
-// FFT 결과
-static float g_fftOutput[SAMPLE_BUFFER_SIZE / 2];
-
-// 간단한 DFT (FFT 대신 사용, 성능보다 간단함 우선)
-static void SimpleDFT(float* input, float* output, int n) {
-    int numBins = n / 2;
-    for (int k = 0; k < numBins; k++) {
-        float real = 0.0f;
-        float imag = 0.0f;
-        for (int t = 0; t < n; t++) {
-            float angle = 2.0f * (float)PI * k * t / n;
-            real += input[t] * cosf(angle);
-            imag -= input[t] * sinf(angle);
+// 스레드
+static HANDLE g_captureThread = NULL;
+static HANDLE g_dspThread = NULL;
+static HANDLE g_captureEvent = NULL;   // WASAPI가 패킷 준비 시 신호
+static HANDLE g_dspEvent = NULL;       // 캡처 스레드가 샘플을 넣으면 신호
+static HANDLE g_stopEvent = NULL;
+static HANDLE g_wakeEvent = NULL;      // 재생이 다시 시작되면 신호 (정지 상태에서 깨움)
+
+// 무음 / 일시정지 게이트와 클라이언트 정지
+static IAudioMeterInformation* g_pMeter = NULL;    // 정지 중 소리가 다시 나는지 확인
+static std::atomic<int> g_paused(0);
+static std::atomic<int> g_suspended(0);
+static float g_gateDb = PIPELINE_GATE_DEFAULT_DB;
+
+// 막대 포락선
+static float g_attackMs = PIPELINE_ATTACK_MS;
+static float g_releaseMs = PIPELINE_RELEASE_MS;
+static float g_peakHoldMs = PIPELINE_PEAK_HOLD_MS;
+static float g_peakGravity = PIPELINE_PEAK_GRAVITY;
+
+// 음색 특징 계산
+static int g_features = 0;
+
+// 이중 해상도 (저역 막대를 데시메이션 + 작은 FFT로)
+static int g_dualResolution = 0;
+
+// 화성 / 타악 분리
+static int g_hpss = 0;
+
+// 스펙트로그램 기록 (행 수 0 = 꺼짐)
+static int g_spectrogramRows = 0;
+static int g_spectrogramBars = SPECTRUM_BARS;
+
+// 출력 지연 보정 (음수 = 장치 스트림 지연)
+static float g_outputLatencyMs = -1.0f;
+static long long g_streamLatency = 0;      // IAudioClient::GetStreamLatency (100ns)
+
+// 타임스탬프 오류 패킷용 기준점 (캡처 스레드 전용, 마지막으로 정상이던 장치 위치와 QPC)
+static UINT64 g_lastDevicePosition = 0;
+static long long g_lastQpcPosition = 0;
+
+// 종단 간 지연 누적 (GetSpectrumFrameAt를 부르는 스레드가 누적, 100ns 단위)
+typedef struct {
+    unsigned long long reads;
+    unsigned long long lateReads;
+    unsigned long long earlyReads;
+    unsigned long long published;   // publishTime이 있던 읽기 수
+    long long captureToPublishSum, captureToPublishMax;
+    long long publishToReadSum, publishToReadMax;
+    long long displayAgeSum, displayAgeMin, displayAgeMax;
+    long long matchErrorSum;
+} LatencyAccumulator;
+
+static std::mutex g_latencyLock;
+static LatencyAccumulator g_latency;
+
+// 막대별 자동 게인
+static int g_autoGain = 1;
+static float g_autoGainWindowSec = PIPELINE_AUTO_GAIN_WINDOW_SEC;
+static int g_idleTimeoutMs = DEFAULT_IDLE_TIMEOUT;
+
+// 유휴 통계 (캡처/DSP 스레드가 누적)
+static std::atomic<unsigned long long> g_suspendCount(0);
+static std::atomic<unsigned long long> g_resumeCount(0);
+static std::atomic<unsigned long long> g_idleWakeups(0);
+static std::atomic<unsigned long long> g_idleCpuTime(0);   // 100ns 단위
+
+// DSP 단계 (캡처 스레드 = 생산자, DSP 스레드 = 소비자)
+static AudioPipeline g_pipeline;
+static int g_fftSize = DEFAULT_FFT_SIZE;
+static int g_hopSize = DEFAULT_HOP_SIZE;
+static int g_barCount = SPECTRUM_BARS;
+static int g_barScale = DEFAULT_BAR_SCALE;
+
+// 캡처 스레드 전용 모노 변환 버퍼
+static float g_monoChunk[MONO_CHUNK_SIZE];
+
+// 믹스 포맷 -> 모노 float 변환기 (Init에서 포맷별 함수 선택)
+static SampleConverter g_converter;
+
+static int InitConverter(const WAVEFORMATEX* wfx) {
+    int subFormat = 0;
+    unsigned int channelMask = 0;
+    if (wfx->wFormatTag == WAVE_FORMAT_EXTENSIBLE && wfx->cbSize >= 22) {
+        const WAVEFORMATEXTENSIBLE* ext = (const WAVEFORMATEXTENSIBLE*)wfx;
+        subFormat = (int)ext->SubFormat.Data1;  // KSDATAFORMAT_SUBTYPE_PCM = 1, IEEE_FLOAT = 3
+        channelMask = ext->dwChannelMask;
+    }
+
+    int format = SampleFormat_FromWave(wfx->wFormatTag, wfx->wBitsPerSample, subFormat);
+    if (!SampleConverter_Init(&g_converter, format, wfx->nChannels, channelMask)) return 0;
+    return g_converter.bytesPerFrame == wfx->nBlockAlign;
+}
+
+// 쌓인 패킷을 모두 꺼내서 링에 넣기 (캡처 스레드), 반환값 = 패킷이 있었는지
+static bool DrainPackets(void) {
+    UINT32 packetLength = 0;
+    HRESULT hr = g_pCaptureClient->GetNextPacketSize(&packetLength);
+    if (FAILED(hr)) return false;
+
+    int bytesPerFrame = g_pwfx->nBlockAlign;
+    int sampleRate = (int)g_pwfx->nSamplesPerSec;
+    bool wrote = false;
+
+    while (packetLength != 0) {
+        BYTE* pData;
+        UINT32 numFramesAvailable;
+        DWORD flags;
+        UINT64 devicePosition = 0;
+        UINT64 qpcPosition = 0;
+
+        hr = g_pCaptureClient->GetBuffer(&pData, &numFramesAvailable, &flags, &devicePosition, &qpcPosition);
+        if (FAILED(hr)) break;
+
+        // 무음 패킷도 0으로 넣어서 시간축 유지
+        bool silent = (flags & AUDCLNT_BUFFERFLAGS_SILENT) || !pData;
+
+        // 패킷 첫 샘플의 캡처 시각: QPC가 틀렸으면 마지막 정상 패킷에서 장치 위치 차이만큼 외삽
+        long long timestamp = 0;
+        if (!(flags & AUDCLNT_BUFFERFLAGS_TIMESTAMP_ERROR)) {
+            timestamp = (long long)qpcPosition;
+            g_lastDevicePosition = devicePosition;
+            g_lastQpcPosition = timestamp;
+        } else if (g_lastQpcPosition != 0 && devicePosition >= g_lastDevicePosition) {
+            timestamp = g_lastQpcPosition +
+                        (long long)(devicePosition - g_lastDevicePosition) * REFTIMES_PER_SEC / sampleRate;
         }
-        output[k] = sqrtf(real * real + imag * imag) / n;
-    }
-}
-
-// 주파수 대역별로 그룹화
-static void GroupIntoBars(float* fftData, int fftSize, SpectrumData* spectrum) {
-    int binsPerBar = (fftSize / 2) / SPECTRUM_BARS;
-    if (binsPerBar < 1) binsPerBar = 1;
-    
-    for (int i = 0; i < SPECTRUM_BARS; i++) {
-        float sum = 0.0f;
-        int start = i * binsPerBar;
-        int end = start + binsPerBar;
-        if (end > fftSize / 2) end = fftSize / 2;
-        
-        for (int j = start; j < end; j++) {
-            sum += fftData[j];
+
+        UINT32 done = 0;
+        while (done < numFramesAvailable) {
+            int frames = (int)(numFramesAvailable - done);
+            if (frames > MONO_CHUNK_SIZE) frames = MONO_CHUNK_SIZE;
+
+            long long chunkTime = timestamp ? timestamp + (long long)done * REFTIMES_PER_SEC / sampleRate : 0;
+
+            if (silent) {
+                AudioPipeline_Write(&g_pipeline, NULL, frames, chunkTime);
+            } else {
+                // 장치 포맷 -> 모노 float (Init에서 고른 변환기)
+                SampleConverter_Run(&g_converter, pData + (size_t)done * bytesPerFrame, g_monoChunk, frames);
+                AudioPipeline_Write(&g_pipeline, g_monoChunk, frames, chunkTime);
+            }
+            done += frames;
         }
-        
-        float avg = sum / binsPerBar;
-        
-        // 로그 스케일 적용 및 정규화 (원래 민감도)
-        float db = 20.0f * log10f(avg + 0.0001f);
-        float normalized = (db + 60.0f) / 60.0f;  // -60dB ~ 0dB -> 0.0 ~ 1.0
-        
-        if (normalized < 0.0f) normalized = 0.0f;
-        if (normalized > 1.0f) normalized = 1.0f;
-        
-        // 스무딩 (이전 값과 혼합)
-        spectrum->bars[i] = spectrum->bars[i] * 0.7f + normalized * 0.3f;
+        wrote = true;
+
+        hr = g_pCaptureClient->ReleaseBuffer(numFramesAvailable);
+        if (FAILED(hr)) break;
+
+        hr = g_pCaptureClient->GetNextPacketSize(&packetLength);
+        if (FAILED(hr)) break;
+    }
+
+    if (wrote) SetEvent(g_dspEvent);
+    return wrote;
+}
+
+// 이 스레드가 지금까지 쓴 CPU 시간 (100ns 단위)
+static unsigned long long ThreadCpuTime(void) {
+    FILETIME creation, exitTime, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exitTime, &kernel, &user)) return 0;
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return k.QuadPart + u.QuadPart;
+}
+
+// 처리할 오디오가 없는 상태 (정지, 일시정지, 게이트 닫힘)
+static bool IsIdle(void) {
+    return g_suspended.load() || g_paused.load() || AudioPipeline_IsGated(&g_pipeline);
+}
+
+// 스레드가 한 번 깨어날 때마다: 유휴 상태였으면 그동안 쓴 CPU 시간 누적
+static void AccountWakeup(unsigned long long* lastCpu, bool idle) {
+    unsigned long long cpu = ThreadCpuTime();
+    if (idle) {
+        g_idleWakeups.fetch_add(1, std::memory_order_relaxed);
+        g_idleCpuTime.fetch_add(cpu - *lastCpu, std::memory_order_relaxed);
+    }
+    *lastCpu = cpu;
+}
+
+// 정지 중 확인 간격: 일시정지면 재생 재개 신호만 기다림, 아니면 홉 하나 안에 소리를 잡도록
+static DWORD SuspendedPollInterval(void) {
+    if (g_paused.load() || !g_pMeter) return INFINITE;
+    DWORD ms = (DWORD)((long long)g_hopSize * 1000 / (int)g_pwfx->nSamplesPerSec);
+    return ms < 1 ? 1 : ms;
+}
+
+static void SuspendClient(void) {
+    if (FAILED(g_pAudioClient->Stop())) return;
+    g_suspended.store(1);
+    g_suspendCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+static bool ResumeClient(void) {
+    if (g_paused.load()) return false;
+
+    // 재생 중인데 조용해서 멈춘 경우: 장치에 소리가 날 때만
+    float peak = 0.0f;
+    if (!g_pMeter || FAILED(g_pMeter->GetPeakValue(&peak)) || peak < METER_WAKE_LEVEL) return false;
+
+    if (FAILED(g_pAudioClient->Start())) return false;
+    g_suspended.store(0);
+    g_resumeCount.fetch_add(1, std::memory_order_relaxed);
+    SetEvent(g_dspEvent);
+    return true;
+}
+
+// 캡처 스레드: WASAPI 이벤트마다 패킷 수거
+static DWORD WINAPI CaptureThread(LPVOID lpParam) {
+    (void)lpParam;
+    CoInitializeEx(NULL, COINIT_MULTITHREADED);
+
+    // MMCSS 등록 (오디오 스케줄링 우선순위)
+    DWORD taskIndex = 0;
+    HANDLE hTask = AvSetMmThreadCharacteristicsW(L"Audio", &taskIndex);
+
+    int sampleRate = (int)g_pwfx->nSamplesPerSec;
+    ULONGLONG lastPacket = GetTickCount64();   // 마지막으로 패킷 (또는 채운 무음)을 넣은 시각
+    ULONGLONG lastActive = lastPacket;         // 마지막으로 처리할 오디오가 있던 시각
+    unsigned long long lastCpu = ThreadCpuTime();
+
+    HANDLE handles[3] = { g_stopEvent, g_captureEvent, g_wakeEvent };
+    while (true) {
+        bool idle = IsIdle();
+        DWORD timeout = g_suspended.load() ? SuspendedPollInterval() : CAPTURE_WAIT_TIMEOUT;
+        DWORD waitResult = WaitForMultipleObjects(3, handles, FALSE, timeout);
+        if (waitResult == WAIT_OBJECT_0) break;  // 중지
+
+        ULONGLONG now = GetTickCount64();
+        if (g_suspended.load()) {
+            if (ResumeClient()) lastPacket = lastActive = now;
+        } else if (DrainPackets()) {
+            lastPacket = now;
+        } else if (now - lastPacket >= PACKET_IDLE_TIMEOUT) {
+            // 패킷이 끊기면 경과 시간만큼 무음을 넣어서 막대가 감쇠하고 게이트가 닫히게 함
+            int frames = (int)((now - lastPacket) * sampleRate / 1000);
+            AudioPipeline_Write(&g_pipeline, NULL, frames, 0);
+            SetEvent(g_dspEvent);
+            lastPacket = now;
+        }
+
+        if (!g_suspended.load()) {
+            if (!IsIdle()) {
+                lastActive = now;
+            } else if (g_idleTimeoutMs > 0 && now - lastActive >= (ULONGLONG)g_idleTimeoutMs &&
+                       (g_paused.load() || g_pMeter)) {
+                SuspendClient();
+            }
+        }
+        AccountWakeup(&lastCpu, idle);
     }
+
+    if (hTask) AvRevertMmThreadCharacteristics(hTask);
+    CoUninitialize();
+    return 0;
+}
+
+// 현재 QPC (100ns 단위, WASAPI 패킷 타임스탬프와 같은 축)
+static long long ClockTicks(void) {
+    LARGE_INTEGER now, freq;
+    QueryPerformanceCounter(&now);
+    QueryPerformanceFrequency(&freq);
+    return now.QuadPart / freq.QuadPart * REFTIMES_PER_SEC +
+           now.QuadPart % freq.QuadPart * REFTIMES_PER_SEC / freq.QuadPart;
+}
+
+// 캡처 -> 스피커 출력 지연 (100ns)
+static long long OutputLatencyTicks(void) {
+    if (g_outputLatencyMs >= 0.0f) return (long long)(g_outputLatencyMs * REFTIMES_PER_MILLISEC);
+    return g_streamLatency;
+}
+
+// DSP 스레드: 링에 쌓인 샘플로 스펙트럼 계산
+static DWORD WINAPI DspThread(LPVOID lpParam) {
+    (void)lpParam;
+
+    unsigned long long lastCpu = ThreadCpuTime();
+
+    HANDLE handles[2] = { g_stopEvent, g_dspEvent };
+    while (true) {
+        // 클라이언트가 정지하면 새 샘플이 올 때까지 깨어나지 않음
+        bool idle = IsIdle();
+        DWORD timeout = g_suspended.load() ? INFINITE : DSP_WAIT_TIMEOUT;
+        DWORD waitResult = WaitForMultipleObjects(2, handles, FALSE, timeout);
+        if (waitResult == WAIT_OBJECT_0) break;  // 중지
+        AudioPipeline_Process(&g_pipeline);
+        AccountWakeup(&lastCpu, idle);
+    }
+    return 0;
 }
 
 extern "C" {
 
 int AudioCapture_Init(void) {
     HRESULT hr;
-    
+
     hr = CoInitializeEx(NULL, COINIT_MULTITHREADED);
     if (FAILED(hr) && hr != RPC_E_CHANGED_MODE) {
         return 0;
     }
-    
+
     // 디바이스 열거자 생성
     hr = CoCreateInstance(
         __uuidof(MMDeviceEnumerator), NULL, CLSCTX_ALL,
         __uuidof(IMMDeviceEnumerator), (void**)&g_pEnumerator
     );
     if (FAILED(hr)) return 0;
-    
+
     // 기본 출력 디바이스 가져오기
     hr = g_pEnumerator->GetDefaultAudioEndpoint(eRender, eConsole, &g_pDevice);
     if (FAILED(hr)) return 0;
-    
+
     // 오디오 클라이언트 생성
     hr = g_pDevice->Activate(
         __uuidof(IAudioClient), CLSCTX_ALL, NULL, (void**)&g_pAudioClient
     );
     if (FAILED(hr)) return 0;
-    
+
     // 믹스 포맷 가져오기
     hr = g_pAudioClient->GetMixFormat(&g_pwfx);
     if (FAILED(hr)) return 0;
-    
-    // 루프백 모드로 초기화
+
+    // 샘플 포맷 확인 (PCM 8/16/24/32비트, float 32/64비트, 채널 마스크)
+    if (!InitConverter(g_pwfx)) return 0;
+
+    // 이벤트 생성
+    g_captureEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+    g_dspEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+    g_stopEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+    g_wakeEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (!g_captureEvent || !g_dspEvent || !g_stopEvent || !g_wakeEvent) return 0;
+
+    // 장치 피크 미터 (정지 중 소리 감지용, 없으면 조용할 때 정지하지 않음)
+    if (FAILED(g_pDevice->Activate(__uuidof(IAudioMeterInformation), CLSCTX_ALL, NULL,
+                                   (void**)&g_pMeter))) {
+        g_pMeter = NULL;
+    }
+
+    // 루프백 + 이벤트 구동 모드로 초기화 (지원 안 하면 폴링 모드)
     hr = g_pAudioClient->Initialize(
         AUDCLNT_SHAREMODE_SHARED,
-        AUDCLNT_STREAMFLAGS_LOOPBACK,
-        REFTIMES_PER_SEC,
+        AUDCLNT_STREAMFLAGS_LOOPBACK | AUDCLNT_STREAMFLAGS_EVENTCALLBACK,
+        CAPTURE_BUFFER_DURATION,
         0,
         g_pwfx,
         NULL
     );
-    if (FAILED(hr)) return 0;
-    
+    if (SUCCEEDED(hr)) {
+        hr = g_pAudioClient->SetEventHandle(g_captureEvent);
+        if (FAILED(hr)) return 0;
+    } else {
+        // 실패한 클라이언트는 다시 쓸 수 없으므로 새로 활성화
+        g_pAudioClient->Release();
+        g_pAudioClient = NULL;
+        hr = g_pDevice->Activate(
+            __uuidof(IAudioClient), CLSCTX_ALL, NULL, (void**)&g_pAudioClient
+        );
+        if (FAILED(hr)) return 0;
+
+        hr = g_pAudioClient->Initialize(
+            AUDCLNT_SHAREMODE_SHARED,
+            AUDCLNT_STREAMFLAGS_LOOPBACK,
+            REFTIMES_PER_SEC,
+            0,
+            g_pwfx,
+            NULL
+        );
+        if (FAILED(hr)) return 0;
+    }
+
     // 캡처 클라이언트 가져오기
     hr = g_pAudioClient->GetService(
         __uuidof(IAudioCaptureClient), (void**)&g_pCaptureClient
     );
     if (FAILED(hr)) return 0;
-    
+
+    // 자동 출력 지연 (모르면 0: 캡처 시각 그대로 맞춤)
+    REFERENCE_TIME streamLatency = 0;
+    if (FAILED(g_pAudioClient->GetStreamLatency(&streamLatency))) streamLatency = 0;
+    g_streamLatency = (long long)streamLatency;
+    g_lastDevicePosition = 0;
+    g_lastQpcPosition = 0;
+
+    // DSP 단계 준비 (링 = 약 1초 분량, 타임스탬프 = QPC 100ns 단위)
+    if (!AudioPipeline_Init(&g_pipeline, (int)g_pwfx->nSamplesPerSec, REFTIMES_PER_SEC,
+                            g_fftSize, g_hopSize, g_barCount, g_barScale,
+                            g_pwfx->nSamplesPerSec)) {
+        return 0;
+    }
+    g_pipelineReady = true;
+    AudioPipeline_SetClock(&g_pipeline, ClockTicks);
+    AudioPipeline_SetGate(&g_pipeline, g_gateDb);
+    AudioPipeline_SetEnvelope(&g_pipeline, g_attackMs, g_releaseMs, g_peakHoldMs, g_peakGravity);
+    AudioPipeline_SetAutoGain(&g_pipeline, g_autoGain, g_autoGainWindowSec);
+    AudioPipeline_EnableFeatures(&g_pipeline, g_features);
+    AudioPipeline_SetDualResolution(&g_pipeline, g_dualResolution);
+    AudioPipeline_EnableHpss(&g_pipeline, g_hpss);
+    AudioPipeline_SetSpectrogram(&g_pipeline, g_spectrogramRows, g_spectrogramBars);
+    AudioPipeline_SetPaused(&g_pipeline, g_paused.load());
+    g_suspended.store(0);
+
     // 캡처 시작
     hr = g_pAudioClient->Start();
     if (FAILED(hr)) return 0;
-    
-    // 버퍼 초기화
-    memset(g_sampleBuffer, 0, sizeof(g_sampleBuffer));
-    memset(g_fftOutput, 0, sizeof(g_fftOutput));
-    g_sampleIndex = 0;
-    
+
     g_initialized = true;
+
+    // 스레드 시작
+    g_dspThread = CreateThread(NULL, 0, DspThread, NULL, 0, NULL);
+    g_captureThread = CreateThread(NULL, 0, CaptureThread, NULL, 0, NULL);
+    if (!g_dspThread || !g_captureThread) {
+        AudioCapture_Cleanup();
+        return 0;
+    }
+
     return 1;
 }
 
 void AudioCapture_Cleanup(void) {
+    // 스레드 먼저 정지 (정지 이벤트는 수동 리셋이라 두 루프 모두 다음 대기에서 빠짐)
+    // 시간 제한을 두면 아직 돌고 있는 스레드가 아래에서 해제한 클라이언트/파이프라인을 쓸 수 있으므로 끝날 때까지 기다림
+    if (g_stopEvent) {
+        SetEvent(g_stopEvent);
+    }
+    if (g_captureThread) {
+        WaitForSingleObject(g_captureThread, INFINITE);
+        CloseHandle(g_captureThread);
+        g_captureThread = NULL;
+    }
+    if (g_dspThread) {
+        WaitForSingleObject(g_dspThread, INFINITE);
+        CloseHandle(g_dspThread);
+        g_dspThread = NULL;
+    }
+
     if (g_pAudioClient) {
         g_pAudioClient->Stop();
     }
-    
+
     if (g_pCaptureClient) {
         g_pCaptureClient->Release();
         g_pCaptureClient = NULL;
     }
+    if (g_pMeter) {
+        g_pMeter->Release();
+        g_pMeter = NULL;
+    }
     if (g_pAudioClient) {
         g_pAudioClient->Release();
         g_pAudioClient = NULL;
@@ -161,61 +511,450 @@ void AudioCapture_Cleanup(void) {
         CoTaskMemFree(g_pwfx);
         g_pwfx = NULL;
     }
-    
+
+    if (g_captureEvent) {
+        CloseHandle(g_captureEvent);
+        g_captureEvent = NULL;
+    }
+    if (g_dspEvent) {
+        CloseHandle(g_dspEvent);
+        g_dspEvent = NULL;
+    }
+    if (g_stopEvent) {
+        CloseHandle(g_stopEvent);
+        g_stopEvent = NULL;
+    }
+    if (g_wakeEvent) {
+        CloseHandle(g_wakeEvent);
+        g_wakeEvent = NULL;
+    }
+    g_suspended.store(0);
+
+    if (g_pipelineReady) {
+        AudioPipeline_Free(&g_pipeline);
+        g_pipelineReady = false;
+    }
     g_initialized = false;
 }
 
 int AudioCapture_GetSpectrum(SpectrumData* data) {
-    if (!data || !g_initialized || !g_pCaptureClient) {
-        return 0;
-    }
-    
-    UINT32 packetLength = 0;
-    HRESULT hr;
-    
-    hr = g_pCaptureClient->GetNextPacketSize(&packetLength);
-    if (FAILED(hr)) return 0;
-    
-    while (packetLength != 0) {
-        BYTE* pData;
-        UINT32 numFramesAvailable;
-        DWORD flags;
-        
-        hr = g_pCaptureClient->GetBuffer(&pData, &numFramesAvailable, &flags, NULL, NULL);
-        if (FAILED(hr)) break;
-        
-        // 샘플 데이터를 버퍼에 복사
-        if (!(flags & AUDCLNT_BUFFERFLAGS_SILENT) && pData) {
-            float* floatData = (float*)pData;
-            int channels = g_pwfx->nChannels;
-            
-            for (UINT32 i = 0; i < numFramesAvailable && g_sampleIndex < SAMPLE_BUFFER_SIZE; i++) {
-                // 스테레오를 모노로 변환
-                float sample = 0.0f;
-                for (int ch = 0; ch < channels; ch++) {
-                    sample += floatData[i * channels + ch];
-                }
-                sample /= channels;
-                
-                g_sampleBuffer[g_sampleIndex++] = sample;
+    if (!data) return 0;
+    return AudioCapture_GetSpectrumBars(data->bars, SPECTRUM_BARS);
+}
+
+// 막대 수 맞추기 (줄일 때는 인접 막대 평균 또는 최대값, 늘릴 때는 같은 값 반복)
+static void ResampleBars(const float* src, int srcCount, float* dst, int dstCount, bool useMax) {
+    if (srcCount == dstCount) {
+        memcpy(dst, src, sizeof(float) * dstCount);
+    } else if (srcCount > dstCount) {
+        for (int i = 0; i < dstCount; i++) {
+            int start = i * srcCount / dstCount;
+            int end = (i + 1) * srcCount / dstCount;
+            float sum = 0.0f, peak = 0.0f;
+            for (int j = start; j < end; j++) {
+                sum += src[j];
+                if (src[j] > peak) peak = src[j];
             }
+            dst[i] = useMax ? peak : sum / (end - start);
         }
-        
-        hr = g_pCaptureClient->ReleaseBuffer(numFramesAvailable);
-        if (FAILED(hr)) break;
-        
-        hr = g_pCaptureClient->GetNextPacketSize(&packetLength);
-        if (FAILED(hr)) break;
+    } else {
+        for (int i = 0; i < dstCount; i++) {
+            dst[i] = src[i * srcCount / dstCount];
+        }
+    }
+}
+
+int AudioCapture_GetSpectrumBars(float* bars, int barCount) {
+    if (!bars || barCount <= 0 || !g_initialized) {
+        return 0;
+    }
+
+    SpectrumFrame frame;
+    if (!AudioPipeline_ReadLatest(&g_pipeline, &frame)) {
+        return 0;
+    }
+
+    ResampleBars(frame.spectrum.bars, frame.barCount, bars, barCount, false);
+    return 1;
+}
+
+int AudioCapture_GetSpectrumPeaks(float* peaks, int barCount) {
+    if (!peaks || barCount <= 0 || !g_initialized) {
+        return 0;
+    }
+
+    SpectrumFrame frame;
+    if (!AudioPipeline_ReadLatest(&g_pipeline, &frame)) {
+        return 0;
+    }
+
+    ResampleBars(frame.peaks.bars, frame.barCount, peaks, barCount, true);
+    return 1;
+}
+
+void AudioCapture_SetDualResolution(int enable) {
+    g_dualResolution = enable ? 1 : 0;
+    if (g_initialized) AudioPipeline_SetDualResolution(&g_pipeline, g_dualResolution);
+}
+
+int AudioCapture_GetDualResolution(void) {
+    return g_dualResolution;
+}
+
+void AudioCapture_EnableFeatures(int enable) {
+    g_features = enable ? 1 : 0;
+    if (g_initialized) AudioPipeline_EnableFeatures(&g_pipeline, g_features);
+}
+
+void AudioCapture_EnableHpss(int enable) {
+    g_hpss = enable ? 1 : 0;
+    if (g_initialized) AudioPipeline_EnableHpss(&g_pipeline, g_hpss);
+}
+
+int AudioCapture_GetSpectrumEx(SpectrumDataEx* data) {
+    if (!data || !g_initialized) {
+        return 0;
     }
-    
-    // 버퍼가 가득 찼으면 FFT 수행
-    if (g_sampleIndex >= SAMPLE_BUFFER_SIZE) {
-        SimpleDFT(g_sampleBuffer, g_fftOutput, SAMPLE_BUFFER_SIZE);
-        GroupIntoBars(g_fftOutput, SAMPLE_BUFFER_SIZE, data);
-        g_sampleIndex = 0;
+
+    SpectrumFrame frame;
+    if (!AudioPipeline_ReadLatest(&g_pipeline, &frame) || !frame.hasFeatures) {
+        return 0;
     }
-    
+
+    ResampleBars(frame.spectrum.bars, frame.barCount, data->bars, SPECTRUM_BARS, false);
+    data->features = frame.features;
     return 1;
 }
 
+int AudioCapture_Subscribe(const SpectrumSubscription* config) {
+    if (!config || !g_initialized) {
+        return 0;
+    }
+    return AudioPipeline_Subscribe(&g_pipeline, config);
+}
+
+void AudioCapture_Unsubscribe(int handle) {
+    if (g_initialized) AudioPipeline_Unsubscribe(&g_pipeline, handle);
+}
+
+int AudioCapture_ReadSubscription(int handle, SpectrumFrame* frame) {
+    if (!frame || !g_initialized) {
+        return 0;
+    }
+    return AudioPipeline_ReadSubscription(&g_pipeline, handle, frame);
+}
+
+int AudioCapture_SetSpectrogram(int rows, int barCount) {
+    if (rows < 0 || rows > SPECTROGRAM_MAX_ROWS) return 0;
+    if (rows > 0 && (barCount < 1 || barCount > SPECTRUM_MAX_BARS)) return 0;
+
+    // DSP 스레드가 다음 처리 때 적용 (메모리는 처음 켤 때 한 번만 할당)
+    g_spectrogramRows = rows;
+    if (rows > 0) g_spectrogramBars = barCount;
+    if (g_initialized) AudioPipeline_SetSpectrogram(&g_pipeline, g_spectrogramRows, g_spectrogramBars);
+    return 1;
+}
+
+int AudioCapture_GetSpectrogram(int maxRows, SpectrogramView* view) {
+    if (!view || !g_initialized) {
+        return 0;
+    }
+    return Spectrogram_Read(&g_pipeline.spectrogram, maxRows, view);
+}
+
+int AudioCapture_SpectrogramValid(const SpectrogramView* view) {
+    if (!view || !g_initialized) {
+        return 0;
+    }
+    return Spectrogram_Validate(&g_pipeline.spectrogram, view);
+}
+
+int AudioCapture_SetEnvelope(float attackMs, float releaseMs, float peakHoldMs, float peakGravity) {
+    if (attackMs < 0.0f || releaseMs < 0.0f || peakHoldMs < 0.0f || peakGravity < 0.0f) return 0;
+
+    g_attackMs = attackMs;
+    g_releaseMs = releaseMs;
+    g_peakHoldMs = peakHoldMs;
+    g_peakGravity = peakGravity;
+    if (g_initialized) {
+        AudioPipeline_SetEnvelope(&g_pipeline, g_attackMs, g_releaseMs, g_peakHoldMs, g_peakGravity);
+    }
+    return 1;
+}
+
+void AudioCapture_GetEnvelope(float* attackMs, float* releaseMs, float* peakHoldMs, float* peakGravity) {
+    if (attackMs) *attackMs = g_attackMs;
+    if (releaseMs) *releaseMs = g_releaseMs;
+    if (peakHoldMs) *peakHoldMs = g_peakHoldMs;
+    if (peakGravity) *peakGravity = g_peakGravity;
+}
+
+int AudioCapture_GetSpectrumFrame(SpectrumFrame* frame) {
+    if (!frame || !g_initialized) {
+        return 0;
+    }
+    return AudioPipeline_ReadLatest(&g_pipeline, frame);
+}
+
+long long AudioCapture_GetTime(void) {
+    return ClockTicks();
+}
+
+// 읽을 때마다 지연 누적
+static void AccountLatency(const SpectrumFrame* frame, long long displayTime, long long target, long long now) {
+    if (frame->timestamp == 0) return;
+
+    long long hopTicks = (long long)g_hopSize * REFTIMES_PER_SEC / (int)g_pwfx->nSamplesPerSec;
+    long long age = displayTime - frame->timestamp;
+    long long error = target - frame->timestamp;
+
+    std::lock_guard<std::mutex> lock(g_latencyLock);
+    LatencyAccumulator* a = &g_latency;
+    if (a->reads == 0 || age < a->displayAgeMin) a->displayAgeMin = age;
+    if (a->reads == 0 || age > a->displayAgeMax) a->displayAgeMax = age;
+    a->reads++;
+    a->displayAgeSum += age;
+    a->matchErrorSum += error >= 0 ? error : -error;
+    if (error < 0) a->earlyReads++;             // 링에 남은 프레임이 모두 목표보다 나중
+    else if (error > hopTicks) a->lateReads++;  // 다음 프레임이 이미 나왔어야 함
+
+    if (frame->publishTime != 0) {
+        long long captureToPublish = frame->publishTime - frame->timestamp;
+        long long publishToRead = now - frame->publishTime;
+        a->published++;
+        a->captureToPublishSum += captureToPublish;
+        a->publishToReadSum += publishToRead;
+        if (captureToPublish > a->captureToPublishMax) a->captureToPublishMax = captureToPublish;
+        if (publishToRead > a->publishToReadMax) a->publishToReadMax = publishToRead;
+    }
+}
+
+int AudioCapture_GetSpectrumFrameAt(long long displayTime, SpectrumFrame* frame) {
+    if (!frame || !g_initialized) {
+        return 0;
+    }
+
+    long long target = displayTime - OutputLatencyTicks();
+    if (!AudioPipeline_ReadAt(&g_pipeline, target, frame)) {
+        return 0;
+    }
+
+    AccountLatency(frame, displayTime, target, ClockTicks());
+    return 1;
+}
+
+void AudioCapture_SetOutputLatency(float latencyMs) {
+    g_outputLatencyMs = latencyMs >= 0.0f ? latencyMs : -1.0f;
+}
+
+float AudioCapture_GetOutputLatency(void) {
+    return g_outputLatencyMs;
+}
+
+int AudioCapture_GetLatencyStats(AudioLatencyStats* stats) {
+    if (!stats) return 0;
+
+    const double toMs = 1.0 / REFTIMES_PER_MILLISEC;
+    memset(stats, 0, sizeof(AudioLatencyStats));
+    stats->outputLatencyMs = OutputLatencyTicks() * toMs;
+
+    std::lock_guard<std::mutex> lock(g_latencyLock);
+    const LatencyAccumulator* a = &g_latency;
+    stats->reads = a->reads;
+    stats->lateReads = a->lateReads;
+    stats->earlyReads = a->earlyReads;
+    if (a->reads > 0) {
+        stats->displayAgeAvgMs = (double)a->displayAgeSum / a->reads * toMs;
+        stats->displayAgeMinMs = a->displayAgeMin * toMs;
+        stats->displayAgeMaxMs = a->displayAgeMax * toMs;
+        stats->matchErrorAvgMs = (double)a->matchErrorSum / a->reads * toMs;
+    }
+    if (a->published > 0) {
+        stats->captureToPublishAvgMs = (double)a->captureToPublishSum / a->published * toMs;
+        stats->captureToPublishMaxMs = a->captureToPublishMax * toMs;
+        stats->publishToReadAvgMs = (double)a->publishToReadSum / a->published * toMs;
+        stats->publishToReadMaxMs = a->publishToReadMax * toMs;
+    }
+    return 1;
+}
+
+void AudioCapture_ResetLatencyStats(void) {
+    std::lock_guard<std::mutex> lock(g_latencyLock);
+    memset(&g_latency, 0, sizeof(g_latency));
+}
+
+int AudioCapture_SetFFTSize(int size) {
+    if (!FFT_IsValidSize(size)) return 0;
+
+    // DSP 스레드가 다음 처리 때 적용 (크기가 바뀌면 모으던 샘플은 버림)
+    g_fftSize = size;
+    if (g_initialized) AudioPipeline_RequestConfig(&g_pipeline, g_fftSize, g_hopSize);
+    return 1;
+}
+
+int AudioCapture_GetFFTSize(void) {
+    return g_fftSize;
+}
+
+int AudioCapture_SetHopSize(int hopSize) {
+    if (hopSize < 1 || hopSize > FFT_MAX_SIZE) return 0;
+
+    g_hopSize = hopSize;
+    if (g_initialized) AudioPipeline_RequestConfig(&g_pipeline, g_fftSize, g_hopSize);
+    return 1;
+}
+
+int AudioCapture_GetHopSize(void) {
+    return g_hopSize;
+}
+
+int AudioCapture_SetBarLayout(int barCount, int scale) {
+    if (barCount != 16 && barCount != 32 && barCount != 64 && barCount != 128) return 0;
+    if (scale < BAR_SCALE_LINEAR || scale > BAR_SCALE_CQT) return 0;
+
+    // DSP 스레드가 다음 처리 때 가중치 테이블을 다시 계산
+    g_barCount = barCount;
+    g_barScale = scale;
+    if (g_initialized) AudioPipeline_RequestBarLayout(&g_pipeline, g_barCount, g_barScale);
+    return 1;
+}
+
+int AudioCapture_SetAutoGain(int enabled, float windowSec) {
+    if (!(windowSec > 0.0f)) return 0;
+    // 너무 짧으면 분포가 쌓이지 않고 (막대가 잡음까지 전체 범위로), 너무 길면 곡이 바뀌어도 따라가지 못함
+    if (windowSec < AUDIO_AUTO_GAIN_MIN_WINDOW_SEC) windowSec = AUDIO_AUTO_GAIN_MIN_WINDOW_SEC;
+    if (windowSec > AUDIO_AUTO_GAIN_MAX_WINDOW_SEC) windowSec = AUDIO_AUTO_GAIN_MAX_WINDOW_SEC;
+
+    g_autoGain = enabled ? 1 : 0;
+    g_autoGainWindowSec = windowSec;
+    if (g_initialized) AudioPipeline_SetAutoGain(&g_pipeline, g_autoGain, g_autoGainWindowSec);
+    return 1;
+}
+
+int AudioCapture_GetAutoGain(float* windowSec) {
+    if (windowSec) *windowSec = g_autoGainWindowSec;
+    return g_autoGain;
+}
+
+void AudioCapture_SetPlaying(int playing) {
+    int paused = playing ? 0 : 1;
+    if (g_paused.exchange(paused) == paused) return;
+
+    if (g_initialized) {
+        AudioPipeline_SetPaused(&g_pipeline, paused);
+        if (!paused && g_wakeEvent) SetEvent(g_wakeEvent);
+    }
+}
+
+int AudioCapture_SetGateThreshold(float thresholdDb) {
+    if (thresholdDb > 0.0f) return 0;
+
+    g_gateDb = thresholdDb;
+    if (g_initialized) AudioPipeline_SetGate(&g_pipeline, g_gateDb);
+    return 1;
+}
+
+float AudioCapture_GetGateThreshold(void) {
+    return g_gateDb;
+}
+
+int AudioCapture_SetIdleTimeout(int timeoutMs) {
+    if (timeoutMs < 0) return 0;
+
+    // 캡처 스레드가 다음에 깨어날 때 적용
+    g_idleTimeoutMs = timeoutMs;
+    return 1;
+}
+
+int AudioCapture_GetIdleTimeout(void) {
+    return g_idleTimeoutMs;
+}
+
+int AudioCapture_GetIdleStats(AudioIdleStats* stats) {
+    if (!stats) return 0;
+
+    memset(stats, 0, sizeof(AudioIdleStats));
+    stats->suspended = g_suspended.load();
+    stats->suspends = g_suspendCount.load();
+    stats->resumes = g_resumeCount.load();
+    stats->idleWakeups = g_idleWakeups.load();
+    stats->idleCpuMs = g_idleCpuTime.load() / (double)REFTIMES_PER_MILLISEC;
+    if (g_pipelineReady) {
+        stats->gatedFrames = g_pipeline.gatedFrames.load();
+        stats->gateOpenings = g_pipeline.gateOpenings.load();
+    }
+    return 1;
+}
+
+// 지금 스피커에서 나오는 소리에 맞는 프레임과 그 소리의 캡처 시각
+static int ReadHeardFrame(SpectrumFrame* frame, long long* heardTime) {
+    *heardTime = ClockTicks() - OutputLatencyTicks();
+    return AudioPipeline_ReadAt(&g_pipeline, *heardTime, frame);
+}
+
+// 프레임 이후 흐른 박자 수 (UI가 프레임 사이에 읽어도 끊기지 않게)
+static double BeatsSinceFrame(const SpectrumFrame* frame, long long heardTime) {
+    if (frame->timestamp == 0 || frame->beat.bpm <= 0.0f) return 0.0;
+
+    long long elapsed = heardTime - frame->timestamp;
+    if (elapsed <= 0 || elapsed >= REFTIMES_PER_SEC / 2) return 0.0;
+    return (double)elapsed / REFTIMES_PER_SEC * frame->beat.bpm / 60.0;
+}
+
+int AudioCapture_GetBeatState(float* phase, float* bpm, float* confidence) {
+    if (!g_initialized) return 0;
+
+    SpectrumFrame frame;
+    long long heardTime;
+    if (!ReadHeardFrame(&frame, &heardTime)) {
+        return 0;
+    }
+
+    double beatPhase = frame.beat.phase + BeatsSinceFrame(&frame, heardTime);
+    beatPhase -= floor(beatPhase);
+
+    if (phase) *phase = (float)beatPhase;
+    if (bpm) *bpm = frame.beat.bpm;
+    if (confidence) *confidence = frame.beat.confidence;
+    return 1;
+}
+
+int AudioCapture_GetBeatPosition(double* beats, float* bpm) {
+    if (!g_initialized) return 0;
+
+    SpectrumFrame frame;
+    long long heardTime;
+    if (!ReadHeardFrame(&frame, &heardTime)) {
+        return 0;
+    }
+
+    if (beats) *beats = (double)frame.beat.beatCount + frame.beat.phase + BeatsSinceFrame(&frame, heardTime);
+    if (bpm) *bpm = frame.beat.bpm;
+    return 1;
+}
+
+int AudioCapture_GetHpssEnergy(float* harmonic, float* percussive) {
+    if (!g_initialized) {
+        return 0;
+    }
+
+    SpectrumFrame frame;
+    long long heardTime;
+    if (!ReadHeardFrame(&frame, &heardTime) || !frame.hasHpss) {
+        return 0;
+    }
+
+    if (harmonic) *harmonic = frame.harmonic;
+    if (percussive) *percussive = frame.percussive;
+    return 1;
+}
+
+int AudioCapture_GetBarCount(void) {
+    return g_barCount;
+}
+
+int AudioCapture_GetBarScale(void) {
+    return g_barScale;
+}
+
 } // extern "C"
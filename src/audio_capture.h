@@ -5,26 +5,226 @@
 #ifndef AUDIO_CAPTURE_H
 #define AUDIO_CAPTURE_H
 
+#include "bar_mapper.h"
+#include "beat_tracker.h"
+#include "spectral_features.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-#define SPECTRUM_BARS 16
+#define SPECTRUM_BARS 16        // 기본 막대 수 (SpectrumData)
+#define SPECTRUM_MAX_BARS 128
+
+// 막대 수별 스펙트럼 데이터 (16 / 32 / 64 / 128, 값은 0.0 ~ 1.0 범위)
+#define SPECTRUM_DATA_DECLARE(n) typedef struct { float bars[n]; } SpectrumData##n
+SPECTRUM_DATA_DECLARE(16);
+SPECTRUM_DATA_DECLARE(32);
+SPECTRUM_DATA_DECLARE(64);
+SPECTRUM_DATA_DECLARE(128);
+
+typedef SpectrumData16 SpectrumData;
 
-// 스펙트럼 데이터
+// SpectrumData + 음색 특징
 typedef struct {
-    float bars[SPECTRUM_BARS];  // 0.0 ~ 1.0 범위
-} SpectrumData;
+    float bars[SPECTRUM_BARS];
+    SpectralFeatures features;
+} SpectrumDataEx;
+
+// 타임스탬프가 붙은 스펙트럼 프레임
+typedef struct {
+    SpectrumData128 spectrum;           // 앞의 barCount개만 유효
+    SpectrumData128 peaks;              // 피크 유지 표시 (막대 위에서 천천히 떨어짐)
+    int barCount;
+    int barScale;                       // BarScale
+    BeatState beat;                     // 이 프레임 시점의 박자 상태
+    SpectralFeatures features;          // 음색 특징 (hasFeatures일 때만, 무음이면 0)
+    int hasFeatures;
+    float harmonic;                     // 화성 / 타악 성분 에너지 (hasHpss일 때만, 0.0 ~ 1.0)
+    float percussive;
+    int hasHpss;
+    unsigned long long sequence;        // 프레임 번호 (1부터 증가)
+    unsigned long long samplePosition;  // 분석 윈도우 마지막 샘플의 스트림 위치
+    long long timestamp;                // 그 샘플의 캡처 시각 (QPC, 100ns 단위, 0 = 알 수 없음)
+    long long publishTime;              // DSP가 프레임을 발행한 시각 (같은 단위)
+} SpectrumFrame;
+
+// 스펙트로그램 (워터폴) 읽기 결과: 오래된 행 -> 최신 행, 행마다 barCount개 float가 연속
+// 링이 감긴 경우 first 다음에 second를 이어서 그림 (감기지 않았으면 secondRows = 0)
+#define SPECTROGRAM_MAX_ROWS 512        // 홉 512 / 48kHz에서 약 5.5초
+typedef struct {
+    const float* first;
+    int firstRows;
+    const float* second;
+    int secondRows;
+    int barCount;
+    unsigned long long start;           // 첫 행 번호 (유효성 확인용)
+    unsigned int generation;
+} SpectrogramView;
+
+// 스펙트럼 구독 설정 (막대 UI, 박자 동기화, 내보내기 등이 각자 필요한 해상도로)
+typedef struct {
+    int barCount;                       // 1 ~ SPECTRUM_MAX_BARS
+    int barScale;                       // BarScale
+    float attackMs;                     // 막대 포락선 시상수 (0 = 스무딩 없음)
+    float releaseMs;
+    float rate;                         // 최대 갱신 빈도 (프레임/초, 0 = 홉마다)
+} SpectrumSubscription;
 
 // 초기화 / 정리
 int AudioCapture_Init(void);
 void AudioCapture_Cleanup(void);
 
-// 스펙트럼 데이터 가져오기
+// 최신 스펙트럼 가져오기 (캡처/DSP는 별도 스레드, 락 없이 읽음)
 int AudioCapture_GetSpectrum(SpectrumData* data);
+int AudioCapture_GetSpectrumFrame(SpectrumFrame* frame);
+
+// 현재 시각 (QPC, 100ns 단위, SpectrumFrame.timestamp와 같은 축)
+long long AudioCapture_GetTime(void);
+
+// 화면 시각에 맞는 프레임 (displayTime = 화면에 나타날 시각, AudioCapture_GetTime 축)
+// 그 시각에 스피커에서 나오는 소리 = displayTime - 출력 지연에 캡처된 샘플, 그 이전의 가장 최근 프레임
+// 최근 약 340ms 안에서 고르고, 아직 없는 미래면 최신 프레임 (지연 통계의 lateReads)
+int AudioCapture_GetSpectrumFrameAt(long long displayTime, SpectrumFrame* frame);
+
+// 캡처 -> 스피커 출력 지연 (ms, 음수 = 자동: 장치 스트림 지연, 기본 자동)
+// 화면 시각 매칭과 박자 외삽에 사용
+void AudioCapture_SetOutputLatency(float latencyMs);
+float AudioCapture_GetOutputLatency(void);
+
+// 종단 간 지연 통계 (GetSpectrumFrameAt 호출마다 누적, ms)
+typedef struct {
+    unsigned long long reads;           // 타임스탬프가 있는 프레임을 준 GetSpectrumFrameAt 호출 수
+    unsigned long long lateReads;       // 맞는 프레임이 아직 없어 최신 프레임을 준 횟수 (DSP가 늦음)
+    unsigned long long earlyReads;      // 맞는 프레임이 이미 링에서 밀려나 가장 오래된 프레임을 준 횟수
+    double outputLatencyMs;             // 지금 쓰는 출력 지연 (자동이면 장치 값)
+    double captureToPublishAvgMs;       // 캡처 -> 프레임 발행 (버퍼링 + STFT 윈도우 + DSP)
+    double captureToPublishMaxMs;
+    double publishToReadAvgMs;          // 프레임 발행 -> UI가 읽음
+    double publishToReadMaxMs;
+    double displayAgeAvgMs;             // 화면 시각 - 보여준 프레임의 캡처 시각 (종단 간 지연)
+    double displayAgeMinMs;
+    double displayAgeMaxMs;
+    double matchErrorAvgMs;             // |보여준 프레임 - 목표 시각| (0에 가까울수록 정확히 맞춤)
+} AudioLatencyStats;
+
+int AudioCapture_GetLatencyStats(AudioLatencyStats* stats);
+void AudioCapture_ResetLatencyStats(void);
+
+// 구독 (Init 이후, Cleanup하면 모두 해지됨): 반환값 = 핸들 (0 = 실패)
+// 구독자마다 자기 막대 테이블 / 포락선 / 자동 게인 / 출력 슬롯, FFT는 모두가 하나를 공유
+// rate가 낮으면 그만큼 드물게 계산 (포락선은 경과 시간 기준이라 같은 움직임)
+int AudioCapture_Subscribe(const SpectrumSubscription* config);
+void AudioCapture_Unsubscribe(int handle);
+
+// 구독한 설정으로 계산된 최신 프레임 (sequence로 새 프레임인지 확인, 아직 없으면 0)
+// -1 = 구독 준비 / FFT 크기 변경 때 막대 테이블을 못 만들어 멈춤 (Unsubscribe 후 다시 Subscribe)
+int AudioCapture_ReadSubscription(int handle, SpectrumFrame* frame);
+
+// 원하는 막대 수로 가져오기 (설정된 막대 수와 다르면 합치거나 나눠서 맞춤)
+int AudioCapture_GetSpectrumBars(float* bars, int barCount);
+
+// 피크 유지 표시 (합칠 때는 최대값)
+int AudioCapture_GetSpectrumPeaks(float* peaks, int barCount);
+
+// 막대 포락선: attack / release 시상수 (ms), 피크 유지 시간 (ms), 피크 낙하 가속도 (막대 높이 / 초^2)
+// 프레임 간격이 아니라 경과 시간 기준이라 홉 크기나 화면 갱신 주기가 바뀌어도 같은 움직임
+int AudioCapture_SetEnvelope(float attackMs, float releaseMs, float peakHoldMs, float peakGravity);
+void AudioCapture_GetEnvelope(float* attackMs, float* releaseMs, float* peakHoldMs, float* peakGravity);
+
+// 막대 수 (16 / 32 / 64 / 128)와 주파수 축 (BarScale, 기본 BAR_SCALE_OCTAVE) 설정
+int AudioCapture_SetBarLayout(int barCount, int scale);
+int AudioCapture_GetBarCount(void);
+int AudioCapture_GetBarScale(void);
+
+// 박자 상태 (phase = 0.0 ~ 1.0, 마지막 프레임 이후 경과 시간만큼 외삽, bpm = 0이면 아직 모름)
+int AudioCapture_GetBeatState(float* phase, float* bpm, float* confidence);
+
+// 누적 박자 위치 (지나간 박자 수 + 위상, 같은 방식으로 외삽)
+int AudioCapture_GetBeatPosition(double* beats, float* bpm);
+
+// 이중 해상도 (기본 꺼짐): 300Hz 아래 막대를 데시메이션한 6 ~ 12kHz 스트림의 작은 FFT에서 계산
+// 저역 해상도가 FFT 크기와 무관해지므로 FFT 크기를 1024로 줄여 고역 반응을 빠르게 할 수 있음
+void AudioCapture_SetDualResolution(int enable);
+int AudioCapture_GetDualResolution(void);
+
+// 음색 특징 계산 켜기 / 끄기 (기본 꺼짐, 켜면 FFT 프레임마다 크기 스펙트럼을 한 번 더 순회)
+void AudioCapture_EnableFeatures(int enable);
+
+// 화성 / 타악 분리 켜기 / 끄기 (기본 꺼짐): 빈마다 시간 / 주파수 방향 슬라이딩 중앙값으로 스펙트럼을 나눔
+// 켜면 박자 추적이 타악 성분만 보고, 성분별 에너지 포락선을 읽을 수 있음
+void AudioCapture_EnableHpss(int enable);
+
+// 들리는 시점의 화성 / 타악 에너지 (0.0 ~ 1.0, 분리가 꺼져 있거나 아직 프레임이 없으면 0)
+int AudioCapture_GetHpssEnergy(float* harmonic, float* percussive);
+
+// 막대 + 음색 특징 (특징 계산이 꺼져 있거나 아직 프레임이 없으면 0)
+int AudioCapture_GetSpectrumEx(SpectrumDataEx* data);
+
+// 스펙트로그램 기록 (기본 꺼짐): 최근 rows개 프레임 (최대 SPECTROGRAM_MAX_ROWS), 행마다 barCount개 막대
+// (1 ~ SPECTRUM_MAX_BARS, 설정된 막대 수와 다르면 합치거나 나눔), rows = 0이면 끔, 바꾸면 기록은 처음부터
+int AudioCapture_SetSpectrogram(int rows, int barCount);
+
+// 복사 없이 읽기 (최근 maxRows개, 0 이하 = 전부): 링 안을 가리키는 두 구간, 반환값 = 행 수
+// 구간은 DSP 스레드가 계속 쓰는 메모리: 다 그린 뒤 AudioCapture_SpectrogramValid가 0이면 그 프레임은 버림
+int AudioCapture_GetSpectrogram(int maxRows, SpectrogramView* view);
+int AudioCapture_SpectrogramValid(const SpectrogramView* view);
+
+// 막대별 자동 게인 (기본 켜짐): 최근 windowSec초 동안 각 막대의 하위 10% / 상위 3% 레벨을
+// 막대 바닥 / 꼭대기로 사용, 끄면 고정 -60 ~ 0dB (windowSec은 아래 범위로 맞춤, 0 이하면 실패)
+#define AUDIO_AUTO_GAIN_MIN_WINDOW_SEC 1.0f
+#define AUDIO_AUTO_GAIN_MAX_WINDOW_SEC 30.0f
+int AudioCapture_SetAutoGain(int enabled, float windowSec);
+int AudioCapture_GetAutoGain(float* windowSec);
+
+// 재생 상태 (SMTC): 일시정지 중에는 FFT를 건너뛰고 막대만 감쇠
+void AudioCapture_SetPlaying(int playing);
+
+// 무음 게이트 임계값 (dBFS, 분석 윈도우 RMS, 기본 -70, -200 이하면 끔)
+int AudioCapture_SetGateThreshold(float thresholdDb);
+float AudioCapture_GetGateThreshold(void);
+
+// 조용하거나 일시정지된 상태가 이만큼 이어지면 WASAPI 클라이언트 정지 (ms, 0 = 정지 안 함, 기본 5000)
+// 정지 중에는 재생 재개 / 장치 피크 미터를 홉 간격으로 확인해서 다시 시작
+int AudioCapture_SetIdleTimeout(int timeoutMs);
+int AudioCapture_GetIdleTimeout(void);
+
+// 유휴 상태 통계
+typedef struct {
+    int suspended;                      // WASAPI 클라이언트가 정지 상태인지
+    unsigned long long gatedFrames;     // FFT를 건너뛴 스펙트럼 프레임 수
+    unsigned long long gateOpenings;    // 조용한 구간이 끝나 다시 분석을 시작한 횟수
+    unsigned long long suspends;        // 클라이언트 정지 횟수
+    unsigned long long resumes;         // 클라이언트 재개 횟수
+    unsigned long long idleWakeups;     // 유휴 상태에서 캡처/DSP 스레드가 깨어난 횟수
+    double idleCpuMs;                   // 유휴 상태에서 캡처/DSP 스레드가 쓴 CPU 시간
+} AudioIdleStats;
+
+int AudioCapture_GetIdleStats(AudioIdleStats* stats);
+
+// FFT 크기 설정/가져오기 (512 ~ 8192, 2의 거듭제곱, 기본 2048)
+int AudioCapture_SetFFTSize(int size);
+int AudioCapture_GetFFTSize(void);
+
+// 홉 크기 설정/가져오기 (새 스펙트럼 간격, 샘플 단위, 기본 512 = 48kHz에서 약 94Hz)
+// FFT 크기보다 크면 FFT 크기로 제한됨
+int AudioCapture_SetHopSize(int hopSize);
+int AudioCapture_GetHopSize(void);
 
 #ifdef __cplusplus
 }
+
+// 막대 수 -> SpectrumData 타입 (허용된 막대 수만 특수화)
+template <int Bars> struct SpectrumDataFor;
+template <> struct SpectrumDataFor<16>  { typedef SpectrumData16 Type; };
+template <> struct SpectrumDataFor<32>  { typedef SpectrumData32 Type; };
+template <> struct SpectrumDataFor<64>  { typedef SpectrumData64 Type; };
+template <> struct SpectrumDataFor<128> { typedef SpectrumData128 Type; };
+
+template <int Bars>
+inline int AudioCapture_GetSpectrumT(typename SpectrumDataFor<Bars>::Type* data) {
+    return AudioCapture_GetSpectrumBars(data->bars, Bars);
+}
 #endif
 
 #endif // AUDIO_CAPTURE_H
@@ -0,0 +1,996 @@
+/*
+ * audio_pipeline.cpp - Audio DSP Stage
+ * SPSC 링에서 샘플을 꺼내 STFT -> FFT -> 막대 그룹화 후 최근 프레임 링으로 발행
+ */
+
+#include "audio_pipeline.h"
+#include "dsp_kernels.h"
+#include "beat_tracker.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+
+#define ANCHOR_RING_SIZE 256
+#define READ_RETRY_COUNT 4
+
+// consumerState 한 칸 = 상태 (아래 8비트) | 세대 (나머지, 부호 비트 제외)
+#define CONSUMER_STATE_MASK 0xFF
+#define CONSUMER_GENERATION_MASK 0x7FFFFF00
+#define CONSUMER_STATE(word) ((word) & CONSUMER_STATE_MASK)
+#define CONSUMER_WORD(word, state) (((word) & CONSUMER_GENERATION_MASK) | (state))
+
+// 프로파일링용 시각 (ns)
+static inline double NowNs(void) {
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static float TimeConstantCoefficient(float dt, float ms) {
+    return ms > 0.0f ? 1.0f - expf(-dt * 1000.0f / ms) : 1.0f;
+}
+
+static void ComputeEnvelope(AudioPipeline* p, EnvelopeCoefficients* env) {
+    env->dt = (float)p->hopSize / p->sampleRate;
+    env->attack = TimeConstantCoefficient(env->dt, p->attackMs.load(std::memory_order_relaxed));
+    env->release = TimeConstantCoefficient(env->dt, p->releaseMs.load(std::memory_order_relaxed));
+    env->holdTime = p->peakHoldMs.load(std::memory_order_relaxed) / 1000.0f;
+    env->gravity = p->peakGravity.load(std::memory_order_relaxed);
+}
+
+// target -> bars (attack / release) -> peaks (유지 + 중력 낙하), 막대 전체를 SIMD로
+static void RunEnvelope(float* bars, const float* target, float* peaks, float* peakHold,
+                        float* peakVelocity, int count, const EnvelopeCoefficients* env) {
+    const DspKernels* k = DspKernels_Get();
+    k->envelope(bars, target, count, env->attack, env->release);
+    k->peakHold(peaks, peakHold, peakVelocity, bars, count, env->dt, env->holdTime, env->gravity);
+}
+
+static void UpdateEnvelope(AudioPipeline* p, const EnvelopeCoefficients* env) {
+    RunEnvelope(p->bars, p->target, p->peaks, p->peakHold, p->peakVelocity, p->barCount, env);
+}
+
+// 막대 크기 -> dB -> 0.0 ~ 1.0 (자동 게인이면 막대별 분위수, 아니면 고정 범위)
+static void NormalizeBars(AudioPipeline* p, const float* bands, float* target, int count, AutoGain* gain) {
+    float db[SPECTRUM_MAX_BARS];
+
+    // 로그 스케일 적용 (SIMD 커널)
+    DspKernels_Get()->toDecibels(bands, db, count, 0.0001f);
+
+    if (p->autoGain.load(std::memory_order_relaxed)) {
+        // 막대별 최근 분포의 하위 / 상위 분위수 -> 0.0 / 1.0
+        AutoGain_Process(gain, db, target, PIPELINE_FIXED_MIN_DB, PIPELINE_FIXED_MAX_DB);
+    } else {
+        const float range = PIPELINE_FIXED_MAX_DB - PIPELINE_FIXED_MIN_DB;
+        for (int i = 0; i < count; i++) {
+            // 정규화 (원래 민감도)
+            float normalized = (db[i] - PIPELINE_FIXED_MIN_DB) / range;  // -60dB ~ 0dB -> 0.0 ~ 1.0
+
+            if (normalized < 0.0f) normalized = 0.0f;
+            if (normalized > 1.0f) normalized = 1.0f;
+            target[i] = normalized;
+        }
+    }
+}
+
+// 주파수 대역별로 그룹화 (미리 계산한 가중치 테이블 적용)
+static void GroupIntoBars(AudioPipeline* p, const EnvelopeCoefficients* env) {
+    int barCount = p->barCount;
+
+    if (p->cqt) {
+        // 상수 Q: 메인 FFT의 복소 스펙트럼에 희소 커널을 곱해서 막대마다 빈 하나
+        ConstantQ_Apply(p->cqt, FFT_GetSpectrum(&p->fft), p->bands);
+    } else if (p->bassBars > 0) {
+        // 크로스오버 아래는 저역 FFT, 위는 메인 FFT
+        BarMapper_ApplyRange(&p->bassMapper, p->bassOutput, p->bands, 0, p->bassBars);
+        BarMapper_ApplyRange(&p->mapper, p->fftOutput, p->bands, p->bassBars, barCount);
+    } else {
+        BarMapper_Apply(&p->mapper, p->fftOutput, p->bands);
+    }
+
+    NormalizeBars(p, p->bands, p->target, barCount, &p->gain);
+    UpdateEnvelope(p, env);
+}
+
+// 윈도우 RMS (FFT보다 훨씬 싸므로 게이트 판정에 사용)
+static float WindowRms(const float* x, int count) {
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        s0 += x[i] * x[i];
+        s1 += x[i + 1] * x[i + 1];
+        s2 += x[i + 2] * x[i + 2];
+        s3 += x[i + 3] * x[i + 3];
+    }
+    for (; i < count; i++) s0 += x[i] * x[i];
+    return sqrtf((s0 + s1 + s2 + s3) / count);
+}
+
+// 게이트에 걸린 프레임: FFT 없이 막대만 0으로 감쇠 (박자 추적은 무음 홉으로 시간만 진행)
+static void DecayEnvelope(float* bars, float* target, float* peaks, float* peakHold,
+                          float* peakVelocity, int count, const EnvelopeCoefficients* env) {
+    memset(target, 0, sizeof(float) * count);
+    RunEnvelope(bars, target, peaks, peakHold, peakVelocity, count, env);
+    for (int i = 0; i < count; i++) {
+        if (bars[i] < 0.0001f) bars[i] = 0.0f;
+    }
+}
+
+static void DecayBars(AudioPipeline* p, const EnvelopeCoefficients* env) {
+    DecayEnvelope(p->bars, p->target, p->peaks, p->peakHold, p->peakVelocity, p->barCount, env);
+}
+
+// 막대 수 / 홉 / 창 길이가 바뀌면 분포를 처음부터
+static void ResetGain(AudioPipeline* p) {
+    p->gainWindowSec = p->autoGainWindowSec.load(std::memory_order_relaxed);
+    AutoGain_Init(&p->gain, p->barCount, p->gainWindowSec, (float)p->hopSize / p->sampleRate);
+}
+
+static void ResetBars(AudioPipeline* p) {
+    memset(p->target, 0, sizeof(p->target));
+    memset(p->bars, 0, sizeof(p->bars));
+    memset(p->peaks, 0, sizeof(p->peaks));
+    memset(p->peakHold, 0, sizeof(p->peakHold));
+    memset(p->peakVelocity, 0, sizeof(p->peakVelocity));
+}
+
+// 저역 경로 (재)생성: 막대 배치 / FFT 크기 / 켜기가 바뀔 때 (DSP 스레드에서만)
+static void ApplyBass(AudioPipeline* p, int enable) {
+    FFT_Free(&p->bassFft);
+    BarMapper_Free(&p->bassMapper);
+    p->dual = enable;
+    p->bassBars = 0;
+    if (!enable) return;
+
+    // 6kHz 아래로 내려가지 않는 만큼 2배 단을 쌓음 (48kHz -> 6kHz, 44.1kHz -> 11.025kHz)
+    int stages = 0;
+    while (stages < DECIMATOR_MAX_STAGES && (p->sampleRate >> (stages + 1)) >= PIPELINE_BASS_MIN_RATE) {
+        stages++;
+    }
+    int bars = BarMapper_CountBarsBelow(&p->mapper, PIPELINE_BASS_CROSSOVER_HZ);
+    if (stages == 0 || bars == 0) return;   // 선형 축처럼 첫 막대부터 크로스오버를 넘으면 의미 없음
+    if (p->barScale == BAR_SCALE_CQT) return;   // 상수 Q는 저역 창이 이미 길어짐
+
+    int rate = p->sampleRate >> stages;
+    int size = FFT_MIN_SIZE;
+    while (size < PIPELINE_BASS_MAX_FFT && (float)rate / size > PIPELINE_BASS_BIN_HZ) size *= 2;
+
+    if (!FFT_Init(&p->bassFft, size, FFT_WINDOW_RECT)) return;
+    if (!BarMapper_Init(&p->bassMapper, p->barCount, p->barScale, size, rate,
+                        p->mapper.minFreq, p->mapper.maxFreq)) {
+        FFT_Free(&p->bassFft);
+        return;
+    }
+    Decimator_Init(&p->decimator, stages);
+    memset(p->bassHistory, 0, sizeof(p->bassHistory));
+    memset(p->bassOutput, 0, sizeof(p->bassOutput));
+    p->bassPos = 0;
+    p->bassPending = size;
+    p->bassRate = rate;
+    p->bassFftSize = size;
+    p->bassBars = bars;
+}
+
+// STFT에 넣은 샘플을 같은 만큼 데시메이션해서 저역 창에 추가
+static void FeedBass(AudioPipeline* p, const float* mono, int count) {
+    int n = Decimator_Process(&p->decimator, mono, count, p->decimated);
+    int size = p->bassFftSize;
+    for (int i = 0; i < n; i++) {
+        p->bassHistory[p->bassPos] = p->decimated[i];
+        p->bassHistory[p->bassPos + size] = p->decimated[i];
+        p->bassPos = (p->bassPos + 1 == size) ? 0 : p->bassPos + 1;
+    }
+    p->bassPending += n;
+}
+
+// 화성 / 타악 분리 상태 (FFT 크기가 바뀌면 창을 처음부터, 메모리가 없으면 끈 채로)
+static void ApplyHpss(AudioPipeline* p, int enable) {
+    Hpss_Free(&p->separator);
+    p->hpss = 0;
+    p->harmonicLevel = 0.0f;
+    p->percussiveLevel = 0.0f;
+    if (!enable) return;
+
+    if (!Hpss_Init(&p->separator, p->fftSize / 2, HPSS_HARMONIC_FRAMES, HPSS_PERCUSSIVE_BINS)) {
+        p->requestedHpss.store(0, std::memory_order_relaxed);
+        return;
+    }
+    p->hpss = 1;
+}
+
+// 성분 에너지 -> dB -> 0.0 ~ 1.0 (고정 범위), 즉시 올라가고 천천히 내려감
+static float HpssLevel(float level, float energy, float release) {
+    float db = 10.0f * log10f(energy + 1e-10f);
+    float target = (db - PIPELINE_FIXED_MIN_DB) / (PIPELINE_FIXED_MAX_DB - PIPELINE_FIXED_MIN_DB);
+    if (target < 0.0f) target = 0.0f;
+    if (target > 1.0f) target = 1.0f;
+    return target > level ? target : level + (target - level) * release;
+}
+
+// 상수 Q 커널 (같은 설정이면 캐시에서 바로, 구독자와 공유)
+static const ConstantQKernel* AcquireCqt(AudioPipeline* p, int barCount) {
+    int binsPerOctave = barCount / PIPELINE_CQT_OCTAVES;
+    if (binsPerOctave < 1) binsPerOctave = 1;
+    return ConstantQ_Acquire(p->sampleRate, p->fftSize, binsPerOctave, barCount, PIPELINE_CQT_MIN_HZ);
+}
+
+// 상수 Q 축의 막대 테이블은 같은 범위의 옥타브 축 (커널이 없을 때 대신 사용), 나머지는 기본 범위
+static void BarRange(int barScale, float* minFreq, float* maxFreq) {
+    *minFreq = 0.0f;
+    *maxFreq = 0.0f;
+    if (barScale == BAR_SCALE_CQT) {
+        *minFreq = PIPELINE_CQT_MIN_HZ;
+        *maxFreq = PIPELINE_CQT_MIN_HZ * (1 << PIPELINE_CQT_OCTAVES);
+    }
+}
+
+// 상수 Q 커널 교체
+static void ApplyCqt(AudioPipeline* p) {
+    const ConstantQKernel* old = p->cqt;
+    p->cqt = p->barScale == BAR_SCALE_CQT ? AcquireCqt(p, p->barCount) : NULL;
+    ConstantQ_Release(old);
+}
+
+// 구독자 막대 테이블 / 포락선 / 자동 게인 (재)생성: 구독 직후와 FFT 크기 / 홉이 바뀔 때 (DSP 스레드에서만)
+static int ConfigureConsumer(AudioPipeline* p, PipelineConsumer* c) {
+    const SpectrumSubscription* cfg = &c->config;
+
+    BarMapper_Free(&c->mapper);
+    ConstantQ_Release(c->cqt);
+    c->cqt = NULL;
+
+    float minFreq, maxFreq;
+    BarRange(cfg->barScale, &minFreq, &maxFreq);
+    if (!BarMapper_Init(&c->mapper, cfg->barCount, cfg->barScale, p->fftSize, p->sampleRate,
+                        minFreq, maxFreq)) {
+        return 0;
+    }
+    if (cfg->barScale == BAR_SCALE_CQT) c->cqt = AcquireCqt(p, cfg->barCount);
+
+    // 최대 빈도에 가장 가까운 홉 배수마다 (포락선 / 자동 게인은 그 간격 기준)
+    float hopSec = (float)p->hopSize / p->sampleRate;
+    c->decimation = cfg->rate > 0.0f ? (int)lrintf(1.0f / (cfg->rate * hopSec)) : 1;
+    if (c->decimation < 1) c->decimation = 1;
+    c->countdown = 1;
+
+    c->env.dt = hopSec * c->decimation;
+    c->env.attack = TimeConstantCoefficient(c->env.dt, cfg->attackMs);
+    c->env.release = TimeConstantCoefficient(c->env.dt, cfg->releaseMs);
+    c->env.holdTime = p->peakHoldMs.load(std::memory_order_relaxed) / 1000.0f;
+    c->env.gravity = p->peakGravity.load(std::memory_order_relaxed);
+
+    AutoGain_Init(&c->gain, cfg->barCount, p->gainWindowSec, c->env.dt);
+    memset(c->target, 0, sizeof(c->target));
+    memset(c->bars, 0, sizeof(c->bars));
+    memset(c->peaks, 0, sizeof(c->peaks));
+    memset(c->peakHold, 0, sizeof(c->peakHold));
+    memset(c->peakVelocity, 0, sizeof(c->peakVelocity));
+    return 1;
+}
+
+static void FreeConsumer(PipelineConsumer* c) {
+    if (!c) return;
+    BarMapper_Free(&c->mapper);
+    ConstantQ_Release(c->cqt);
+    free(c);
+}
+
+// FFT 크기가 바뀌면 구독자 막대 테이블도 다시 (못 만들면 낡은 막대를 계속 내지 않게 실패 상태로)
+static void ConfigureConsumers(AudioPipeline* p) {
+    for (int i = 0; i < PIPELINE_MAX_CONSUMERS; i++) {
+        int word = p->consumerState[i].load(std::memory_order_acquire);
+        if (CONSUMER_STATE(word) != CONSUMER_ACTIVE) continue;
+        if (!ConfigureConsumer(p, p->consumers[i])) {
+            // 그새 해지됐으면 CLOSING 그대로
+            p->consumerState[i].compare_exchange_strong(word, CONSUMER_WORD(word, CONSUMER_FAILED),
+                                                        std::memory_order_acq_rel);
+        }
+    }
+}
+
+// 새 구독 준비 / 해지된 구독 정리 (Process 시작마다, 슬롯 수만큼의 원자 읽기)
+static void ServiceConsumers(AudioPipeline* p) {
+    for (int i = 0; i < PIPELINE_MAX_CONSUMERS; i++) {
+        // 상태와 읽는 스레드 수는 순차 일관으로: ReadSubscription은 수를 올린 뒤 상태를 보므로
+        // CLOSING을 본 뒤 0이면 그 뒤 들어온 읽기는 CLOSING을 보고 구독자에 손대지 않음
+        int word = p->consumerState[i].load();
+        int state = CONSUMER_STATE(word);
+        if (state == CONSUMER_PENDING) {
+            // 막대 테이블을 못 만들면 실패 상태로 (홉마다 다시 할당하지 않음, 읽기는 -1, 해지하면 정리됨)
+            int ready = ConfigureConsumer(p, p->consumers[i]);
+            int next = CONSUMER_WORD(word, ready ? CONSUMER_ACTIVE : CONSUMER_FAILED);
+            p->consumerState[i].compare_exchange_strong(word, next, std::memory_order_acq_rel);
+        } else if (state == CONSUMER_CLOSING) {
+            if (p->consumerReaders[i].load() != 0) continue;    // 아직 복사 중, 다음 Process에서
+            FreeConsumer(p->consumers[i]);
+            p->consumers[i] = NULL;
+            p->consumerState[i].store(CONSUMER_WORD(word, CONSUMER_FREE), std::memory_order_release);
+        }
+    }
+}
+
+// 이번 홉 차례인 구독자마다 막대 매핑 -> 정규화 -> 포락선 -> 발행 (메인 프레임의 박자 / 시각 공유)
+static void RunConsumers(AudioPipeline* p, const SpectrumFrame* shared, int gated) {
+    for (int i = 0; i < PIPELINE_MAX_CONSUMERS; i++) {
+        if (CONSUMER_STATE(p->consumerState[i].load(std::memory_order_acquire)) != CONSUMER_ACTIVE) continue;
+        PipelineConsumer* c = p->consumers[i];
+        if (--c->countdown > 0) continue;
+        c->countdown = c->decimation;
+
+        int count = c->config.barCount;
+        if (gated) {
+            DecayEnvelope(c->bars, c->target, c->peaks, c->peakHold, c->peakVelocity, count, &c->env);
+        } else {
+            if (c->cqt) ConstantQ_Apply(c->cqt, FFT_GetSpectrum(&p->fft), c->bands);
+            else BarMapper_Apply(&c->mapper, p->fftOutput, c->bands);
+            NormalizeBars(p, c->bands, c->target, count, &c->gain);
+            RunEnvelope(c->bars, c->target, c->peaks, c->peakHold, c->peakVelocity, count, &c->env);
+        }
+
+        // 두 슬롯을 번갈아 씀 (구독자는 latest 슬롯만 읽음)
+        int idx = c->latest.load(std::memory_order_relaxed) == 0 ? 1 : 0;
+        SpectrumFrame* slot = &c->slots[idx];
+        unsigned int seq = c->seq[idx].load(std::memory_order_relaxed);
+        c->seq[idx].store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        memcpy(slot->spectrum.bars, c->bars, sizeof(float) * count);
+        memcpy(slot->peaks.bars, c->peaks, sizeof(float) * count);
+        slot->barCount = count;
+        slot->barScale = c->config.barScale;
+        slot->beat = shared->beat;
+        slot->features = shared->features;
+        slot->hasFeatures = shared->hasFeatures;
+        slot->harmonic = shared->harmonic;
+        slot->percussive = shared->percussive;
+        slot->hasHpss = shared->hasHpss;
+        slot->sequence = ++c->frameCount;
+        slot->samplePosition = shared->samplePosition;
+        slot->timestamp = shared->timestamp;
+        slot->publishTime = shared->publishTime;
+
+        c->seq[idx].store(seq + 2, std::memory_order_release);
+        c->latest.store(idx, std::memory_order_release);
+    }
+}
+
+// FFT / STFT 버퍼와 막대 테이블 (재)생성 (DSP 스레드에서만)
+static int ApplyConfig(AudioPipeline* p, int fftSize, int hopSize, int barCount, int barScale) {
+    FFTContext newFft;
+    STFTBuffer newStft;
+    BarMapper newMapper;
+
+    if (hopSize > fftSize) hopSize = fftSize;
+    if (barCount < 1 || barCount > SPECTRUM_MAX_BARS) barCount = SPECTRUM_BARS;
+
+    float minFreq, maxFreq;
+    BarRange(barScale, &minFreq, &maxFreq);
+    if (!BarMapper_Init(&newMapper, barCount, barScale, fftSize, p->sampleRate, minFreq, maxFreq)) {
+        return 0;
+    }
+
+    // FFT 크기가 같으면 막대 테이블만 교체 (모으던 샘플 유지)
+    if (fftSize == p->fftSize && hopSize == p->hopSize) {
+        BarMapper_Free(&p->mapper);
+        p->mapper = newMapper;
+        p->barCount = barCount;
+        p->barScale = barScale;
+        ApplyCqt(p);
+        ApplyBass(p, p->dual);
+        ResetBars(p);
+        ResetGain(p);
+        return 1;
+    }
+
+    if (!FFT_Init(&newFft, fftSize, FFT_WINDOW_RECT)) {
+        BarMapper_Free(&newMapper);
+        return 0;
+    }
+    if (!STFT_Init(&newStft, fftSize, hopSize, 1)) {
+        FFT_Free(&newFft);
+        BarMapper_Free(&newMapper);
+        return 0;
+    }
+
+    // 홉이 바뀌면 포락선 속도가 달라지므로 박자 추적도 처음부터
+    if (hopSize != p->hopSize) {
+        BeatTracker_Init(&p->beat, p->sampleRate, hopSize);
+    }
+
+    FFT_Free(&p->fft);
+    STFT_Free(&p->stft);
+    BarMapper_Free(&p->mapper);
+    p->fft = newFft;
+    p->stft = newStft;
+    p->mapper = newMapper;
+    p->fftSize = fftSize;
+    p->hopSize = hopSize;
+    p->barCount = barCount;
+    p->barScale = barScale;
+    memset(p->fftOutput, 0, sizeof(p->fftOutput));
+    FeatureExtractor_Init(&p->extractor, fftSize, p->sampleRate);
+    ApplyCqt(p);
+    memset(&p->features, 0, sizeof(p->features));
+    ApplyBass(p, p->dual);
+    if (p->hpss) ApplyHpss(p, 1);
+    ResetBars(p);
+    ResetGain(p);
+    ConfigureConsumers(p);
+    return 1;
+}
+
+// 시퀀스 카운터가 붙은 슬롯에 쓰기 (DSP 스레드 전용, 홀수 = 쓰는 중)
+static void WriteSlot(std::atomic<unsigned int>* seq, SpectrumFrame* slot, const SpectrumFrame* frame) {
+    unsigned int value = seq->load(std::memory_order_relaxed);
+    seq->store(value + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    *slot = *frame;
+
+    seq->store(value + 2, std::memory_order_release);   // 짝수 = 완료
+}
+
+// 슬롯 하나 복사 (쓰는 중이거나 복사하는 동안 덮어쓰면 0)
+static int ReadSlot(std::atomic<unsigned int>* seq, const SpectrumFrame* slot, SpectrumFrame* out) {
+    unsigned int before = seq->load(std::memory_order_acquire);
+    if (before & 1) return 0;
+
+    SpectrumFrame copy = *slot;
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (seq->load(std::memory_order_relaxed) != before) return 0;
+    *out = copy;
+    return 1;
+}
+
+// 최근 프레임 링에 발행 (DSP 스레드 전용, 가장 오래된 슬롯을 덮어씀)
+static void PublishFrame(SpectrumHistory* out, const SpectrumFrame* frame) {
+    int idx = out->latest.load(std::memory_order_relaxed) + 1;
+    if (idx >= PIPELINE_HISTORY_FRAMES) idx = 0;
+
+    WriteSlot(&out->seq[idx], &out->slots[idx], frame);
+    int count = out->count.load(std::memory_order_relaxed);
+    if (count < PIPELINE_HISTORY_FRAMES) out->count.store(count + 1, std::memory_order_release);
+    out->latest.store(idx, std::memory_order_release);
+}
+
+// 슬롯의 타임스탬프만 읽기 (덮어쓰는 중이면 0)
+static int ReadSlotTimestamp(SpectrumHistory* h, int idx, long long* timestamp) {
+    unsigned int before = h->seq[idx].load(std::memory_order_acquire);
+    if (before & 1) return 0;
+
+    long long t = h->slots[idx].timestamp;
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (h->seq[idx].load(std::memory_order_relaxed) != before) return 0;
+    *timestamp = t;
+    return 1;
+}
+
+// 분석 윈도우 마지막 샘플의 캡처 시각 계산 (기준점에서 외삽)
+static long long FrameTimestamp(AudioPipeline* p, unsigned long long position) {
+    AudioAnchor next;
+    while (SpscRing_Peek(&p->anchors, &next) && next.position <= position) {
+        SpscRing_Read(&p->anchors, &p->anchor, 1);
+        p->hasAnchor = 1;
+    }
+
+    if (!p->hasAnchor || p->sampleRate <= 0) return 0;
+
+    long long delta = (long long)(position - p->anchor.position);
+    return p->anchor.timestamp + delta * p->ticksPerSecond / p->sampleRate;
+}
+
+int AudioPipeline_Init(AudioPipeline* p, int sampleRate, long long ticksPerSecond,
+                       int fftSize, int hopSize, int barCount, int barScale,
+                       unsigned int ringCapacity) {
+    if (!p || sampleRate <= 0) return 0;
+
+    memset(&p->fft, 0, sizeof(p->fft));
+    memset(&p->stft, 0, sizeof(p->stft));
+    memset(&p->mapper, 0, sizeof(p->mapper));
+    memset(&p->bassFft, 0, sizeof(p->bassFft));
+    memset(&p->bassMapper, 0, sizeof(p->bassMapper));
+    p->dual = 0;
+    p->bassBars = 0;
+    p->cqt = NULL;
+    ResetBars(p);
+    memset(&p->anchor, 0, sizeof(p->anchor));
+    memset(p->chunk, 0, sizeof(p->chunk));
+
+    p->sampleRate = sampleRate;
+    p->ticksPerSecond = ticksPerSecond;
+    p->writePosition = 0;
+    p->readPosition = 0;
+    p->droppedSamples.store(0);
+    p->hasAnchor = 0;
+    p->frameCount = 0;
+    p->fftSize = 0;
+    p->hopSize = 0;
+    p->requestedFftSize.store(fftSize);
+    p->requestedHopSize.store(hopSize);
+    p->requestedBarCount.store(barCount);
+    p->requestedBarScale.store(barScale);
+    p->clock = NULL;
+    p->onFrame = NULL;
+    p->onFrameUser = NULL;
+    p->profile = 0;
+    memset(&p->stats, 0, sizeof(p->stats));
+    p->paused.store(0);
+    p->gated.store(0);
+    p->gatedFrames.store(0);
+    p->gateOpenings.store(0);
+    p->featuresEnabled.store(0);
+    p->requestedDual.store(0);
+    p->requestedHpss.store(0);
+    p->hpss = 0;
+    memset(&p->separator, 0, sizeof(p->separator));
+    p->requestedSpectrogramRows.store(0);
+    p->requestedSpectrogramBars.store(0);
+    Spectrogram_Init(&p->spectrogram);
+    for (int i = 0; i < PIPELINE_MAX_CONSUMERS; i++) {
+        p->consumers[i] = NULL;
+        p->consumerState[i].store(CONSUMER_FREE);
+        p->consumerReaders[i].store(0);
+    }
+    AudioPipeline_SetGate(p, PIPELINE_GATE_DEFAULT_DB);
+    AudioPipeline_SetEnvelope(p, PIPELINE_ATTACK_MS, PIPELINE_RELEASE_MS,
+                              PIPELINE_PEAK_HOLD_MS, PIPELINE_PEAK_GRAVITY);
+    AudioPipeline_SetAutoGain(p, 1, PIPELINE_AUTO_GAIN_WINDOW_SEC);
+
+    for (int i = 0; i < PIPELINE_HISTORY_FRAMES; i++) p->output.seq[i].store(0);
+    p->output.latest.store(-1);
+    p->output.count.store(0);
+
+    if (!SpscRing_Init(&p->samples, sizeof(float), ringCapacity)) return 0;
+    if (!SpscRing_Init(&p->anchors, sizeof(AudioAnchor), ANCHOR_RING_SIZE)) {
+        SpscRing_Free(&p->samples);
+        return 0;
+    }
+    if (!ApplyConfig(p, fftSize, hopSize, barCount, barScale)) {
+        AudioPipeline_Free(p);
+        return 0;
+    }
+    return 1;
+}
+
+void AudioPipeline_Free(AudioPipeline* p) {
+    if (!p) return;
+    SpscRing_Free(&p->samples);
+    SpscRing_Free(&p->anchors);
+    FFT_Free(&p->fft);
+    STFT_Free(&p->stft);
+    BarMapper_Free(&p->mapper);
+    FFT_Free(&p->bassFft);
+    BarMapper_Free(&p->bassMapper);
+    ConstantQ_Release(p->cqt);
+    p->cqt = NULL;
+    Hpss_Free(&p->separator);
+    p->hpss = 0;
+    p->output.latest.store(-1);
+    p->output.count.store(0);
+    Spectrogram_Free(&p->spectrogram);
+    for (int i = 0; i < PIPELINE_MAX_CONSUMERS; i++) {
+        FreeConsumer(p->consumers[i]);
+        p->consumers[i] = NULL;
+        p->consumerState[i].store(CONSUMER_WORD(p->consumerState[i].load(), CONSUMER_FREE));
+    }
+}
+
+int AudioPipeline_Write(AudioPipeline* p, const float* mono, int count, long long timestamp) {
+    if (!p || count <= 0) return 0;
+
+    // 기준점을 샘플보다 먼저 넣어서 소비자가 항상 최신 기준점을 볼 수 있게 함
+    if (timestamp != 0) {
+        AudioAnchor anchor = { p->writePosition, timestamp };
+        SpscRing_Write(&p->anchors, &anchor, 1);
+    }
+
+    unsigned int written = SpscRing_Write(&p->samples, mono, (unsigned int)count);
+    p->writePosition += written;
+    if (written < (unsigned int)count) {
+        p->droppedSamples.fetch_add(count - written, std::memory_order_relaxed);
+    }
+    return (int)written;
+}
+
+int AudioPipeline_Process(AudioPipeline* p) {
+    if (!p) return 0;
+
+    // 설정 변경 요청 반영 (크기가 바뀌면 모으던 샘플은 버림)
+    int fftSize = p->requestedFftSize.load(std::memory_order_acquire);
+    int hopSize = p->requestedHopSize.load(std::memory_order_acquire);
+    int barCount = p->requestedBarCount.load(std::memory_order_acquire);
+    int barScale = p->requestedBarScale.load(std::memory_order_acquire);
+    if (hopSize > fftSize) hopSize = fftSize;
+    if (fftSize != p->fftSize || hopSize != p->hopSize ||
+        barCount != p->barCount || barScale != p->barScale) {
+        ApplyConfig(p, fftSize, hopSize, barCount, barScale);
+    }
+    if (p->autoGainWindowSec.load(std::memory_order_relaxed) != p->gainWindowSec) {
+        ResetGain(p);
+        ConfigureConsumers(p);
+    }
+    ServiceConsumers(p);
+    int dual = p->requestedDual.load(std::memory_order_relaxed);
+    if (dual != p->dual) {
+        ApplyBass(p, dual);
+        ResetGain(p);   // 저역 막대 레벨이 달라짐
+    }
+    int hpss = p->requestedHpss.load(std::memory_order_relaxed);
+    if (hpss != p->hpss) ApplyHpss(p, hpss);
+    int spectrogramRows = p->requestedSpectrogramRows.load(std::memory_order_relaxed);
+    int spectrogramBars = p->requestedSpectrogramBars.load(std::memory_order_relaxed);
+    if (spectrogramRows != p->spectrogram.rows.load(std::memory_order_relaxed) ||
+        (spectrogramRows > 0 && spectrogramBars != p->spectrogram.barCount.load(std::memory_order_relaxed))) {
+        // 메모리가 없으면 끈 채로 (매번 다시 시도하지 않게)
+        if (!Spectrogram_Configure(&p->spectrogram, spectrogramRows, spectrogramBars)) {
+            p->requestedSpectrogramRows.store(p->spectrogram.rows.load(std::memory_order_relaxed),
+                                              std::memory_order_relaxed);
+        }
+    }
+
+    int profile = p->profile;
+    int features = p->featuresEnabled.load(std::memory_order_relaxed);
+    double t0 = profile ? NowNs() : 0.0;
+    int wasGated = p->gated.load(std::memory_order_relaxed);
+
+    EnvelopeCoefficients env;
+    ComputeEnvelope(p, &env);
+    float hpssRelease = TimeConstantCoefficient(env.dt, PIPELINE_HPSS_RELEASE_MS);
+
+    int frames = 0;
+    unsigned int count;
+    while ((count = SpscRing_Read(&p->samples, p->chunk, PIPELINE_CHUNK_SIZE)) > 0) {
+        const float* mono = p->chunk;
+        int left = (int)count;
+
+        while (left > 0) {
+            const float* window;
+            int used = STFT_Push(&p->stft, mono, left, &window);
+            if (p->bassBars > 0) {
+                double tb = profile ? NowNs() : 0.0;
+                FeedBass(p, mono, used);
+                if (profile) {
+                    // 데시메이션 시간은 stft가 아니라 bass로 (t0를 그만큼 뒤로)
+                    double dt = NowNs() - tb;
+                    p->stats.bassNs += dt;
+                    t0 += dt;
+                }
+            }
+            mono += used;
+            left -= used;
+            p->readPosition += used;
+
+            if (window) {
+                double t1 = 0.0, t2 = 0.0, t3 = 0.0;
+                if (profile) {
+                    t1 = NowNs();
+                    p->stats.stftNs += t1 - t0;
+                }
+
+                // 일시정지이거나 윈도우 전체가 임계값보다 조용하면 FFT 생략
+                // (윈도우에 새 홉이 들어오자마자 다시 열림)
+                float threshold = p->gateThreshold.load(std::memory_order_relaxed);
+                int gate = p->paused.load(std::memory_order_relaxed) ||
+                           (threshold > 0.0f && WindowRms(window, p->fftSize) < threshold);
+
+                if (gate) {
+                    DecayBars(p, &env);
+                    BeatTracker_ProcessSilence(&p->beat);
+                    if (features) memset(&p->features, 0, sizeof(p->features));
+                    if (p->hpss) {
+                        p->harmonicLevel = HpssLevel(p->harmonicLevel, 0.0f, hpssRelease);
+                        p->percussiveLevel = HpssLevel(p->percussiveLevel, 0.0f, hpssRelease);
+                    }
+                    p->gatedFrames.fetch_add(1, std::memory_order_relaxed);
+                    if (profile) {
+                        t0 = NowNs();
+                        p->stats.gateNs += t0 - t1;
+                    }
+                } else {
+                    if (wasGated) p->gateOpenings.fetch_add(1, std::memory_order_relaxed);
+                    if (profile) {
+                        double tg = NowNs();
+                        p->stats.gateNs += tg - t1;
+                        t1 = tg;
+                    }
+
+                    FFT_Magnitude(&p->fft, window, p->fftOutput);
+                    if (profile) t2 = NowNs();
+                    // 저역 창은 메인 홉보다 훨씬 길어서 75% 겹침이면 충분 (그 사이 프레임은 이전 결과)
+                    if (p->bassBars > 0 && p->bassPending >= p->bassFftSize / 4) {
+                        FFT_Magnitude(&p->bassFft, p->bassHistory + p->bassPos, p->bassOutput);
+                        p->bassPending = 0;
+                        if (profile) {
+                            double tb = NowNs();
+                            p->stats.bassNs += tb - t2;
+                            t1 += tb - t2;      // fft에는 메인 FFT만
+                            t2 = tb;
+                        }
+                    }
+                    GroupIntoBars(p, &env);
+                    if (profile) {
+                        t3 = NowNs();
+                        p->stats.fftNs += t2 - t1;
+                        p->stats.barsNs += t3 - t2;
+                    }
+                    const float* onsetSpectrum = p->fftOutput;
+                    if (p->hpss) {
+                        // 박자 추적은 타악 성분만 (지속음의 크기 변화가 onset으로 잡히지 않게)
+                        HpssEnergy energy;
+                        FFT_HannMagnitude(&p->fft, p->hpssInput);
+                        Hpss_Process(&p->separator, p->hpssInput, p->percussive, &energy);
+                        p->harmonicLevel = HpssLevel(p->harmonicLevel, energy.harmonic, hpssRelease);
+                        p->percussiveLevel = HpssLevel(p->percussiveLevel, energy.percussive, hpssRelease);
+                        onsetSpectrum = p->percussive;
+                        if (profile) {
+                            double th = NowNs();
+                            p->stats.hpssNs += th - t3;
+                            t3 = th;
+                        }
+                    }
+                    BeatTracker_Process(&p->beat, onsetSpectrum, p->fftSize / 2);
+                    if (profile) {
+                        t0 = NowNs();
+                        p->stats.beatNs += t0 - t3;
+                    }
+                    if (features) {
+                        FeatureExtractor_Process(&p->extractor, p->fftOutput, &p->features);
+                        if (profile) {
+                            double t5 = NowNs();
+                            p->stats.featuresNs += t5 - t0;
+                            t0 = t5;
+                        }
+                    }
+                }
+                wasGated = gate;
+                p->gated.store(gate, std::memory_order_relaxed);
+
+                SpectrumFrame frame;
+                memcpy(frame.spectrum.bars, p->bars, sizeof(float) * p->barCount);
+                memcpy(frame.peaks.bars, p->peaks, sizeof(float) * p->barCount);
+                frame.barCount = p->barCount;
+                frame.barScale = p->barScale;
+                BeatTracker_GetState(&p->beat, &frame.beat);
+                frame.hasFeatures = features;
+                if (features) frame.features = p->features;
+                else memset(&frame.features, 0, sizeof(frame.features));
+                frame.hasHpss = p->hpss;
+                frame.harmonic = p->harmonicLevel;
+                frame.percussive = p->percussiveLevel;
+                frame.sequence = ++p->frameCount;
+                frame.samplePosition = p->readPosition - 1;
+                frame.timestamp = FrameTimestamp(p, frame.samplePosition);
+                frame.publishTime = p->clock ? p->clock() : 0;
+                PublishFrame(&p->output, &frame);
+                Spectrogram_Push(&p->spectrogram, p->bars, p->barCount);
+                if (p->onFrame) p->onFrame(&frame, p->onFrameUser);
+                frames++;
+
+                if (profile) {
+                    double t4 = NowNs();
+                    p->stats.publishNs += t4 - t0;
+                    p->stats.frames++;
+                    t0 = t4;
+                }
+                RunConsumers(p, &frame, gate);
+                if (profile) {
+                    double t5 = NowNs();
+                    p->stats.consumersNs += t5 - t0;
+                    t0 = t5;
+                }
+            }
+        }
+    }
+    if (profile) p->stats.stftNs += NowNs() - t0;
+    return frames;
+}
+
+void AudioPipeline_RequestConfig(AudioPipeline* p, int fftSize, int hopSize) {
+    if (!p) return;
+    p->requestedFftSize.store(fftSize, std::memory_order_release);
+    p->requestedHopSize.store(hopSize, std::memory_order_release);
+}
+
+void AudioPipeline_RequestBarLayout(AudioPipeline* p, int barCount, int barScale) {
+    if (!p) return;
+    p->requestedBarCount.store(barCount, std::memory_order_release);
+    p->requestedBarScale.store(barScale, std::memory_order_release);
+}
+
+int AudioPipeline_Subscribe(AudioPipeline* p, const SpectrumSubscription* config) {
+    if (!p || !config || config->barCount < 1 || config->barCount > SPECTRUM_MAX_BARS ||
+        config->barScale < BAR_SCALE_LINEAR || config->barScale > BAR_SCALE_CQT ||
+        config->attackMs < 0.0f || config->releaseMs < 0.0f || config->rate < 0.0f) {
+        return 0;
+    }
+
+    for (int i = 0; i < PIPELINE_MAX_CONSUMERS; i++) {
+        // 빈 슬롯을 다음 세대로 예약
+        int word = p->consumerState[i].load(std::memory_order_acquire);
+        if (CONSUMER_STATE(word) != CONSUMER_FREE) continue;
+        int reserved = ((word + CONSUMER_STATE_MASK + 1) & CONSUMER_GENERATION_MASK) | CONSUMER_RESERVED;
+        if (!p->consumerState[i].compare_exchange_strong(word, reserved, std::memory_order_acq_rel)) {
+            continue;
+        }
+
+        // 막대 테이블은 DSP 스레드가 만듦 (FFT 크기를 바꾸는 것과 같은 스레드)
+        PipelineConsumer* c = (PipelineConsumer*)calloc(1, sizeof(PipelineConsumer));
+        if (!c) {
+            p->consumerState[i].store(CONSUMER_WORD(reserved, CONSUMER_FREE), std::memory_order_release);
+            return 0;
+        }
+        c->config = *config;
+        c->latest.store(-1, std::memory_order_relaxed);
+        p->consumers[i] = c;
+        p->consumerState[i].store(CONSUMER_WORD(reserved, CONSUMER_PENDING), std::memory_order_release);
+        return (i + 1) | (reserved & CONSUMER_GENERATION_MASK);
+    }
+    return 0;
+}
+
+// 핸들의 슬롯 (범위 밖이면 -1)
+static int HandleSlot(int handle) {
+    int slot = PIPELINE_HANDLE_SLOT(handle);
+    return handle > 0 && slot >= 0 && slot < PIPELINE_MAX_CONSUMERS ? slot : -1;
+}
+
+void AudioPipeline_Unsubscribe(AudioPipeline* p, int handle) {
+    int slot = HandleSlot(handle);
+    if (!p || slot < 0) return;
+
+    // 준비 전이든 후든 (실패했어도) DSP 스레드가 정리, 세대까지 같을 때만 (옛 핸들이면 아무것도 안 함)
+    std::atomic<int>* state = &p->consumerState[slot];
+    int generation = handle & CONSUMER_GENERATION_MASK;
+    int closing = generation | CONSUMER_CLOSING;
+    int expected = generation | CONSUMER_PENDING;
+    if (state->compare_exchange_strong(expected, closing)) return;
+    expected = generation | CONSUMER_ACTIVE;
+    if (state->compare_exchange_strong(expected, closing)) return;
+    expected = generation | CONSUMER_FAILED;
+    state->compare_exchange_strong(expected, closing);
+}
+
+int AudioPipeline_ReadSubscription(AudioPipeline* p, int handle, SpectrumFrame* out) {
+    int slot = HandleSlot(handle);
+    if (!p || !out || slot < 0) return 0;
+
+    // 읽는 동안 DSP 스레드가 구독자를 해제하지 않게 (수를 먼저 올리고 상태 확인, ServiceConsumers 참고)
+    p->consumerReaders[slot].fetch_add(1);
+    int word = p->consumerState[slot].load();
+    int result = 0;
+    if ((word & CONSUMER_GENERATION_MASK) != (handle & CONSUMER_GENERATION_MASK)) {
+        result = 0;     // 해지 후 다른 구독자가 받은 슬롯
+    } else if (CONSUMER_STATE(word) == CONSUMER_FAILED) {
+        result = -1;
+    } else if (CONSUMER_STATE(word) == CONSUMER_ACTIVE) {
+        PipelineConsumer* c = p->consumers[slot];
+        for (int attempt = 0; attempt < READ_RETRY_COUNT; attempt++) {
+            int idx = c->latest.load(std::memory_order_acquire);
+            if (idx < 0) break;
+            if (ReadSlot(&c->seq[idx], &c->slots[idx], out)) {
+                result = 1;
+                break;
+            }
+        }
+    }
+    p->consumerReaders[slot].fetch_sub(1, std::memory_order_release);
+    return result;
+}
+
+void AudioPipeline_SetEnvelope(AudioPipeline* p, float attackMs, float releaseMs,
+                               float peakHoldMs, float peakGravity) {
+    if (!p) return;
+    p->attackMs.store(attackMs > 0.0f ? attackMs : 0.0f, std::memory_order_relaxed);
+    p->releaseMs.store(releaseMs > 0.0f ? releaseMs : 0.0f, std::memory_order_relaxed);
+    p->peakHoldMs.store(peakHoldMs > 0.0f ? peakHoldMs : 0.0f, std::memory_order_relaxed);
+    p->peakGravity.store(peakGravity > 0.0f ? peakGravity : 0.0f, std::memory_order_relaxed);
+}
+
+void AudioPipeline_SetDualResolution(AudioPipeline* p, int enable) {
+    if (!p) return;
+    p->requestedDual.store(enable ? 1 : 0, std::memory_order_relaxed);
+}
+
+void AudioPipeline_SetSpectrogram(AudioPipeline* p, int rows, int barCount) {
+    if (!p) return;
+    p->requestedSpectrogramBars.store(barCount, std::memory_order_relaxed);
+    p->requestedSpectrogramRows.store(rows > 0 ? rows : 0, std::memory_order_relaxed);
+}
+
+void AudioPipeline_EnableFeatures(AudioPipeline* p, int enable) {
+    if (!p) return;
+    p->featuresEnabled.store(enable ? 1 : 0, std::memory_order_relaxed);
+}
+
+void AudioPipeline_EnableHpss(AudioPipeline* p, int enable) {
+    if (!p) return;
+    p->requestedHpss.store(enable ? 1 : 0, std::memory_order_relaxed);
+}
+
+void AudioPipeline_SetAutoGain(AudioPipeline* p, int enabled, float windowSec) {
+    if (!p) return;
+    if (windowSec > 0.0f) {
+        if (windowSec < AUDIO_AUTO_GAIN_MIN_WINDOW_SEC) windowSec = AUDIO_AUTO_GAIN_MIN_WINDOW_SEC;
+        if (windowSec > AUDIO_AUTO_GAIN_MAX_WINDOW_SEC) windowSec = AUDIO_AUTO_GAIN_MAX_WINDOW_SEC;
+        p->autoGainWindowSec.store(windowSec, std::memory_order_relaxed);
+    }
+    p->autoGain.store(enabled ? 1 : 0, std::memory_order_relaxed);
+}
+
+void AudioPipeline_SetGate(AudioPipeline* p, float thresholdDb) {
+    if (!p) return;
+    float rms = thresholdDb > -200.0f ? powf(10.0f, thresholdDb / 20.0f) : 0.0f;
+    p->gateThreshold.store(rms, std::memory_order_relaxed);
+}
+
+void AudioPipeline_SetPaused(AudioPipeline* p, int paused) {
+    if (!p) return;
+    p->paused.store(paused ? 1 : 0, std::memory_order_relaxed);
+}
+
+int AudioPipeline_IsGated(AudioPipeline* p) {
+    if (!p) return 0;
+    return p->gated.load(std::memory_order_relaxed);
+}
+
+void AudioPipeline_SetFrameCallback(AudioPipeline* p, PipelineFrameCallback callback, void* user) {
+    if (!p) return;
+    p->onFrame = callback;
+    p->onFrameUser = user;
+}
+
+void AudioPipeline_SetClock(AudioPipeline* p, PipelineClock clock) {
+    if (!p) return;
+    p->clock = clock;
+}
+
+void AudioPipeline_EnableProfiling(AudioPipeline* p, int enable) {
+    if (!p) return;
+    p->profile = enable ? 1 : 0;
+    memset(&p->stats, 0, sizeof(p->stats));
+}
+
+int AudioPipeline_ReadLatest(AudioPipeline* p, SpectrumFrame* out) {
+    if (!p || !out) return 0;
+
+    SpectrumHistory* h = &p->output;
+    for (int attempt = 0; attempt < READ_RETRY_COUNT; attempt++) {
+        int idx = h->latest.load(std::memory_order_acquire);
+        if (idx < 0) return 0;
+        if (ReadSlot(&h->seq[idx], &h->slots[idx], out)) return 1;    // 실패 = DSP가 링을 한 바퀴 돌아 덮어씀
+    }
+    return 0;
+}
+
+int AudioPipeline_ReadAt(AudioPipeline* p, long long timestamp, SpectrumFrame* out) {
+    if (!p || !out) return 0;
+
+    SpectrumHistory* h = &p->output;
+    for (int attempt = 0; attempt < READ_RETRY_COUNT; attempt++) {
+        int latest = h->latest.load(std::memory_order_acquire);
+        if (latest < 0) return 0;
+        int count = h->count.load(std::memory_order_acquire);
+
+        // 최신 프레임부터 거꾸로: 타임스탬프가 timestamp 이하인 첫 프레임
+        // 덮어쓰는 중이거나 이미 새 프레임으로 바뀐 슬롯 (시간이 거꾸로 감), 타임스탬프가 없는 프레임을
+        // 만나면 거기서 멈춤 (그 직전 프레임 사용)
+        int chosen = latest;
+        long long previous = 0;
+        for (int i = 0; i < count; i++) {
+            int idx = latest - i;
+            if (idx < 0) idx += PIPELINE_HISTORY_FRAMES;
+
+            long long t;
+            if (!ReadSlotTimestamp(h, idx, &t) || t == 0 || (i > 0 && t > previous)) break;
+            chosen = idx;
+            previous = t;
+            if (t <= timestamp) break;
+        }
+
+        if (ReadSlot(&h->seq[chosen], &h->slots[chosen], out)) return 1;
+    }
+    return 0;
+}
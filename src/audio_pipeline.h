@@ -0,0 +1,319 @@
+/*
+ * audio_pipeline.h - Audio DSP Stage (platform-neutral, C++ 전용)
+ *
+ * 캡처 스레드 --(SPSC 링)--> DSP 단계 --(최근 프레임 링)--> UI
+ * 스레드는 만들지 않음: 생산자/소비자 스레드는 호출하는 쪽에서 관리
+ */
+
+#ifndef AUDIO_PIPELINE_H
+#define AUDIO_PIPELINE_H
+
+#include "audio_capture.h"
+#include "spsc_ring.h"
+#include "stft.h"
+#include "fft.h"
+#include "beat_tracker.h"
+#include "auto_gain.h"
+#include "spectral_features.h"
+#include "decimator.h"
+#include "constant_q.h"
+#include "spectrogram.h"
+#include "hpss.h"
+
+#include <atomic>
+
+#define PIPELINE_CHUNK_SIZE 1024
+#define PIPELINE_GATE_DEFAULT_DB -70.0f     // 이보다 조용한 윈도우는 FFT 생략 (dBFS RMS)
+
+// 막대 포락선 기본값 (홉 512 / 48kHz에서 예전 0.7 / 0.3 스무딩과 같은 시상수)
+#define PIPELINE_ATTACK_MS 30.0f
+#define PIPELINE_RELEASE_MS 30.0f
+#define PIPELINE_PEAK_HOLD_MS 500.0f
+#define PIPELINE_PEAK_GRAVITY 3.0f          // 피크 낙하 가속도 (막대 높이 / 초^2)
+
+// 막대 dB -> 0.0 ~ 1.0: 고정 범위 또는 막대별 자동 게인 (최근 분포의 분위수)
+#define PIPELINE_FIXED_MIN_DB -60.0f
+#define PIPELINE_FIXED_MAX_DB 0.0f
+#define PIPELINE_AUTO_GAIN_WINDOW_SEC 5.0f
+
+// 이중 해상도: 크로스오버 아래 막대는 데시메이션한 저역 스트림(6 ~ 12kHz)의 작은 FFT에서
+#define PIPELINE_BASS_CROSSOVER_HZ 300.0f
+#define PIPELINE_BASS_MIN_RATE 6000         // 저역 스트림 샘플레이트 하한 (2배 단 수 결정)
+#define PIPELINE_BASS_BIN_HZ 12.0f          // 저역 FFT 빈 간격 목표 (48kHz에서 4096점과 비슷)
+#define PIPELINE_BASS_MAX_FFT 1024
+
+// 상수 Q 축 (BAR_SCALE_CQT): C1부터 8옥타브, 옥타브당 막대 수 / 8개 빈 (16 막대 = 반옥타브)
+#define PIPELINE_CQT_MIN_HZ 32.7032f
+#define PIPELINE_CQT_OCTAVES 8
+
+// 화성 / 타악 분리 (HPSS): 성분 에너지 dB를 고정 범위로 정규화, 즉시 올라가고 이 시상수로 내려감
+#define PIPELINE_HPSS_RELEASE_MS 80.0f
+#define PIPELINE_HPSS_BUDGET_US 150.0       // 프레임당 분리 비용 목표 (2048점 기준, 홉 512 / 48kHz 간격 10.7ms의 1.5%)
+
+// 구독자 수 상한 (막대 / 박자 / 내보내기 등, 모두 같은 FFT 결과를 씀)
+#define PIPELINE_MAX_CONSUMERS 8
+
+// 구독 핸들 = (슬롯 + 1) | 세대 << 8: 해지 후 슬롯이 다시 쓰이면 옛 핸들은 세대가 달라 아무것도 못 건드림
+#define PIPELINE_HANDLE_SLOT(handle) (((handle) & 0xFF) - 1)
+
+// 최근 프레임 보관 수 (홉 512 / 48kHz에서 약 340ms, 화면 시각에 맞는 프레임을 고르는 범위)
+#define PIPELINE_HISTORY_FRAMES 32
+
+// 샘플 위치 <-> 캡처 시각 기준점
+typedef struct {
+    unsigned long long position;    // 링에 들어간 샘플 위치
+    long long timestamp;            // 그 샘플의 캡처 시각
+} AudioAnchor;
+
+// 프레임 발행 시각용 시계 (타임스탬프와 같은 단위, 아무 스레드에서나 호출 가능해야 함)
+typedef long long (*PipelineClock)(void);
+
+// 프레임마다 호출되는 콜백 (DSP 스레드에서, 오프라인 분석 등)
+typedef void (*PipelineFrameCallback)(const SpectrumFrame* frame, void* user);
+
+// 단계별 누적 처리 시간 (프로파일링을 켰을 때만, ns)
+typedef struct {
+    unsigned long long frames;
+    double stftNs;          // 링 읽기 + STFT 윈도우 조립
+    double fftNs;           // FFT 크기 스펙트럼
+    double barsNs;          // 막대 매핑 + dB + 스무딩
+    double beatNs;          // 박자 추적
+    double featuresNs;      // 음색 특징 (켰을 때만)
+    double bassNs;          // 저역 데시메이션 + 저역 FFT (이중 해상도일 때만)
+    double hpssNs;          // 화성 / 타악 분리 (켰을 때만)
+    double consumersNs;     // 구독자 막대 매핑 + 발행 (구독자가 있을 때만)
+    double gateNs;          // 게이트 판정 + 게이트에 걸린 프레임의 막대 감쇠
+    double publishNs;       // 프레임 발행 + 콜백
+} PipelineStats;
+
+// 프레임 간격에 맞춘 포락선 계수
+typedef struct {
+    float dt;           // 프레임 간격 (초)
+    float attack;       // 1 - exp(-dt / 시상수)
+    float release;
+    float holdTime;     // 초
+    float gravity;
+} EnvelopeCoefficients;
+
+// 구독자 상태 (구독 / 해지는 아무 스레드, 준비 / 정리는 DSP 스레드)
+// consumerState는 상태 | 세대 << 8 (세대는 슬롯을 내줄 때마다 증가, 핸들의 세대와 같아야 유효)
+enum {
+    CONSUMER_FREE = 0,
+    CONSUMER_RESERVED,              // 구독하는 스레드가 설정을 채우는 중
+    CONSUMER_PENDING,               // DSP 스레드가 막대 테이블을 만들 차례
+    CONSUMER_ACTIVE,
+    CONSUMER_CLOSING,               // 해지됨, DSP 스레드가 정리할 차례
+    CONSUMER_FAILED                 // 막대 테이블을 못 만듦 (다시 시도하지 않음, 해지하면 정리)
+};
+
+// 구독자: 메인 FFT 결과를 자기 막대 배치 / 스무딩 / 빈도로 (FFT를 더 하지 않음)
+typedef struct {
+    SpectrumSubscription config;    // 구독할 때 정한 설정 (바뀌지 않음)
+
+    // DSP 상태 (소비자 스레드 전용)
+    BarMapper mapper;
+    const ConstantQKernel* cqt;     // 상수 Q 축이면 (캐시에서 메인과 공유)
+    int decimation;                 // 몇 홉마다 한 번 계산 / 발행할지 (rate에서)
+    int countdown;
+    EnvelopeCoefficients env;       // decimation 홉 간격 기준
+    float bands[SPECTRUM_MAX_BARS];
+    float target[SPECTRUM_MAX_BARS];
+    float bars[SPECTRUM_MAX_BARS];
+    float peaks[SPECTRUM_MAX_BARS];
+    float peakHold[SPECTRUM_MAX_BARS];
+    float peakVelocity[SPECTRUM_MAX_BARS];
+    AutoGain gain;
+    unsigned long long frameCount;
+
+    // 출력 (DSP -> 구독자, 슬롯별 시퀀스 카운터)
+    SpectrumFrame slots[2];
+    std::atomic<unsigned int> seq[2];
+    std::atomic<int> latest;
+} PipelineConsumer;
+
+// 락 없는 출력 링 (최근 프레임 보관, 슬롯별 시퀀스 카운터, 홀수 = 쓰는 중)
+typedef struct {
+    SpectrumFrame slots[PIPELINE_HISTORY_FRAMES];
+    std::atomic<unsigned int> seq[PIPELINE_HISTORY_FRAMES];
+    std::atomic<int> latest;        // 마지막으로 완성된 슬롯 (-1 = 없음)
+    std::atomic<int> count;         // 채워진 슬롯 수 (최대 PIPELINE_HISTORY_FRAMES)
+} SpectrumHistory;
+
+typedef struct {
+    // 입력 (생산자 -> DSP)
+    SpscRing samples;               // 모노 float 샘플
+    SpscRing anchors;               // AudioAnchor
+    unsigned long long writePosition;               // 생산자 전용
+    std::atomic<unsigned long long> droppedSamples; // 링이 가득 차서 버린 샘플 수
+
+    // 설정
+    int sampleRate;
+    long long ticksPerSecond;       // 타임스탬프 단위
+    std::atomic<int> requestedFftSize;
+    std::atomic<int> requestedHopSize;
+    std::atomic<int> requestedBarCount;
+    std::atomic<int> requestedBarScale;
+
+    // 막대 포락선 (시간 기준이라 홉 크기 / 화면 갱신 주기와 무관)
+    std::atomic<float> attackMs;
+    std::atomic<float> releaseMs;
+    std::atomic<float> peakHoldMs;
+    std::atomic<float> peakGravity;
+
+    // 자동 게인 (0 = 고정 -60 ~ 0dB)
+    std::atomic<int> autoGain;
+    std::atomic<float> autoGainWindowSec;
+
+    // 음색 특징 계산 (기본 꺼짐)
+    std::atomic<int> featuresEnabled;
+
+    // 이중 해상도 (기본 꺼짐)
+    std::atomic<int> requestedDual;
+
+    // 화성 / 타악 분리 (기본 꺼짐)
+    std::atomic<int> requestedHpss;
+
+    // 스펙트로그램 기록 (행 수 0 = 꺼짐)
+    std::atomic<int> requestedSpectrogramRows;
+    std::atomic<int> requestedSpectrogramBars;
+
+    // DSP 상태 (소비자 전용)
+    int fftSize;
+    int hopSize;
+    int barCount;
+    int barScale;
+    FFTContext fft;
+    STFTBuffer stft;
+    float fftOutput[FFT_MAX_SIZE / 2];
+    float chunk[PIPELINE_CHUNK_SIZE];
+    BarMapper mapper;               // 빈 -> 막대 가중치 테이블 (설정 변경 때만 다시 계산)
+    const ConstantQKernel* cqt;     // 상수 Q 축일 때 커널 (캐시 공유, 없으면 mapper 사용)
+    float bands[SPECTRUM_MAX_BARS]; // 막대별 평균 크기
+    float target[SPECTRUM_MAX_BARS];    // 이번 프레임 막대 값 (0.0 ~ 1.0, 스무딩 전)
+    float bars[SPECTRUM_MAX_BARS];      // 포락선을 거친 막대 값
+    float peaks[SPECTRUM_MAX_BARS];     // 피크 유지 표시
+    float peakHold[SPECTRUM_MAX_BARS];  // 남은 유지 시간 (초)
+    float peakVelocity[SPECTRUM_MAX_BARS];
+    BeatTracker beat;               // 같은 FFT 크기 스펙트럼으로 박자 추적
+    AutoGain gain;                  // 막대별 dB 분포 (설정이 바뀌면 처음부터)
+    FeatureExtractor extractor;     // 빈 -> 음 테이블 (FFT 크기가 바뀔 때만 다시 계산)
+    SpectralFeatures features;      // 마지막 프레임의 특징
+
+    // 저역 경로 (이중 해상도, 소비자 전용)
+    int dual;
+    int bassBars;                   // 앞쪽 막대 중 저역 FFT에서 가져오는 수 (0 = 저역 경로 없음)
+    int bassFftSize;
+    int bassRate;
+    Decimator decimator;
+    FFTContext bassFft;
+    BarMapper bassMapper;           // 메인과 같은 막대 경계, 저역 FFT 빈 기준
+    float bassHistory[2 * PIPELINE_BASS_MAX_FFT];   // 데시메이션된 샘플 (두 번 써서 연속 창)
+    int bassPos;
+    int bassPending;                // 마지막 저역 FFT 뒤로 들어온 샘플 수
+    float bassOutput[PIPELINE_BASS_MAX_FFT / 2];
+    float decimated[PIPELINE_CHUNK_SIZE];
+
+    // 화성 / 타악 분리 (소비자 전용, 켰을 때 박자 추적은 타악 성분으로)
+    int hpss;
+    Hpss separator;
+    float hpssInput[FFT_MAX_SIZE / 2];     // 메인 스펙트럼에 주파수 영역 Hann을 적용한 크기 (누설이 적어야 분리가 됨)
+    float percussive[FFT_MAX_SIZE / 2];
+    float harmonicLevel;            // 성분 에너지 (0.0 ~ 1.0, 포락선을 거친 값)
+    float percussiveLevel;
+    float gainWindowSec;            // gain을 초기화할 때 쓴 창 길이
+    unsigned long long readPosition;    // 링에서 꺼내 STFT에 넣은 샘플 수
+    AudioAnchor anchor;
+    int hasAnchor;
+    unsigned long long frameCount;
+
+    // 에너지 게이트 (조용하거나 일시정지면 FFT / 박자 추적 생략, 막대만 감쇠)
+    std::atomic<float> gateThreshold;   // 윈도우 RMS (선형), 0 = 끔
+    std::atomic<int> paused;            // 재생이 멈춤 (아무 스레드에서 설정)
+    std::atomic<int> gated;             // 마지막 프레임이 게이트에 걸렸는지
+    std::atomic<unsigned long long> gatedFrames;    // FFT를 건너뛴 프레임 수
+    std::atomic<unsigned long long> gateOpenings;   // 닫힘 -> 열림 횟수
+
+    // 출력 (DSP -> UI)
+    SpectrumHistory output;
+    Spectrogram spectrogram;        // 프레임마다 막대 한 행 (켰을 때만)
+    PipelineConsumer* consumers[PIPELINE_MAX_CONSUMERS];    // 상태가 RESERVED -> PENDING일 때 채워짐
+    std::atomic<int> consumerState[PIPELINE_MAX_CONSUMERS];         // 상태 | 세대 << 8
+    std::atomic<int> consumerReaders[PIPELINE_MAX_CONSUMERS];       // ReadSubscription 안의 스레드 수 (있으면 정리를 미룸)
+    PipelineClock clock;            // 없으면 publishTime = 0
+    PipelineFrameCallback onFrame;
+    void* onFrameUser;
+
+    // 프로파일링 (소비자 전용)
+    int profile;
+    PipelineStats stats;
+} AudioPipeline;
+
+// 초기화 / 정리 (ringCapacity = 샘플 링 크기)
+int AudioPipeline_Init(AudioPipeline* p, int sampleRate, long long ticksPerSecond,
+                       int fftSize, int hopSize, int barCount, int barScale,
+                       unsigned int ringCapacity);
+void AudioPipeline_Free(AudioPipeline* p);
+
+// 생산자: 모노 샘플 쓰기 (mono가 NULL이면 무음), timestamp = 첫 샘플의 캡처 시각 (0 = 없음)
+// 반환값 = 링에 들어간 샘플 수 (나머지는 droppedSamples에 집계)
+int AudioPipeline_Write(AudioPipeline* p, const float* mono, int count, long long timestamp);
+
+// 소비자: 링에 쌓인 샘플 처리, 반환값 = 새로 낸 스펙트럼 프레임 수
+int AudioPipeline_Process(AudioPipeline* p);
+
+// 아무 스레드: FFT/홉 크기 변경 요청 (다음 Process에서 적용)
+void AudioPipeline_RequestConfig(AudioPipeline* p, int fftSize, int hopSize);
+
+// 아무 스레드: 막대 수 / 주파수 축 변경 요청 (다음 Process에서 적용)
+void AudioPipeline_RequestBarLayout(AudioPipeline* p, int barCount, int barScale);
+
+// UI: 최신 프레임 읽기 (없으면 0)
+int AudioPipeline_ReadLatest(AudioPipeline* p, SpectrumFrame* out);
+
+// UI: 타임스탬프가 timestamp 이하인 가장 최근 프레임 읽기 (최근 프레임 링 안에서)
+// 모든 프레임이 더 나중이면 가장 오래된 프레임, 타임스탬프가 없으면 최신 프레임
+int AudioPipeline_ReadAt(AudioPipeline* p, long long timestamp, SpectrumFrame* out);
+
+// 아무 스레드: 구독 (반환값 = 핸들, 0 = 자리 없음 / 잘못된 설정)
+// 다음 Process에서 막대 테이블을 만들고 그 뒤 홉부터 발행
+// 해지한 핸들로 읽거나 다시 해지해도 안전 (읽기는 0, 슬롯을 새 구독자가 받았어도 건드리지 않음)
+int AudioPipeline_Subscribe(AudioPipeline* p, const SpectrumSubscription* config);
+void AudioPipeline_Unsubscribe(AudioPipeline* p, int handle);
+
+// 구독자: 자기 출력 슬롯의 최신 프레임 (아직 없으면 0, 막대 테이블을 못 만들었으면 -1: 해지 후 다시 구독)
+int AudioPipeline_ReadSubscription(AudioPipeline* p, int handle, SpectrumFrame* out);
+
+// 아무 스레드: 막대 포락선 (attack / release 시상수, 피크 유지 시간, 피크 낙하 가속도)
+void AudioPipeline_SetEnvelope(AudioPipeline* p, float attackMs, float releaseMs,
+                               float peakHoldMs, float peakGravity);
+
+// 아무 스레드: 이중 해상도 켜기 / 끄기 (저역 막대를 데시메이션 + 작은 FFT로, 다음 Process에서 적용)
+// 메인 FFT를 1024 정도로 줄여도 저역 해상도가 유지됨
+void AudioPipeline_SetDualResolution(AudioPipeline* p, int enable);
+
+// 아무 스레드: 스펙트로그램 기록 (rows = 0이면 끔, 다음 Process에서 적용, 읽기는 Spectrogram_Read)
+void AudioPipeline_SetSpectrogram(AudioPipeline* p, int rows, int barCount);
+
+// 아무 스레드: 화성 / 타악 분리 켜기 / 끄기 (SpectrumFrame.harmonic / percussive, 다음 Process에서 적용)
+// 켜면 박자 추적이 타악 성분만 보므로 지속음이 큰 곡에서도 킥 / 스네어를 따라감
+void AudioPipeline_EnableHpss(AudioPipeline* p, int enable);
+
+// 아무 스레드: 음색 특징 계산 켜기 / 끄기 (SpectrumFrame.features)
+void AudioPipeline_EnableFeatures(AudioPipeline* p, int enable);
+
+// 아무 스레드: 막대별 자동 게인 켜기 / 끄기, 분포를 볼 시간 (초)
+void AudioPipeline_SetAutoGain(AudioPipeline* p, int enabled, float windowSec);
+
+// 아무 스레드: 게이트 임계값 (dBFS, 윈도우 RMS 기준, -200 이하면 끔) / 일시정지 상태
+void AudioPipeline_SetGate(AudioPipeline* p, float thresholdDb);
+void AudioPipeline_SetPaused(AudioPipeline* p, int paused);
+
+// 아무 스레드: 마지막 프레임이 게이트에 걸렸는지 (처리할 오디오 없음)
+int AudioPipeline_IsGated(AudioPipeline* p);
+
+// 소비자 스레드를 시작하기 전에: 프레임 콜백 / 발행 시각 시계 / 단계별 시간 측정
+void AudioPipeline_SetFrameCallback(AudioPipeline* p, PipelineFrameCallback callback, void* user);
+void AudioPipeline_SetClock(AudioPipeline* p, PipelineClock clock);
+void AudioPipeline_EnableProfiling(AudioPipeline* p, int enable);
+
+#endif // AUDIO_PIPELINE_H
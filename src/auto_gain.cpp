@@ -0,0 +1,131 @@
+/*
+ * auto_gain.cpp - Per-Band Auto Gain
+ * 지수 감쇠 히스토그램 + 분위수 커서
+ */
+
+#include "auto_gain.h"
+
+#include <string.h>
+#include <math.h>
+
+#define BUCKET_DB ((AUTO_GAIN_MAX_DB - AUTO_GAIN_MIN_DB) / AUTO_GAIN_BUCKETS)
+#define RENORMALIZE_WEIGHT 1000.0f  // 가중치가 이만큼 커지면 전체를 다시 1 기준으로
+#define WARMUP_SEC 0.5f             // 창이 짧으면 창의 절반 (유효 샘플 수는 창 / 홉을 넘지 못함)
+#define MIN_RANGE_DB 24.0f          // 조용한 구간의 잡음이 전체 범위로 커지지 않게
+#define MIN_CEILING_DB -84.0f       // 거의 비어 있는 대역 (저역 통과된 음원의 고역 등)
+#define MAX_SPREAD_DB 30.0f         // 가장 큰 막대의 꼭대기보다 이만큼 넘게 낮아지지 않게 (스펙트럼 모양 유지)
+
+int AutoGain_Init(AutoGain* ag, int bandCount, float windowSec, float hopSec) {
+    if (!ag || bandCount <= 0 || bandCount > AUTO_GAIN_MAX_BANDS) return 0;
+    if (hopSec <= 0.0f || windowSec <= 0.0f) return 0;
+
+    memset(ag, 0, sizeof(AutoGain));
+    ag->bandCount = bandCount;
+    ag->decay = expf(-hopSec / windowSec);
+    ag->weight = 1.0f;
+    ag->warmup = fminf(WARMUP_SEC, windowSec * 0.5f) / hopSec;
+    ag->loudest = AUTO_GAIN_MIN_DB;
+    return 1;
+}
+
+// 가중치를 1 기준으로 되돌리고 커서의 누적값도 다시 계산 (float 오차가 쌓이지 않게)
+static void Renormalize(AutoGain* ag) {
+    float scale = 1.0f / ag->weight;
+    for (int b = 0; b < ag->bandCount; b++) {
+        float* hist = ag->hist[b];
+        float sum = 0.0f, lowBelow = 0.0f, highBelow = 0.0f;
+        for (int i = 0; i < AUTO_GAIN_BUCKETS; i++) {
+            if (i == ag->low[b].bucket) lowBelow = sum;
+            if (i == ag->high[b].bucket) highBelow = sum;
+            hist[i] *= scale;
+            sum += hist[i];
+        }
+        ag->low[b].below = lowBelow;
+        ag->high[b].below = highBelow;
+    }
+    ag->total *= scale;
+    ag->weight = 1.0f;
+}
+
+// 커서를 분위수 위치로 옮김 (below <= target <= below + hist[bucket])
+static float MoveCursor(QuantileCursor* c, const float* hist, float target) {
+    while (c->bucket > 0 && c->below > target) {
+        c->bucket--;
+        c->below -= hist[c->bucket];
+    }
+    while (c->bucket < AUTO_GAIN_BUCKETS - 1 && c->below + hist[c->bucket] < target) {
+        c->below += hist[c->bucket];
+        c->bucket++;
+    }
+    if (c->below < 0.0f) c->below = 0.0f;
+
+    // 버킷 안에서 선형 보간
+    float count = hist[c->bucket];
+    float frac = count > 0.0f ? (target - c->below) / count : 0.5f;
+    if (frac < 0.0f) frac = 0.0f;
+    if (frac > 1.0f) frac = 1.0f;
+    return AUTO_GAIN_MIN_DB + (c->bucket + frac) * BUCKET_DB;
+}
+
+void AutoGain_Process(AutoGain* ag, const float* db, float* normalized,
+                      float fixedMinDb, float fixedMaxDb) {
+    if (!ag || !db || !normalized) return;
+
+    // 감쇠 = 이전 샘플을 줄이는 대신 새 샘플을 키움
+    ag->weight /= ag->decay;
+    if (ag->weight > RENORMALIZE_WEIGHT) Renormalize(ag);
+    float w = ag->weight;
+    ag->total += w;
+    int warm = ag->total / w >= ag->warmup;
+
+    const float lowTarget = AUTO_GAIN_LOW_QUANTILE * ag->total;
+    const float highTarget = AUTO_GAIN_HIGH_QUANTILE * ag->total;
+    const float minCeiling = fmaxf(MIN_CEILING_DB, ag->loudest - MAX_SPREAD_DB);
+    float loudest = AUTO_GAIN_MIN_DB;
+
+    for (int b = 0; b < ag->bandCount; b++) {
+        float v = db[b];
+        int bucket = (int)((v - AUTO_GAIN_MIN_DB) / BUCKET_DB);
+        if (bucket < 0) bucket = 0;
+        if (bucket >= AUTO_GAIN_BUCKETS) bucket = AUTO_GAIN_BUCKETS - 1;
+
+        float* hist = ag->hist[b];
+        hist[bucket] += w;
+        if (bucket < ag->low[b].bucket) ag->low[b].below += w;
+        if (bucket < ag->high[b].bucket) ag->high[b].below += w;
+
+        float floorDb = MoveCursor(&ag->low[b], hist, lowTarget);
+        float ceilingDb = MoveCursor(&ag->high[b], hist, highTarget);
+        if (ceilingDb > loudest) loudest = ceilingDb;
+
+        if (!warm) {
+            floorDb = fixedMinDb;
+            ceilingDb = fixedMaxDb;
+        } else {
+            if (ceilingDb < minCeiling) ceilingDb = minCeiling;
+            if (ceilingDb - floorDb < MIN_RANGE_DB) floorDb = ceilingDb - MIN_RANGE_DB;
+        }
+
+        float n = (v - floorDb) / (ceilingDb - floorDb);
+        if (n < 0.0f) n = 0.0f;
+        if (n > 1.0f) n = 1.0f;
+        normalized[b] = n;
+    }
+
+    // 다음 홉의 하한에 사용 (한 홉 늦어도 분포는 천천히 변함)
+    ag->loudest = loudest;
+}
+
+void AutoGain_GetRange(const AutoGain* ag, int band, float* floorDb, float* ceilingDb) {
+    if (!ag || band < 0 || band >= ag->bandCount) return;
+
+    const float* hist = ag->hist[band];
+    QuantileCursor low = ag->low[band], high = ag->high[band];
+    float lowDb = MoveCursor(&low, hist, AUTO_GAIN_LOW_QUANTILE * ag->total);
+    float highDb = MoveCursor(&high, hist, AUTO_GAIN_HIGH_QUANTILE * ag->total);
+    highDb = fmaxf(highDb, fmaxf(MIN_CEILING_DB, ag->loudest - MAX_SPREAD_DB));
+    if (highDb - lowDb < MIN_RANGE_DB) lowDb = highDb - MIN_RANGE_DB;
+
+    if (floorDb) *floorDb = lowDb;
+    if (ceilingDb) *ceilingDb = highDb;
+}
@@ -0,0 +1,56 @@
+/*
+ * auto_gain.h - Per-Band Auto Gain (platform-neutral)
+ *
+ * 막대마다 최근 몇 초 동안의 dB 분포를 고정 버킷 히스토그램으로 유지하고
+ * 하위 / 상위 분위수를 0.0 / 1.0에 맞춤 (조용한 마스터도, 큰 마스터도 막대 전체 범위 사용)
+ * 홉당 막대마다 O(1): 감쇠는 전체를 곱하는 대신 새 샘플 가중치를 키우고, 분위수 커서는 몇 칸만 이동
+ */
+
+#ifndef AUTO_GAIN_H
+#define AUTO_GAIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUTO_GAIN_MAX_BANDS 128
+#define AUTO_GAIN_BUCKETS 64
+#define AUTO_GAIN_MIN_DB -120.0f        // 히스토그램 범위 (2dB 버킷)
+#define AUTO_GAIN_MAX_DB 8.0f
+#define AUTO_GAIN_LOW_QUANTILE 0.10f    // 0.0에 맞출 분위수
+#define AUTO_GAIN_HIGH_QUANTILE 0.97f   // 1.0에 맞출 분위수
+
+// 분위수 커서 (분위수가 들어 있는 버킷과 그 아래 가중치 합)
+typedef struct {
+    int bucket;
+    float below;
+} QuantileCursor;
+
+typedef struct {
+    int bandCount;
+    float decay;                    // 홉당 감쇠 (창 길이와 홉 간격에서 계산)
+    float weight;                   // 이번 홉 샘플 가중치 (홉마다 1 / decay배)
+    float total;                    // 막대별 히스토그램 가중치 합 (모든 막대 같음)
+    float warmup;                   // 이 유효 샘플 수 전까지는 고정 범위 사용
+    float loudest;                  // 직전 홉에서 가장 높은 막대 꼭대기 (dB)
+    float hist[AUTO_GAIN_MAX_BANDS][AUTO_GAIN_BUCKETS];
+    QuantileCursor low[AUTO_GAIN_MAX_BANDS];
+    QuantileCursor high[AUTO_GAIN_MAX_BANDS];
+} AutoGain;
+
+// 초기화 (windowSec = 분포를 볼 시간, hopSec = 홉 간격)
+int AutoGain_Init(AutoGain* ag, int bandCount, float windowSec, float hopSec);
+
+// 막대별 dB 값을 분포에 넣고 0.0 ~ 1.0으로 정규화
+// 분포가 쌓이기 전에는 고정 범위 (fixedMinDb ~ fixedMaxDb)
+void AutoGain_Process(AutoGain* ag, const float* db, float* normalized,
+                      float fixedMinDb, float fixedMaxDb);
+
+// 막대별 현재 범위 (dB, 디버그 / 하네스용)
+void AutoGain_GetRange(const AutoGain* ag, int band, float* floorDb, float* ceilingDb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUTO_GAIN_H
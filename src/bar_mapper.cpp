@@ -0,0 +1,182 @@
+/*
+ * bar_mapper.cpp - Spectrum Bin -> Bar Mapping
+ * 막대 경계를 선택한 주파수 축에서 균등하게 나누고, 각 빈이 막대와 겹치는 비율을 가중치로 사용
+ */
+
+#include "bar_mapper.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define DEFAULT_MIN_FREQ 20.0f
+#define DEFAULT_MAX_FREQ 16000.0f
+
+// Hz -> 주파수 축
+static double HzToScale(double hz, int scale) {
+    switch (scale) {
+        case BAR_SCALE_OCTAVE:
+        case BAR_SCALE_CQT:    return log2(hz);
+        case BAR_SCALE_MEL:    return 2595.0 * log10(1.0 + hz / 700.0);
+        case BAR_SCALE_BARK:   return 26.81 * hz / (1960.0 + hz) - 0.53;  // Traunmüller
+        default:               return hz;
+    }
+}
+
+// 주파수 축 -> Hz
+static double ScaleToHz(double v, int scale) {
+    switch (scale) {
+        case BAR_SCALE_OCTAVE:
+        case BAR_SCALE_CQT:    return pow(2.0, v);
+        case BAR_SCALE_MEL:    return 700.0 * (pow(10.0, v / 2595.0) - 1.0);
+        case BAR_SCALE_BARK: {
+            double z = v + 0.53;
+            return 1960.0 * z / (26.81 - z);
+        }
+        default:               return v;
+    }
+}
+
+int BarMapper_Init(BarMapper* mapper, int barCount, int scale, int fftSize, int sampleRate,
+                   float minFreq, float maxFreq) {
+    if (!mapper || barCount <= 0 || fftSize <= 0 || sampleRate <= 0) return 0;
+
+    memset(mapper, 0, sizeof(BarMapper));
+    mapper->barCount = barCount;
+    mapper->scale = scale;
+    mapper->fftSize = fftSize;
+    mapper->sampleRate = sampleRate;
+
+    int numBins = fftSize / 2;
+    float nyquist = sampleRate * 0.5f;
+    if (minFreq <= 0.0f) minFreq = DEFAULT_MIN_FREQ;
+    if (maxFreq <= 0.0f) maxFreq = (DEFAULT_MAX_FREQ < nyquist) ? DEFAULT_MAX_FREQ : nyquist;
+    if (minFreq >= maxFreq) minFreq = maxFreq * 0.5f;
+    mapper->minFreq = minFreq;
+    mapper->maxFreq = maxFreq;
+
+    // 막대마다 겹치는 빈 수는 (막대 폭 + 2)를 넘지 않으므로 넉넉하게 잡음
+    int capacity = numBins + barCount * 2;
+    mapper->offsets = (int*)malloc(sizeof(int) * (barCount + 1));
+    mapper->bins = (unsigned short*)malloc(sizeof(unsigned short) * capacity);
+    mapper->weights = (float*)malloc(sizeof(float) * capacity);
+    if (!mapper->offsets || !mapper->bins || !mapper->weights) {
+        BarMapper_Free(mapper);
+        return 0;
+    }
+
+    int nnz = 0;
+
+    if (scale == BAR_SCALE_LINEAR) {
+        // 기존 GroupIntoBars와 동일: DC부터 같은 개수씩 평균
+        int binsPerBar = numBins / barCount;
+        if (binsPerBar < 1) binsPerBar = 1;
+
+        for (int i = 0; i < barCount; i++) {
+            mapper->offsets[i] = nnz;
+            int start = i * binsPerBar;
+            int end = start + binsPerBar;
+            if (end > numBins) end = numBins;
+            for (int k = start; k < end; k++) {
+                mapper->bins[nnz] = (unsigned short)k;
+                mapper->weights[nnz] = 1.0f / binsPerBar;
+                nnz++;
+            }
+        }
+        mapper->offsets[barCount] = nnz;
+        mapper->nonZero = nnz;
+        return 1;
+    }
+
+    double binHz = (double)sampleRate / fftSize;
+    double lowScale = HzToScale(minFreq, scale);
+    double highScale = HzToScale(maxFreq, scale);
+
+    for (int i = 0; i < barCount; i++) {
+        mapper->offsets[i] = nnz;
+
+        // 막대 경계 (빈 단위, 빈 k는 [k-0.5, k+0.5) 구간을 덮음)
+        double lo = ScaleToHz(lowScale + (highScale - lowScale) * i / barCount, scale) / binHz;
+        double hi = ScaleToHz(lowScale + (highScale - lowScale) * (i + 1) / barCount, scale) / binHz;
+
+        int first = (int)floor(lo + 0.5);
+        int last = (int)ceil(hi - 0.5);
+        if (first < 1) first = 1;           // DC 제외
+        if (last > numBins - 1) last = numBins - 1;
+
+        double total = 0.0;
+        int start = nnz;
+        for (int k = first; k <= last && nnz < capacity; k++) {
+            double overlap = fmin(hi, k + 0.5) - fmax(lo, k - 0.5);
+            if (overlap <= 0.0) continue;
+            mapper->bins[nnz] = (unsigned short)k;
+            mapper->weights[nnz] = (float)overlap;
+            total += overlap;
+            nnz++;
+        }
+
+        // 빈 하나보다 좁은 막대: 중심이 속한 빈 하나를 그대로 사용
+        if (nnz == start) {
+            int k = (int)floor((lo + hi) * 0.5 + 0.5);
+            if (k < 1) k = 1;
+            if (k > numBins - 1) k = numBins - 1;
+            mapper->bins[nnz] = (unsigned short)k;
+            mapper->weights[nnz] = 1.0f;
+            total = 1.0;
+            nnz++;
+        }
+
+        // 막대 값 = 겹치는 빈들의 가중 평균
+        for (int j = start; j < nnz; j++) {
+            mapper->weights[j] = (float)(mapper->weights[j] / total);
+        }
+    }
+    mapper->offsets[barCount] = nnz;
+    mapper->nonZero = nnz;
+    return 1;
+}
+
+void BarMapper_Free(BarMapper* mapper) {
+    if (!mapper) return;
+    free(mapper->offsets);
+    free(mapper->bins);
+    free(mapper->weights);
+    memset(mapper, 0, sizeof(BarMapper));
+}
+
+void BarMapper_Apply(const BarMapper* mapper, const float* magnitudes, float* bands) {
+    if (!mapper) return;
+    BarMapper_ApplyRange(mapper, magnitudes, bands, 0, mapper->barCount);
+}
+
+void BarMapper_ApplyRange(const BarMapper* mapper, const float* magnitudes, float* bands,
+                          int firstBar, int endBar) {
+    if (!mapper || !mapper->offsets) return;
+    if (firstBar < 0) firstBar = 0;
+    if (endBar > mapper->barCount) endBar = mapper->barCount;
+
+    const unsigned short* bins = mapper->bins;
+    const float* weights = mapper->weights;
+
+    for (int i = firstBar; i < endBar; i++) {
+        float sum = 0.0f;
+        int end = mapper->offsets[i + 1];
+        for (int j = mapper->offsets[i]; j < end; j++) {
+            sum += weights[j] * magnitudes[bins[j]];
+        }
+        bands[i] = sum;
+    }
+}
+
+int BarMapper_CountBarsBelow(const BarMapper* mapper, float hz) {
+    if (!mapper || !mapper->offsets) return 0;
+
+    double binHz = (double)mapper->sampleRate / mapper->fftSize;
+    int count = 0;
+    for (int i = 0; i < mapper->barCount; i++) {
+        int last = mapper->offsets[i + 1] - 1;
+        if (last < mapper->offsets[i] || (mapper->bins[last] + 0.5) * binHz > hz) break;
+        count++;
+    }
+    return count;
+}
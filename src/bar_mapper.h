@@ -0,0 +1,55 @@
+/*
+ * bar_mapper.h - Spectrum Bin -> Bar Mapping (platform-neutral)
+ */
+
+#ifndef BAR_MAPPER_H
+#define BAR_MAPPER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 막대 주파수 축
+typedef enum {
+    BAR_SCALE_LINEAR = 0,   // 같은 폭 (기존 방식)
+    BAR_SCALE_OCTAVE,       // 로그 (옥타브 균등)
+    BAR_SCALE_MEL,
+    BAR_SCALE_BARK,
+    BAR_SCALE_CQT           // 상수 Q (옥타브 단위로 정렬된 음 간격 빈, 막대 테이블은 옥타브 축 근사)
+} BarScale;
+
+// 막대별 빈 가중치 테이블 (CSR 희소 행렬, 초기화 때 한 번만 계산)
+typedef struct {
+    int barCount;
+    int scale;
+    int fftSize;
+    int sampleRate;
+    float minFreq;          // 실제로 사용한 막대 범위 (Hz)
+    float maxFreq;
+    int* offsets;           // [barCount + 1] 막대 i의 항목 = offsets[i] ~ offsets[i+1]-1
+    unsigned short* bins;   // [nonZero] 빈 인덱스
+    float* weights;         // [nonZero] 가중치 (막대마다 합 = 1)
+    int nonZero;
+} BarMapper;
+
+// 초기화 / 정리 (minFreq/maxFreq가 0이면 20Hz ~ min(16kHz, 나이퀴스트))
+// maxFreq를 직접 주면 나이퀴스트보다 높아도 막대 경계는 그대로 (넘는 막대는 마지막 빈 사용)
+int BarMapper_Init(BarMapper* mapper, int barCount, int scale, int fftSize, int sampleRate,
+                   float minFreq, float maxFreq);
+void BarMapper_Free(BarMapper* mapper);
+
+// 희소 행렬-벡터 곱: bands[i] = sum(weights * magnitudes[bins])
+void BarMapper_Apply(const BarMapper* mapper, const float* magnitudes, float* bands);
+
+// 막대 firstBar ~ endBar-1만 계산 (두 스펙트럼에서 나눠 가져올 때)
+void BarMapper_ApplyRange(const BarMapper* mapper, const float* magnitudes, float* bands,
+                          int firstBar, int endBar);
+
+// 앞쪽부터 모든 빈이 hz 아래에 있는 막대 수
+int BarMapper_CountBarsBelow(const BarMapper* mapper, float hz);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BAR_MAPPER_H
@@ -0,0 +1,314 @@
+/*
+ * beat_tracker.cpp - Streaming Onset / Beat Tracker
+ */
+
+#include "beat_tracker.h"
+#include "dsp_kernels.h"
+
+#include <string.h>
+#include <math.h>
+
+#define FLUX_COMPRESSION 100.0f     // log(1 + C * |X|) 압축 계수
+#define FLUX_LOW_BAND_HZ 250.0f     // 저음 대역 (킥, 스네어 몸통) 플럭스를 따로 더하는 상한
+#define ONSET_THRESHOLD_K 1.5f      // 임계값 = 평균 + K * 표준편차
+#define ONSET_MIN_GAP_SEC 0.1f
+#define ACF_TIME_CONSTANT_SEC 6.0f
+#define TEMPO_PRIOR_BPM 120.0f
+#define TEMPO_PRIOR_OCTAVES 0.8f
+#define TEMPO_HALF_RATIO 0.9f       // 절반 / 2배 간격의 상관이 이 비율 안으로 고르면 빠른 쪽을 박자로
+#define TEMPO_SMOOTHING 0.05f
+#define TEMPO_JUMP_RATIO 0.15f      // 이보다 크게 다르면 스무딩 대신 대기 후 교체
+#define TEMPO_JUMP_SEC 1.0f
+#define PHASE_TIME_CONSTANT_SEC 3.0f
+
+int BeatTracker_Init(BeatTracker* bt, int sampleRate, int hopSize) {
+    if (!bt || sampleRate <= 0 || hopSize <= 0) return 0;
+
+    memset(bt, 0, sizeof(BeatTracker));
+
+    bt->sampleRate = sampleRate;
+    bt->hopRate = (float)sampleRate / hopSize;
+    bt->decimation = (int)ceilf(bt->hopRate / BEAT_ENVELOPE_RATE);
+    if (bt->decimation < 1) bt->decimation = 1;
+    bt->envelopeRate = bt->hopRate / bt->decimation;
+
+    bt->minLag = (int)floorf(bt->envelopeRate * 60.0f / BEAT_MAX_BPM);
+    bt->maxLag = (int)ceilf(bt->envelopeRate * 60.0f / BEAT_MIN_BPM);
+    if (bt->minLag < 1) bt->minLag = 1;
+    if (bt->maxLag > BEAT_MAX_LAG) bt->maxLag = BEAT_MAX_LAG;
+    if (bt->maxLag <= bt->minLag) bt->maxLag = bt->minLag + 1;
+
+    bt->acfDecay = expf(-1.0f / (ACF_TIME_CONSTANT_SEC * bt->envelopeRate));
+    bt->phaseDecay = expf(-1.0f / (PHASE_TIME_CONSTANT_SEC * bt->envelopeRate));
+
+    for (int i = bt->minLag * BEAT_LAG_STEPS; i <= bt->maxLag * BEAT_LAG_STEPS; i++) {
+        float bpm = 60.0f * bt->envelopeRate * BEAT_LAG_STEPS / i;
+        float octaves = log2f(bpm / TEMPO_PRIOR_BPM) / TEMPO_PRIOR_OCTAVES;
+        bt->prior[i] = expf(-0.5f * octaves * octaves);
+    }
+    return 1;
+}
+
+void BeatTracker_Reset(BeatTracker* bt) {
+    if (!bt) return;
+
+    // 포락선 속도와 템포 선호도 테이블은 유지
+    bt->decimCount = 0;
+    bt->pooledFlux = 0.0f;
+    bt->hasPrev = 0;
+    memset(bt->fluxHistory, 0, sizeof(bt->fluxHistory));
+    bt->fluxPos = 0;
+    bt->fluxCount = 0;
+    bt->fluxSum = 0.0f;
+    bt->fluxSqSum = 0.0f;
+    bt->prevStrength[0] = bt->prevStrength[1] = 0.0f;
+    bt->prevThreshold = 0.0f;
+    bt->framesSinceOnset = 0;
+    memset(bt->onsetHistory, 0, sizeof(bt->onsetHistory));
+    bt->onsetPos = 0;
+    memset(bt->acf, 0, sizeof(bt->acf));
+    bt->period = 0.0f;
+    bt->tempoHold = 0;
+    bt->cyclePos = 0.0f;
+    memset(bt->phaseHist, 0, sizeof(bt->phaseHist));
+    bt->phase = 0.0f;
+    bt->confidence = 0.0f;
+    bt->onset = 0;
+    bt->beatCount = 0;
+}
+
+// 소수 지연의 자기상관 (이웃한 두 정수 지연 사이 선형 보간)
+static float AcfAt(const BeatTracker* bt, float lag) {
+    int i = (int)lag;
+    float frac = lag - i;
+    return bt->acf[i] + frac * (bt->acf[i + 1] - bt->acf[i]);
+}
+
+// 감쇠 자기상관에서 템포 추정 (간격 T와 2T를 함께 봐서 8분음표 펄스를 박자로 잡지 않게)
+// 후보 간격은 1 / BEAT_LAG_STEPS 지연 단위: 홉 512 / 48kHz에서 150 BPM은 37.5 지연이라
+// 정수 지연만 보면 정확히 75 지연에 떨어지는 절반 템포가 이김
+static void UpdateTempo(BeatTracker* bt) {
+    int best = 0;
+    float bestScore = 0.0f;
+    float mean = 0.0f;
+
+    for (int lag = bt->minLag; lag <= bt->maxLag; lag++) mean += bt->acf[lag];
+    mean /= (bt->maxLag - bt->minLag + 1);
+
+    for (int i = bt->minLag * BEAT_LAG_STEPS; i <= bt->maxLag * BEAT_LAG_STEPS; i++) {
+        float period = (float)i / BEAT_LAG_STEPS;
+        float score = (AcfAt(bt, period) + 0.5f * AcfAt(bt, 2.0f * period)) * bt->prior[i];
+        if (score > bestScore) {
+            bestScore = score;
+            best = i;
+        }
+    }
+
+    if (best == 0 || bt->acf[0] <= mean) return;
+
+    // 선호도가 120 BPM 중심이라 170 BPM 이상은 T와 2T 상관이 비슷하면 절반 템포가 이김:
+    // 절반 간격, 간격, 2배 간격의 상관이 고르면 (박자마다 같은 온셋) 빠른 쪽으로, 가까운 상관 꼭대기까지 올라감
+    // (2배 간격이 훨씬 강하면 간격 자체가 이미 마디 안의 쪼갬이므로 그대로)
+    const int lo = bt->minLag * BEAT_LAG_STEPS, hi = bt->maxLag * BEAT_LAG_STEPS;
+    float atBest = AcfAt(bt, (float)best / BEAT_LAG_STEPS);
+    if (best >= 2 * lo &&
+        AcfAt(bt, 0.5f * best / BEAT_LAG_STEPS) >= TEMPO_HALF_RATIO * atBest &&
+        atBest >= TEMPO_HALF_RATIO * AcfAt(bt, 2.0f * best / BEAT_LAG_STEPS)) {
+        best = (best + 1) / 2;
+        for (;;) {
+            float here = AcfAt(bt, (float)best / BEAT_LAG_STEPS);
+            if (best > lo && AcfAt(bt, (float)(best - 1) / BEAT_LAG_STEPS) > here) best--;
+            else if (best < hi && AcfAt(bt, (float)(best + 1) / BEAT_LAG_STEPS) > here) best++;
+            else break;
+        }
+    }
+
+    // 보간한 상관은 정수 지연에서 꺾이므로 가까운 정수 지연의 이웃 셋으로 포물선 보간
+    float lag = (float)best / BEAT_LAG_STEPS;
+    int center = (int)(lag + 0.5f);
+    if (center > bt->minLag && center < bt->maxLag) {
+        float a = bt->acf[center - 1], b = bt->acf[center], c = bt->acf[center + 1];
+        float denom = a - 2.0f * b + c;
+        // 점수 최대가 상관의 꼭대기가 아닐 수 있으므로 꼭대기일 때만
+        if (b >= a && b >= c && denom < 0.0f) lag = center + 0.5f * (a - c) / denom;
+    }
+
+    float conf = (AcfAt(bt, (float)best / BEAT_LAG_STEPS) - mean) / (bt->acf[0] - mean);
+    if (conf < 0.0f) conf = 0.0f;
+    if (conf > 1.0f) conf = 1.0f;
+    bt->confidence += TEMPO_SMOOTHING * (conf - bt->confidence);
+
+    if (bt->period == 0.0f) {
+        bt->period = lag;
+        return;
+    }
+
+    if (fabsf(lag / bt->period - 1.0f) < TEMPO_JUMP_RATIO) {
+        bt->period += TEMPO_SMOOTHING * (lag - bt->period);
+        bt->tempoHold = 0;
+    } else if (++bt->tempoHold >= (int)(TEMPO_JUMP_SEC * bt->envelopeRate)) {
+        bt->period = lag;
+        bt->tempoHold = 0;
+    }
+}
+
+// 주기 위치 진행 + 위상 히스토그램에 온셋 세기 누적 -> 가장 강한 위치를 박자로
+static void UpdatePhase(BeatTracker* bt, float strength) {
+    bt->cyclePos += 1.0f / bt->period;
+    bt->cyclePos -= floorf(bt->cyclePos);
+
+    // 이웃한 두 칸에 선형 분배
+    float pos = bt->cyclePos * BEAT_PHASE_BINS;
+    int bin = (int)pos;
+    float frac = pos - bin;
+    for (int i = 0; i < BEAT_PHASE_BINS; i++) {
+        bt->phaseHist[i] *= bt->phaseDecay;
+    }
+    bt->phaseHist[bin % BEAT_PHASE_BINS] += strength * (1.0f - frac);
+    bt->phaseHist[(bin + 1) % BEAT_PHASE_BINS] += strength * frac;
+
+    int best = 0;
+    for (int i = 1; i < BEAT_PHASE_BINS; i++) {
+        if (bt->phaseHist[i] > bt->phaseHist[best]) best = i;
+    }
+
+    // 원형 포물선 보간
+    float a = bt->phaseHist[(best + BEAT_PHASE_BINS - 1) % BEAT_PHASE_BINS];
+    float b = bt->phaseHist[best];
+    float c = bt->phaseHist[(best + 1) % BEAT_PHASE_BINS];
+    float denom = a - 2.0f * b + c;
+    float peak = (float)best;
+    if (denom < 0.0f) peak += 0.5f * (a - c) / denom;
+
+    float phase = bt->cyclePos - peak / BEAT_PHASE_BINS;
+    phase -= floorf(phase);
+
+    // 위상이 한 바퀴 돌면 박자 하나 (박자 위치가 옮겨가며 생기는 작은 역행은 무시)
+    if (phase < bt->phase - 0.5f) bt->beatCount++;
+    bt->phase = phase;
+}
+
+// 포락선 프레임 하나 처리
+static void ProcessEnvelope(BeatTracker* bt, float flux) {
+    float mean = 0.0f, stddev = 0.0f;
+    if (bt->fluxCount > 0) {
+        mean = bt->fluxSum / bt->fluxCount;
+        float var = bt->fluxSqSum / bt->fluxCount - mean * mean;
+        stddev = var > 0.0f ? sqrtf(var) : 0.0f;
+    }
+
+    float strength = flux - mean;
+    if (strength < 0.0f) strength = 0.0f;
+
+    // 한 프레임 전이 임계값을 넘는 극대면 온셋
+    float s1 = bt->prevStrength[0];
+    float s2 = bt->prevStrength[1];
+    int minGap = (int)(ONSET_MIN_GAP_SEC * bt->envelopeRate);
+    bt->onset = (s1 > bt->prevThreshold && s1 >= bt->prevStrength[1] && s1 > strength &&
+                 bt->framesSinceOnset >= minGap);
+    bt->framesSinceOnset = bt->onset ? 1 : bt->framesSinceOnset + 1;
+
+    bt->prevStrength[1] = s1;
+    bt->prevStrength[0] = strength;
+    bt->prevThreshold = ONSET_THRESHOLD_K * stddev;
+
+    // 임계값 창 갱신 (이번 값은 다음 프레임부터 반영)
+    float old = bt->fluxHistory[bt->fluxPos];
+    if (bt->fluxCount == BEAT_THRESHOLD_LEN) {
+        bt->fluxSum -= old;
+        bt->fluxSqSum -= old * old;
+    } else {
+        bt->fluxCount++;
+    }
+    bt->fluxHistory[bt->fluxPos] = flux;
+    bt->fluxSum += flux;
+    bt->fluxSqSum += flux * flux;
+    bt->fluxPos = (bt->fluxPos + 1) % BEAT_THRESHOLD_LEN;
+    if (bt->fluxSum < 0.0f) bt->fluxSum = 0.0f;
+    if (bt->fluxSqSum < 0.0f) bt->fluxSqSum = 0.0f;
+
+    // 자기상관은 [1 2 1] / 4로 펼친 세기로 (한 프레임 늦음): 온셋이 프레임 단위로 반올림돼도
+    // 소수 간격의 상관이 이웃 지연에 고르게 남아 보간이 의미 있음
+    float smoothed = 0.25f * s2 + 0.5f * s1 + 0.25f * strength;
+    const int size = BEAT_ACF_LEN;
+    bt->onsetPos = (bt->onsetPos + 1) % size;
+    bt->onsetHistory[bt->onsetPos] = smoothed;
+
+    // 자기상관 누적 (지연 범위와 그 2배 + 보간용 한 칸까지만)
+    float decay = bt->acfDecay;
+    bt->acf[0] = bt->acf[0] * decay + smoothed * smoothed;
+    for (int lag = bt->minLag; lag <= 2 * bt->maxLag + 1; lag++) {
+        int idx = bt->onsetPos - lag;
+        if (idx < 0) idx += size;
+        bt->acf[lag] = bt->acf[lag] * decay + smoothed * bt->onsetHistory[idx];
+    }
+
+    UpdateTempo(bt);
+    if (bt->period == 0.0f) return;
+
+    UpdatePhase(bt, strength);
+}
+
+// 홉이 잦으면 여러 홉의 최대값을 포락선 프레임 하나로
+static void PoolFlux(BeatTracker* bt, float flux) {
+    if (flux > bt->pooledFlux) bt->pooledFlux = flux;
+    if (++bt->decimCount < bt->decimation) return;
+
+    ProcessEnvelope(bt, bt->pooledFlux);
+    bt->decimCount = 0;
+    bt->pooledFlux = 0.0f;
+}
+
+void BeatTracker_Process(BeatTracker* bt, const float* magnitudes, int numBins) {
+    if (!bt || !magnitudes || numBins <= 0) return;
+
+    if (numBins > BEAT_MAX_BINS) numBins = BEAT_MAX_BINS;
+    if (numBins != bt->numBins) {
+        bt->numBins = numBins;
+        bt->hasPrev = 0;
+        // 빈 간격 = 샘플레이트 / FFT 크기 (= 2 * 빈 수)
+        bt->lowBins = (int)(FLUX_LOW_BAND_HZ * 2.0f * numBins / bt->sampleRate) + 1;
+        if (bt->lowBins > numBins) bt->lowBins = numBins;
+    }
+
+    // 로그 압축: 20 * log10(1 + C * |X|) (SIMD 커널)
+    float* cur = bt->logMag[bt->current];
+    const float* prev = bt->logMag[bt->current ^ 1];
+    for (int k = 0; k < numBins; k++) {
+        cur[k] = 1.0f + FLUX_COMPRESSION * magnitudes[k];
+    }
+    DspKernels_Get()->toDecibels(cur, cur, numBins, 1.0f);
+
+    // 전체 평균 + 저음 대역 평균: 넓은 대역에 퍼진 하이햇이 전체 평균을 차지해도 킥이 같은 무게로 남음
+    float flux = 0.0f;
+    if (bt->hasPrev) {
+        float low = 0.0f, all = 0.0f;
+        for (int k = 0; k < numBins; k++) {
+            float d = cur[k] - prev[k];
+            if (d > 0.0f) all += d;
+            if (k + 1 == bt->lowBins) low = all;
+        }
+        flux = all / numBins + low / bt->lowBins;
+    }
+    bt->current ^= 1;
+    bt->hasPrev = 1;
+
+    PoolFlux(bt, flux);
+}
+
+void BeatTracker_ProcessSilence(BeatTracker* bt) {
+    if (!bt) return;
+
+    // 플럭스 = 0, 기준 스펙트럼은 게이트 직전 것을 유지
+    PoolFlux(bt, 0.0f);
+}
+
+void BeatTracker_GetState(const BeatTracker* bt, BeatState* state) {
+    if (!bt || !state) return;
+
+    state->phase = bt->phase;
+    state->bpm = bt->period > 0.0f ? 60.0f * bt->envelopeRate / bt->period : 0.0f;
+    state->confidence = bt->confidence;
+    state->onset = bt->onset;
+    state->beatCount = bt->beatCount;
+}
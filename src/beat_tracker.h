@@ -0,0 +1,98 @@
+/*
+ * beat_tracker.h - Streaming Onset / Beat Tracker (platform-neutral)
+ *
+ * FFT 크기 스펙트럼(막대용으로 이미 계산한 것)을 홉마다 받아서
+ * 스펙트럴 플럭스 -> 적응형 임계값 온셋 -> 자기상관 템포 -> 위상 추적
+ * 홉당 O(빈 수 + 지연 수), 메모리는 구조체 크기로 고정
+ */
+
+#ifndef BEAT_TRACKER_H
+#define BEAT_TRACKER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BEAT_MAX_BINS 4096          // FFT_MAX_SIZE / 2
+#define BEAT_ENVELOPE_RATE 200      // 온셋 포락선 최대 속도 (Hz, 홉이 더 잦으면 묶어서 처리)
+#define BEAT_MIN_BPM 60
+#define BEAT_MAX_BPM 200
+#define BEAT_MAX_LAG (BEAT_ENVELOPE_RATE * 60 / BEAT_MIN_BPM)
+#define BEAT_ACF_LEN (2 * BEAT_MAX_LAG + 2)    // 템포 점수에 2배 지연 (+ 보간용 한 칸)까지 사용
+#define BEAT_LAG_STEPS 4            // 템포 후보 간격 (지연 1 / BEAT_LAG_STEPS 단위)
+#define BEAT_THRESHOLD_LEN 64       // 적응형 임계값 창 (포락선 프레임)
+#define BEAT_PHASE_BINS 32          // 박자 한 주기를 나눈 위상 히스토그램 칸 수
+
+// 박자 상태 (UI에 전달)
+typedef struct {
+    float phase;                    // 0.0 ~ 1.0 (0 = 박자 위치)
+    float bpm;                      // 0 = 아직 모름
+    float confidence;               // 0.0 ~ 1.0
+    int onset;                      // 이번 프레임에서 온셋 감지
+    unsigned long long beatCount;   // 지나간 박자 수
+} BeatState;
+
+typedef struct {
+    // 포락선 속도
+    int sampleRate;
+    float hopRate;                  // 초당 홉 수
+    float envelopeRate;             // 초당 포락선 프레임 수
+    int decimation;                 // 포락선 프레임당 홉 수
+    int decimCount;
+    float pooledFlux;
+
+    // 스펙트럴 플럭스 (로그 압축 크기의 양의 차이 평균, 전체 + 저음 대역)
+    int numBins;
+    int lowBins;                    // 저음 대역 빈 수 (FLUX_LOW_BAND_HZ 아래)
+    int current;                    // logMag 중 이번 홉 버퍼
+    int hasPrev;
+    float logMag[2][BEAT_MAX_BINS];
+
+    // 적응형 임계값 (최근 플럭스 평균 + 표준편차)
+    float fluxHistory[BEAT_THRESHOLD_LEN];
+    int fluxPos;
+    int fluxCount;
+    float fluxSum;
+    float fluxSqSum;
+    float prevStrength[2];          // 피크 판정용 (1, 2 프레임 전)
+    float prevThreshold;
+    int framesSinceOnset;
+
+    // 템포 (온셋 세기의 감쇠 자기상관)
+    float onsetHistory[BEAT_ACF_LEN];
+    int onsetPos;
+    float acf[BEAT_ACF_LEN];
+    int minLag;
+    int maxLag;
+    float acfDecay;
+    float prior[BEAT_MAX_LAG * BEAT_LAG_STEPS + 1];    // 120 BPM 중심 템포 선호도 (두 배/절반 오류 방지, 후보 간격별)
+
+    // 위상 추적 (주기 안 위치별 온셋 세기 히스토그램의 최대 칸 = 박자 위치)
+    float period;                   // 포락선 프레임 단위 박자 간격 (0 = 모름)
+    int tempoHold;                  // 크게 다른 템포 후보가 이어진 프레임 수
+    float cyclePos;                 // 0.0 ~ 1.0, 주기마다 일정하게 진행
+    float phaseHist[BEAT_PHASE_BINS];
+    float phaseDecay;
+    float phase;                    // cyclePos - 박자 위치
+    float confidence;
+    int onset;
+    unsigned long long beatCount;
+} BeatTracker;
+
+// 초기화 (샘플레이트 / 홉이 바뀌면 다시 호출)
+int BeatTracker_Init(BeatTracker* bt, int sampleRate, int hopSize);
+void BeatTracker_Reset(BeatTracker* bt);
+
+// 홉마다 FFT 크기 스펙트럼 (numBins개) 입력
+void BeatTracker_Process(BeatTracker* bt, const float* magnitudes, int numBins);
+
+// 무음 게이트에 걸린 홉 (플럭스 0으로 시간축 유지, 다음 플럭스는 게이트 직전 스펙트럼 기준)
+void BeatTracker_ProcessSilence(BeatTracker* bt);
+
+void BeatTracker_GetState(const BeatTracker* bt, BeatState* state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BEAT_TRACKER_H
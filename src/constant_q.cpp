@@ -0,0 +1,226 @@
+/*
+ * constant_q.cpp - Constant-Q Spectrum
+ * 빈마다 해닝 창을 씌운 복소 사인파(시간 커널)를 FFT해서 스펙트럴 커널을 만들고 작은 값은 버림
+ * 시간 커널은 프레임 끝에 맞춰서 모든 빈이 가장 최근 샘플을 봄 (고역일수록 창이 짧아 반응이 빠름)
+ */
+
+#include "constant_q.h"
+#include "fft.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <mutex>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static std::mutex g_cacheLock;
+static ConstantQKernel* g_cache[CQT_CACHE_SIZE];
+static unsigned long long g_useClock = 0;
+
+static void FreeKernel(ConstantQKernel* k) {
+    if (!k) return;
+    free(k->offsets);
+    free(k->bins);
+    free(k->weights);
+    free(k);
+}
+
+float ConstantQ_BinFrequency(const ConstantQKernel* kernel, int bin) {
+    if (!kernel) return 0.0f;
+    return kernel->minFreq * powf(2.0f, (float)bin / kernel->binsPerOctave);
+}
+
+static ConstantQKernel* BuildKernel(int sampleRate, int fftSize, int binsPerOctave,
+                                    int binCount, float minFreq) {
+    ConstantQKernel* k = (ConstantQKernel*)calloc(1, sizeof(ConstantQKernel));
+    FFTContext fft;
+    memset(&fft, 0, sizeof(fft));
+    float* re = (float*)malloc(sizeof(float) * fftSize);
+    float* im = (float*)malloc(sizeof(float) * fftSize);
+    int half = fftSize / 2;
+    int capacity = half * 4;    // 보통 훨씬 적음 (넘으면 늘림)
+
+    if (k) {
+        k->offsets = (int*)malloc(sizeof(int) * (binCount + 1));
+        k->bins = (unsigned short*)malloc(sizeof(unsigned short) * capacity);
+        k->weights = (float*)malloc(sizeof(float) * 2 * capacity);
+    }
+    if (!k || !re || !im || !k->offsets || !k->bins || !k->weights ||
+        !FFT_Init(&fft, fftSize, FFT_WINDOW_RECT)) {
+        FreeKernel(k);
+        free(re);
+        free(im);
+        FFT_Free(&fft);
+        return NULL;
+    }
+
+    k->sampleRate = sampleRate;
+    k->fftSize = fftSize;
+    k->binsPerOctave = binsPerOctave;
+    k->binCount = binCount;
+    k->minFreq = minFreq;
+    k->fullQ = binCount;
+
+    const double q = 1.0 / (pow(2.0, 1.0 / binsPerOctave) - 1.0);
+    const float invN = 1.0f / fftSize;
+    int nnz = 0;
+
+    for (int b = 0; b < binCount; b++) {
+        k->offsets[b] = nnz;
+
+        double freq = minFreq * pow(2.0, (double)b / binsPerOctave);
+        if (freq >= sampleRate * 0.5) continue;     // 나이퀴스트 위: 빈 행 (값 0)
+
+        // 창 길이 = Q 주기, FFT 크기를 넘으면 잘라서 Q가 줄어듦
+        int length = (int)ceil(q * sampleRate / freq);
+        if (length > fftSize) length = fftSize;
+        else if (k->fullQ == binCount) k->fullQ = b;
+
+        // 시간 커널: 해닝 창 / 창 합 * e^(i 2pi f t), 프레임 끝에 맞춤
+        memset(re, 0, sizeof(float) * fftSize);
+        memset(im, 0, sizeof(float) * fftSize);
+        // 창과 위상은 복소 회전으로 누적 (빈마다 삼각함수 수천 번은 느림)
+        // 창 합 = length / 2 (반 칸 밀린 해닝은 cos 합이 0)
+        int start = fftSize - length;
+        double scale = 2.0 / length;
+        double stepRe = cos(2.0 * M_PI * freq / sampleRate), stepIm = sin(2.0 * M_PI * freq / sampleRate);
+        double rotRe = 1.0, rotIm = 0.0;
+        double winStepRe = cos(2.0 * M_PI / length), winStepIm = sin(2.0 * M_PI / length);
+        double winRe = cos(M_PI / length), winIm = sin(M_PI / length);
+        for (int n = 0; n < length; n++) {
+            double w = (0.5 - 0.5 * winRe) * scale;
+            re[start + n] = (float)(w * rotRe);
+            im[start + n] = (float)(w * rotIm);
+
+            double t = rotRe * stepRe - rotIm * stepIm;
+            rotIm = rotRe * stepIm + rotIm * stepRe;
+            rotRe = t;
+            t = winRe * winStepRe - winIm * winStepIm;
+            winIm = winRe * winStepIm + winIm * winStepRe;
+            winRe = t;
+        }
+
+        // K = FFT(re) + i * FFT(im) (두 번의 실수 FFT, 양의 주파수만)
+        FFT_RealForward(&fft, re);
+        FFT_RealForward(&fft, im);
+
+        float rowMax = 0.0f;
+        for (int j = 1; j < half; j++) {
+            float kr = re[2 * j] - im[2 * j + 1];
+            float ki = re[2 * j + 1] + im[2 * j];
+            float mag = sqrtf(kr * kr + ki * ki);
+            if (mag > rowMax) rowMax = mag;
+        }
+
+        float threshold = rowMax * CQT_KERNEL_THRESHOLD;
+        for (int j = 1; j < half; j++) {
+            float kr = re[2 * j] - im[2 * j + 1];
+            float ki = re[2 * j + 1] + im[2 * j];
+            if (sqrtf(kr * kr + ki * ki) < threshold) continue;
+
+            if (nnz == capacity) {
+                capacity *= 2;
+                unsigned short* bins = (unsigned short*)realloc(k->bins, sizeof(unsigned short) * capacity);
+                if (bins) k->bins = bins;
+                float* weights = (float*)realloc(k->weights, sizeof(float) * 2 * capacity);
+                if (weights) k->weights = weights;
+                if (!bins || !weights) {
+                    FreeKernel(k);
+                    free(re);
+                    free(im);
+                    FFT_Free(&fft);
+                    return NULL;
+                }
+            }
+
+            // 파스발: sum x * conj(kernel) = (1/N) sum X * conj(K)
+            k->bins[nnz] = (unsigned short)j;
+            k->weights[2 * nnz] = kr * invN;
+            k->weights[2 * nnz + 1] = -ki * invN;
+            nnz++;
+        }
+    }
+    k->offsets[binCount] = nnz;
+    k->nonZero = nnz;
+
+    free(re);
+    free(im);
+    FFT_Free(&fft);
+    return k;
+}
+
+const ConstantQKernel* ConstantQ_Acquire(int sampleRate, int fftSize, int binsPerOctave,
+                                         int binCount, float minFreq) {
+    if (sampleRate <= 0 || !FFT_IsValidSize(fftSize) || binsPerOctave <= 0 ||
+        binCount <= 0 || binCount > CQT_MAX_BINS || minFreq <= 0.0f) {
+        return NULL;
+    }
+
+    std::lock_guard<std::mutex> lock(g_cacheLock);
+
+    for (int i = 0; i < CQT_CACHE_SIZE; i++) {
+        ConstantQKernel* k = g_cache[i];
+        if (k && k->sampleRate == sampleRate && k->fftSize == fftSize &&
+            k->binsPerOctave == binsPerOctave && k->binCount == binCount && k->minFreq == minFreq) {
+            k->refs++;
+            k->lastUse = ++g_useClock;
+            return k;
+        }
+    }
+
+    // 빈 슬롯, 없으면 참조가 없는 가장 오래된 커널 자리
+    int slot = -1;
+    for (int i = 0; i < CQT_CACHE_SIZE; i++) {
+        if (!g_cache[i]) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot < 0) {
+        for (int i = 0; i < CQT_CACHE_SIZE; i++) {
+            if (g_cache[i]->refs == 0 && (slot < 0 || g_cache[i]->lastUse < g_cache[slot]->lastUse)) {
+                slot = i;
+            }
+        }
+    }
+    if (slot < 0) return NULL;     // 모두 사용 중 (파이프라인이 CQT_CACHE_SIZE개보다 많음)
+
+    ConstantQKernel* k = BuildKernel(sampleRate, fftSize, binsPerOctave, binCount, minFreq);
+    if (!k) return NULL;
+
+    FreeKernel(g_cache[slot]);
+    g_cache[slot] = k;
+    k->refs = 1;
+    k->lastUse = ++g_useClock;
+    return k;
+}
+
+void ConstantQ_Release(const ConstantQKernel* kernel) {
+    if (!kernel) return;
+    std::lock_guard<std::mutex> lock(g_cacheLock);
+    // 참조가 0이 되어도 캐시에 남겨 둠 (설정을 되돌리면 바로 재사용)
+    ConstantQKernel* k = (ConstantQKernel*)kernel;
+    if (k->refs > 0) k->refs--;
+}
+
+void ConstantQ_Apply(const ConstantQKernel* kernel, const float* packed, float* magnitudes) {
+    if (!kernel || !packed || !magnitudes) return;
+
+    const unsigned short* bins = kernel->bins;
+    const float* w = kernel->weights;
+
+    for (int b = 0; b < kernel->binCount; b++) {
+        float sr = 0.0f, si = 0.0f;
+        int end = kernel->offsets[b + 1];
+        for (int j = kernel->offsets[b]; j < end; j++) {
+            const float* x = packed + 2 * bins[j];
+            float wr = w[2 * j], wi = w[2 * j + 1];
+            sr += x[0] * wr - x[1] * wi;
+            si += x[0] * wi + x[1] * wr;
+        }
+        magnitudes[b] = sqrtf(sr * sr + si * si);
+    }
+}
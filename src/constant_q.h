@@ -0,0 +1,50 @@
+/*
+ * constant_q.h - Constant-Q Spectrum (platform-neutral)
+ *
+ * 음 간격(옥타브당 같은 수)의 주파수 빈을 FFT 복소 스펙트럼에 희소 커널을 곱해서 계산 (Brown-Puckette)
+ * 커널은 (샘플레이트, 옥타브당 빈 수, FFT 크기, 빈 수, 최저 주파수)별로 한 번만 만들어 캐시에 보관
+ */
+
+#ifndef CONSTANT_Q_H
+#define CONSTANT_Q_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CQT_MAX_BINS 128
+#define CQT_CACHE_SIZE 8                // 참조가 없는 커널은 이 수를 넘으면 오래된 것부터 정리
+#define CQT_KERNEL_THRESHOLD 0.0054f    // 행 최댓값 대비 이보다 작은 커널 값은 버림
+
+// 희소 스펙트럴 커널 (CSR, 값은 켤레 복소수 / N을 미리 곱해 둠)
+typedef struct {
+    int sampleRate;
+    int fftSize;
+    int binsPerOctave;
+    int binCount;
+    float minFreq;
+    int* offsets;               // [binCount + 1]
+    unsigned short* bins;       // [nonZero] FFT 빈 번호
+    float* weights;             // [nonZero * 2] 복소 가중치 (re, im 교차)
+    int nonZero;
+    int fullQ;                  // 창 길이가 FFT 크기에 들어가 Q가 유지되는 첫 빈 (이보다 아래는 Q가 줄어듦)
+    int refs;                   // 캐시 참조 수
+    unsigned long long lastUse;
+} ConstantQKernel;
+
+// 캐시에서 커널 가져오기 (없으면 생성), 다 쓰면 ConstantQ_Release
+const ConstantQKernel* ConstantQ_Acquire(int sampleRate, int fftSize, int binsPerOctave,
+                                         int binCount, float minFreq);
+void ConstantQ_Release(const ConstantQKernel* kernel);
+
+// 패킹된 실수 FFT 스펙트럼 (FFT_RealForward 형식) -> 빈별 크기 (sine 진폭 A -> A / 2, FFT_Magnitude와 같은 단위)
+void ConstantQ_Apply(const ConstantQKernel* kernel, const float* packed, float* magnitudes);
+
+// 빈 k의 중심 주파수
+float ConstantQ_BinFrequency(const ConstantQKernel* kernel, int bin);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CONSTANT_Q_H
@@ -0,0 +1,94 @@
+/*
+ * decimator.cpp - Half-Band Decimation Chain
+ * 계수 = 블랙맨 창을 씌운 sinc (차단 주파수 = 입력 나이퀴스트의 절반), 합 = 1로 정규화
+ */
+
+#include "decimator.h"
+
+#include <string.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+int Decimator_Init(Decimator* d, int stages) {
+    if (!d || stages < 0 || stages > DECIMATOR_MAX_STAGES) return 0;
+
+    memset(d, 0, sizeof(Decimator));
+    d->stages = stages;
+
+    const int half = HALFBAND_TAPS / 2;
+    double sum = 0.5;
+    double pairs[HALFBAND_PAIRS];
+    for (int i = 0; i < HALFBAND_PAIRS; i++) {
+        int n = 2 * i + 1;                  // 중심에서 떨어진 거리 (홀수만 0이 아님)
+        double sinc = sin(M_PI * n / 2.0) / (M_PI * n);
+        double x = (double)(half + n + 1) / (HALFBAND_TAPS + 1);  // 양 끝 탭도 0이 아니게
+        double window = 0.42 - 0.5 * cos(2.0 * M_PI * x) + 0.08 * cos(4.0 * M_PI * x);
+        pairs[i] = sinc * window;
+        sum += 2.0 * pairs[i];
+    }
+
+    d->center = (float)(0.5 / sum);
+    for (int i = 0; i < HALFBAND_PAIRS; i++) d->pairs[i] = (float)(pairs[i] / sum);
+    Decimator_Reset(d);
+    return 1;
+}
+
+void Decimator_Reset(Decimator* d) {
+    if (!d) return;
+    memset(d->stage, 0, sizeof(d->stage));
+    for (int s = 0; s < DECIMATOR_MAX_STAGES; s++) d->stage[s].fill = HALFBAND_HISTORY;
+}
+
+// 한 단: 입력 두 개마다 출력 하나
+// 블록을 작업 버퍼에 복사한 뒤에 출력을 쓰고 출력 수 <= 입력 수 / 2라서 out == in이어도 됨
+static int ProcessStage(const Decimator* d, HalfBandStage* s, const float* in, int count, float* out) {
+    const int half = HALFBAND_TAPS / 2;
+    const float center = d->center;
+    const float* pairs = d->pairs;
+    int produced = 0;
+
+    while (count > 0) {
+        int n = HALFBAND_HISTORY + 1 + DECIMATOR_BLOCK - s->fill;
+        if (n > count) n = count;
+        memcpy(s->buffer + s->fill, in, sizeof(float) * n);
+        s->fill += n;
+        in += n;
+        count -= n;
+
+        // 출력 j의 창 = buffer[2j .. 2j + TAPS - 1] (가장 오래된 샘플부터)
+        int outputs = (s->fill - HALFBAND_HISTORY) / 2;
+        for (int j = 0; j < outputs; j++) {
+            const float* w = s->buffer + 2 * j;
+            float acc = center * w[half];
+            for (int k = 0; k < HALFBAND_PAIRS; k++) {
+                acc += pairs[k] * (w[half - 2 * k - 1] + w[half + 2 * k + 1]);
+            }
+            out[produced + j] = acc;
+        }
+        produced += outputs;
+
+        // 다음 블록 앞에 남길 샘플 (이전 샘플 + 짝이 없는 샘플)
+        int consumed = 2 * outputs;
+        s->fill -= consumed;
+        memmove(s->buffer, s->buffer + consumed, sizeof(float) * s->fill);
+    }
+    return produced;
+}
+
+int Decimator_Process(Decimator* d, const float* in, int count, float* out) {
+    if (!d || !in || !out || count <= 0) return 0;
+
+    if (d->stages == 0) {
+        if (out != in) memmove(out, in, sizeof(float) * count);
+        return count;
+    }
+
+    int n = ProcessStage(d, &d->stage[0], in, count, out);
+    for (int s = 1; s < d->stages && n > 0; s++) {
+        n = ProcessStage(d, &d->stage[s], out, n, out);
+    }
+    return n;
+}
@@ -0,0 +1,47 @@
+/*
+ * decimator.h - Half-Band Decimation Chain (platform-neutral)
+ *
+ * 2배 하프밴드 FIR을 여러 단 이어서 1/2^stages로 다운샘플 (저역 전용 작은 FFT 앞단)
+ * 하프밴드는 중심 탭 외의 짝수 번째 계수가 0이라 출력 샘플만, 0이 아닌 탭만 계산 (폴리페이즈)
+ */
+
+#ifndef DECIMATOR_H
+#define DECIMATOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DECIMATOR_MAX_STAGES 5
+#define HALFBAND_TAPS 15                        // 4k - 1 꼴 (중심 탭 + 대칭 4쌍)
+#define HALFBAND_PAIRS ((HALFBAND_TAPS + 1) / 4)
+#define HALFBAND_HISTORY (HALFBAND_TAPS - 2)    // 새 샘플 쌍 앞에 필요한 이전 샘플 수
+#define DECIMATOR_BLOCK 256                     // 단별 작업 버퍼에 한 번에 넣는 입력 수
+
+// 단별 상태 (이전 샘플 + 새 블록을 이어 붙인 연속 버퍼에서 출력을 한꺼번에 계산)
+typedef struct {
+    float buffer[HALFBAND_HISTORY + 1 + DECIMATOR_BLOCK];
+    int fill;                   // 유효 샘플 수 (HISTORY 또는 짝이 없는 샘플 하나 포함 HISTORY + 1)
+} HalfBandStage;
+
+typedef struct {
+    int stages;
+    float pairs[HALFBAND_PAIRS];    // 중심에서 1, 3, 5, ... 떨어진 탭 계수
+    float center;
+    HalfBandStage stage[DECIMATOR_MAX_STAGES];
+} Decimator;
+
+// 초기화 (stages = 2배 단 수, 0이면 그대로 복사)
+int Decimator_Init(Decimator* d, int stages);
+
+// 지연선 비우기
+void Decimator_Reset(Decimator* d);
+
+// count개 입력 -> 출력 (out은 count개 이상, in과 같아도 됨), 반환값 = 출력 샘플 수
+int Decimator_Process(Decimator* d, const float* in, int count, float* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DECIMATOR_H
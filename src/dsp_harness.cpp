@@ -0,0 +1,1239 @@
+/*
+ * dsp_harness.cpp - Offline Audio Analysis Harness (platform-neutral, 콘솔)
+ *
+ * WAV 파일이나 생성 신호를 AudioCapture_GetSpectrum과 같은 DSP 경로로 처리
+ * (SampleConverter -> AudioPipeline -> STFT -> FFT -> BarMapper -> BeatTracker)
+ * 프레임별 막대를 CSV / 바이너리로 저장하고 처리 속도와 단계별 시간을 출력
+ *
+ * 빌드: Linux  ./build-harness.sh
+ *       MSVC   cl /O2 /EHsc /std:c++17 src\dsp_harness.cpp src\audio_pipeline.cpp src\bar_mapper.cpp
+ *                 src\auto_gain.cpp src\spectral_features.cpp src\decimator.cpp src\constant_q.cpp
+ *                 src\spectrogram.cpp src\hpss.cpp
+ *                 src\beat_tracker.cpp src\dsp_kernels.cpp src\fft.cpp src\sample_convert.cpp
+ *                 src\spsc_ring.cpp src\stft.cpp /Fe:dsp_harness.exe
+ */
+
+#include "audio_pipeline.h"
+#include "sample_convert.h"
+#include "dsp_kernels.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#define HARNESS_BLOCK_FRAMES 1024           // 한 번에 변환/처리할 프레임 수
+#define HARNESS_RING_CAPACITY (1 << 16)
+#define HARNESS_PI 3.14159265358979323846
+
+static double NowSec(void) {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ---------------------------------------------------------------------------
+// 입력 (인터리브 원본 바이트 + 포맷)
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    unsigned char* data;
+    size_t frames;
+    int format;             // SampleFormat
+    int channels;
+    unsigned int channelMask;
+    int sampleRate;
+} AudioInput;
+
+static unsigned int ReadLE16(const unsigned char* p) { return p[0] | (p[1] << 8); }
+static unsigned int ReadLE32(const unsigned char* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+// RIFF/WAVE 읽기 (PCM / IEEE_FLOAT / EXTENSIBLE)
+static int LoadWav(const char* path, AudioInput* in) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "error: cannot open %s\n", path);
+        return 0;
+    }
+
+    unsigned char header[12];
+    if (fread(header, 1, 12, f) != 12 || memcmp(header, "RIFF", 4) != 0 ||
+        memcmp(header + 8, "WAVE", 4) != 0) {
+        fprintf(stderr, "error: %s is not a RIFF/WAVE file\n", path);
+        fclose(f);
+        return 0;
+    }
+
+    int haveFormat = 0;
+    int formatTag = 0, bits = 0, subFormat = 0, blockAlign = 0;
+    memset(in, 0, sizeof(AudioInput));
+
+    unsigned char chunk[8];
+    while (fread(chunk, 1, 8, f) == 8) {
+        unsigned int size = ReadLE32(chunk + 4);
+
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            unsigned char fmt[40];
+            unsigned int n = size < sizeof(fmt) ? size : (unsigned int)sizeof(fmt);
+            if (n < 16 || fread(fmt, 1, n, f) != n) break;
+            fseek(f, (long)(size - n + (size & 1)), SEEK_CUR);
+
+            formatTag = ReadLE16(fmt);
+            in->channels = ReadLE16(fmt + 2);
+            in->sampleRate = (int)ReadLE32(fmt + 4);
+            blockAlign = ReadLE16(fmt + 12);
+            bits = ReadLE16(fmt + 14);
+            if (formatTag == SAMPLE_WAVE_FORMAT_EXTENSIBLE && n >= 40) {
+                in->channelMask = ReadLE32(fmt + 20);
+                subFormat = (int)ReadLE32(fmt + 24);    // SubFormat GUID Data1
+            }
+            haveFormat = 1;
+        } else if (memcmp(chunk, "data", 4) == 0 && haveFormat) {
+            in->format = SampleFormat_FromWave(formatTag, bits, subFormat);
+            int bytesPerFrame = SampleFormat_BytesPerSample(in->format) * in->channels;
+            if (in->format == SAMPLE_FORMAT_UNKNOWN || bytesPerFrame != blockAlign) {
+                fprintf(stderr, "error: unsupported WAV format (tag 0x%04x, %d bits, align %d)\n",
+                        formatTag, bits, blockAlign);
+                break;
+            }
+
+            in->data = (unsigned char*)malloc(size ? size : 1);
+            if (!in->data) break;
+            size_t got = fread(in->data, 1, size, f);
+            in->frames = got / bytesPerFrame;
+            fclose(f);
+            return 1;
+        } else {
+            fseek(f, (long)(size + (size & 1)), SEEK_CUR);
+        }
+    }
+
+    fprintf(stderr, "error: %s has no usable fmt/data chunks\n", path);
+    free(in->data);
+    in->data = NULL;
+    fclose(f);
+    return 0;
+}
+
+// 생성 신호 (모노 float)
+// sine:FREQ, sweep:F0:F1 (로그), noise, clicks:BPM (킥 + 8분음표 하이햇)
+// pads:BPM (clicks 위에 박자와 무관하게 부풀었다 줄어드는 큰 화음, 분리 전후 박자 추적 비교용)
+static int Generate(const char* spec, double seconds, int sampleRate, AudioInput* in) {
+    memset(in, 0, sizeof(AudioInput));
+    in->format = SAMPLE_FORMAT_F32;
+    in->channels = 1;
+    in->sampleRate = sampleRate;
+    in->frames = (size_t)(seconds * sampleRate);
+    in->data = (unsigned char*)calloc(in->frames ? in->frames : 1, sizeof(float));
+    if (!in->data) return 0;
+
+    float* out = (float*)in->data;
+    double a = 0.0, b = 0.0;
+    unsigned int seed = 12345;
+
+    if (sscanf(spec, "sine:%lf", &a) == 1) {
+        for (size_t i = 0; i < in->frames; i++) {
+            out[i] = 0.5f * (float)sin(2.0 * HARNESS_PI * a * i / sampleRate);
+        }
+    } else if (sscanf(spec, "sweep:%lf:%lf", &a, &b) == 2 && a > 0.0 && b > 0.0) {
+        // 위상 = 적분(f(t)), f(t) = a * (b/a)^(t/T)
+        double k = log(b / a) / seconds;
+        for (size_t i = 0; i < in->frames; i++) {
+            double t = (double)i / sampleRate;
+            double phase = 2.0 * HARNESS_PI * a * (exp(k * t) - 1.0) / k;
+            out[i] = 0.5f * (float)sin(phase);
+        }
+    } else if (strcmp(spec, "noise") == 0) {
+        for (size_t i = 0; i < in->frames; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            out[i] = 0.5f * ((float)(seed >> 8) / 8388608.0f - 1.0f);
+        }
+    } else if (sscanf(spec, "clicks:%lf", &a) == 1 && a > 0.0) {
+        double beat = 60.0 / a;
+        for (size_t i = 0; i < in->frames; i++) {
+            double t = (double)i / sampleRate;
+            double tb = fmod(t, beat);
+            double th = fmod(t, beat * 0.5);
+            seed = seed * 1664525u + 1013904223u;
+            float noise = (float)(seed >> 8) / 8388608.0f - 1.0f;
+            float kick = (float)(sin(2.0 * HARNESS_PI * 60.0 * tb) * exp(-tb * 25.0));
+            float hat = noise * (float)exp(-th * 80.0) * 0.3f;
+            out[i] = 0.6f * kick + hat;
+        }
+    } else if (sscanf(spec, "pads:%lf", &a) == 1 && a > 0.0) {
+        // 화음이 1.7초마다 바뀌며 천천히 부풀고, 비브라토로 빈 사이를 오가서 전체 믹스의 플럭스를 흔듦
+        static const double chords[3][3] = {
+            { 220.0, 277.18, 329.63 }, { 196.0, 246.94, 293.66 }, { 174.61, 220.0, 261.63 }
+        };
+        double beat = 60.0 / a;
+        double phase[3] = { 0.0, 0.0, 0.0 };
+        for (size_t i = 0; i < in->frames; i++) {
+            double t = (double)i / sampleRate;
+            double tb = fmod(t, beat);
+            double th = fmod(t, beat * 0.5);
+            seed = seed * 1664525u + 1013904223u;
+            float noise = (float)(seed >> 8) / 8388608.0f - 1.0f;
+            float kick = (float)(sin(2.0 * HARNESS_PI * 60.0 * tb) * exp(-tb * 25.0));
+            float hat = noise * (float)exp(-th * 80.0) * 0.3f;
+
+            int chord = (int)(t / 1.7) % 3;
+            double swell = 1.0 - exp(-fmod(t, 1.7) * 3.0);
+            double vibrato = 1.0 + 0.02 * sin(2.0 * HARNESS_PI * 5.5 * t);
+            double pad = 0.0;
+            for (int n = 0; n < 3; n++) {
+                phase[n] += 2.0 * HARNESS_PI * chords[chord][n] * vibrato / sampleRate;
+                pad += sin(phase[n]) + 0.5 * sin(2.0 * phase[n]);
+            }
+            out[i] = 0.35f * kick + 0.2f * hat + 0.5f * (float)(swell * pad);
+        }
+    } else {
+        fprintf(stderr, "error: unknown generator '%s'\n", spec);
+        free(in->data);
+        in->data = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+// ---------------------------------------------------------------------------
+// 프레임 출력
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    FILE* csv;
+    FILE* bin;
+    int peaks;              // CSV에 피크 유지 값도 기록
+    int features;           // CSV에 음색 특징도 기록
+    int hpss;               // CSV에 화성 / 타악 에너지도 기록
+    int sampleRate;
+    unsigned long long frames;
+    BeatState lastBeat;
+    double harmonicSum;     // 화성 / 타악 에너지 평균용
+    double percussiveSum;
+} FrameSink;
+
+static void OnFrame(const SpectrumFrame* frame, void* user) {
+    FrameSink* sink = (FrameSink*)user;
+    sink->frames++;
+    sink->lastBeat = frame->beat;
+    sink->harmonicSum += frame->harmonic;
+    sink->percussiveSum += frame->percussive;
+
+    if (sink->csv) {
+        fprintf(sink->csv, "%llu,%.6f", frame->sequence,
+                (double)frame->samplePosition / sink->sampleRate);
+        for (int i = 0; i < frame->barCount; i++) {
+            fprintf(sink->csv, ",%.5f", frame->spectrum.bars[i]);
+        }
+        for (int i = 0; sink->peaks && i < frame->barCount; i++) {
+            fprintf(sink->csv, ",%.5f", frame->peaks.bars[i]);
+        }
+        fprintf(sink->csv, ",%.2f,%.4f,%.3f,%d", frame->beat.bpm, frame->beat.phase,
+                frame->beat.confidence, frame->beat.onset);
+        if (sink->features) {
+            const SpectralFeatures* f = &frame->features;
+            fprintf(sink->csv, ",%.1f,%.1f,%.4f", f->centroid, f->rolloff, f->flatness);
+            for (int i = 0; i < FEATURE_CHROMA_BINS; i++) fprintf(sink->csv, ",%.3f", f->chroma[i]);
+        }
+        if (sink->hpss) fprintf(sink->csv, ",%.4f,%.4f", frame->harmonic, frame->percussive);
+        fprintf(sink->csv, "\n");
+    }
+
+    if (sink->bin) {
+        // 프레임마다 float32 [barCount] + bpm, phase, confidence (리틀 엔디언 호스트 기준)
+        fwrite(frame->spectrum.bars, sizeof(float), frame->barCount, sink->bin);
+        float beat[3] = { frame->beat.bpm, frame->beat.phase, frame->beat.confidence };
+        fwrite(beat, sizeof(float), 3, sink->bin);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 커널 벤치마크 / 변환 검증
+// ---------------------------------------------------------------------------
+
+#define BENCH_COUNT 4096
+
+// 한 커널 함수의 원소당 시간 (ns)
+template <typename Fn>
+static double TimeKernel(Fn fn, int elements) {
+    int reps = 64;
+    double elapsed = 0.0;
+    while (1) {
+        double start = NowSec();
+        for (int r = 0; r < reps; r++) fn();
+        elapsed = NowSec() - start;
+        if (elapsed > 0.05 || reps >= (1 << 20)) break;
+        reps *= 4;
+    }
+    return elapsed * 1e9 / ((double)reps * elements);
+}
+
+static int BenchKernels(void) {
+    static float a[BENCH_COUNT * 2], b[BENCH_COUNT * 2], c[BENCH_COUNT * 2], w[BENCH_COUNT * 2];
+    static short s16[BENCH_COUNT];
+    static int s32[BENCH_COUNT];
+    for (int i = 0; i < BENCH_COUNT * 2; i++) {
+        a[i] = sinf(i * 0.01f);
+        b[i] = cosf(i * 0.02f);
+        w[i] = cosf(i * 0.003f);
+    }
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        s16[i] = (short)(i * 37);
+        s32[i] = i * 104729;
+    }
+    // GIF 팔레트: 잡음 인덱스 (같은 색 / 투명 구간 없음 = 조회 비용만, 실제 프레임은 gif_harness --bench-kernels)
+    static unsigned char indices[BENCH_COUNT];
+    static unsigned int palette[256], pixels[BENCH_COUNT];
+    for (int i = 0; i < BENCH_COUNT; i++) indices[i] = (unsigned char)((i * 2654435761u) >> 24);
+    for (int i = 0; i < 256; i++) palette[i] = 0xFF000000u | (i * 0x010101u);
+
+    const DspKernels* list[8];
+    int count = DspKernels_List(list, 8);
+    const int n = BENCH_COUNT;
+
+    static float hold[BENCH_COUNT], velocity[BENCH_COUNT];
+    memset(hold, 0, sizeof(hold));
+    memset(velocity, 0, sizeof(velocity));
+
+    printf("kernel   downmix2  window  cmul    bfly    mag     dB      s16     s32     env     peak"
+           "    palette palcomp (ns/element)\n");
+    for (int i = 0; i < count; i++) {
+        const DspKernels* k = list[i];
+        printf("%-8s", k->name);
+        printf(" %7.3f", TimeKernel([&] { k->downmix(a, c, n, 2); }, n));
+        printf(" %7.3f", TimeKernel([&] { k->applyWindow(a, w, c, n); }, n));
+        printf(" %7.3f", TimeKernel([&] { k->complexMultiply(a, w, c, n); }, n));
+        // 나비는 제자리 연산이라 b 복사본에서 반복
+        memcpy(c, b, sizeof(float) * n * 2);
+        printf(" %7.3f", TimeKernel([&] { k->butterfly(c, c + n, w, n / 2); }, n / 2));
+        printf(" %7.3f", TimeKernel([&] { k->magnitude(a, c, n, 1.0f); }, n));
+        printf(" %7.3f", TimeKernel([&] { k->toDecibels(b, c, n, 1e-10f); }, n));
+        printf(" %7.3f", TimeKernel([&] { k->int16ToFloat(s16, c, n); }, n));
+        printf(" %7.3f", TimeKernel([&] { k->int32ToFloat(s32, c, n); }, n));
+        printf(" %7.3f", TimeKernel([&] { k->envelope(c, a, n, 0.3f, 0.1f); }, n));
+        printf(" %7.3f", TimeKernel([&] { k->peakHold(w, hold, velocity, a, n, 0.01f, 0.5f, 3.0f); }, n));
+        printf(" %7.3f", TimeKernel([&] { k->paletteExpand(indices, palette, pixels, n); }, n));
+        printf(" %7.3f", TimeKernel([&] { k->paletteComposite(indices, palette, pixels, n, 0); }, n));
+        printf("\n");
+    }
+
+    // FFT 크기 스펙트럼 (커널별, 크기별)
+    printf("\nFFT_Magnitude (us/transform)\nkernel  ");
+    for (int size = FFT_MIN_SIZE; size <= FFT_MAX_SIZE; size *= 2) printf(" %7d", size);
+    printf("\n");
+
+    static float input[FFT_MAX_SIZE], output[FFT_MAX_SIZE / 2];
+    for (int i = 0; i < FFT_MAX_SIZE; i++) input[i] = sinf(i * 0.05f) + 0.3f * cosf(i * 0.71f);
+
+    for (int i = 0; i < count; i++) {
+        DspKernels_Select(list[i]->name);
+        printf("%-8s", list[i]->name);
+        for (int size = FFT_MIN_SIZE; size <= FFT_MAX_SIZE; size *= 2) {
+            FFTContext fft;
+            if (!FFT_Init(&fft, size, FFT_WINDOW_HANN)) return 1;
+            printf(" %7.2f", TimeKernel([&] { FFT_Magnitude(&fft, input, output); }, 1) / 1000.0);
+            FFT_Free(&fft);
+        }
+        printf("\n");
+    }
+    DspKernels_Select(NULL);
+    return 0;
+}
+
+// 변환기 기준값 (채널 가중치, LFE 제외 포함)
+static float ReferenceSample(int format, const unsigned char* p) {
+    switch (format) {
+        case SAMPLE_FORMAT_U8:  return ((int)p[0] - 128) / 128.0f;
+        case SAMPLE_FORMAT_S16: return (short)ReadLE16(p) / 32768.0f;
+        case SAMPLE_FORMAT_S24: return (float)((int)(ReadLE32(p - 1) & 0xFFFFFF00u) / 2147483648.0);
+        case SAMPLE_FORMAT_S32: return (float)((int)ReadLE32(p) / 2147483648.0);
+        case SAMPLE_FORMAT_F32: { float v; memcpy(&v, p, 4); return v; }
+        case SAMPLE_FORMAT_F64: { double v; memcpy(&v, p, 8); return (float)v; }
+    }
+    return 0.0f;
+}
+
+static int CheckConvert(void) {
+    static const int formats[] = {
+        SAMPLE_FORMAT_U8, SAMPLE_FORMAT_S16, SAMPLE_FORMAT_S24,
+        SAMPLE_FORMAT_S32, SAMPLE_FORMAT_F32, SAMPLE_FORMAT_F64
+    };
+    // 채널 수 + 마스크 (5.1은 LFE 제외 경로)
+    static const struct { int channels; unsigned int mask; const char* name; } layouts[] = {
+        { 1, 0x4, "mono" }, { 2, 0x3, "stereo" }, { 6, 0x3F, "5.1" }, { 8, 0x63F, "7.1" }
+    };
+    const int frames = 4096 + 37;   // 블록 경계가 아닌 길이
+
+    // S24는 앞에 1바이트 여유를 둬서 ReadLE32(p - 1)로 읽음
+    unsigned char* raw = (unsigned char*)malloc((size_t)frames * 8 * 8 + 1);
+    float* mono = (float*)malloc(sizeof(float) * frames);
+    if (!raw || !mono) return 1;
+    unsigned char* data = raw + 1;
+
+    const DspKernels* list[8];
+    int kernelCount = DspKernels_List(list, 8);
+    int failures = 0;
+
+    printf("kernel   format layout  max error   ns/frame\n");
+    for (int ki = 0; ki < kernelCount; ki++) {
+        DspKernels_Select(list[ki]->name);
+
+        for (int fi = 0; fi < (int)(sizeof(formats) / sizeof(formats[0])); fi++) {
+            int format = formats[fi];
+            int bps = SampleFormat_BytesPerSample(format);
+
+            for (int li = 0; li < (int)(sizeof(layouts) / sizeof(layouts[0])); li++) {
+                int channels = layouts[li].channels;
+                unsigned int seed = 777u + fi * 31u + li;
+                for (size_t i = 0; i < (size_t)frames * channels * bps; i++) {
+                    seed = seed * 1664525u + 1013904223u;
+                    data[i] = (unsigned char)(seed >> 24);
+                }
+                // float 포맷은 유효한 범위의 값으로
+                for (int i = 0; i < frames * channels; i++) {
+                    float v = sinf(i * 0.013f) * 0.9f;
+                    if (format == SAMPLE_FORMAT_F32) memcpy(data + i * 4, &v, 4);
+                    if (format == SAMPLE_FORMAT_F64) { double d = v; memcpy(data + i * 8, &d, 8); }
+                }
+
+                static SampleConverter cv;
+                if (!SampleConverter_Init(&cv, format, channels, layouts[li].mask)) {
+                    printf("%-8s %-6s %-7s init failed\n", list[ki]->name, SampleFormat_Name(format),
+                           layouts[li].name);
+                    failures++;
+                    continue;
+                }
+                SampleConverter_Run(&cv, data, mono, frames);
+
+                // 기준: LFE를 뺀 채널 평균
+                float maxError = 0.0f;
+                for (int i = 0; i < frames; i++) {
+                    unsigned int bits = layouts[li].mask;
+                    float sum = 0.0f;
+                    int included = 0;
+                    for (int ch = 0; ch < channels; ch++) {
+                        unsigned int speaker = bits & (~bits + 1);
+                        bits &= ~speaker;
+                        if (speaker == SAMPLE_SPEAKER_LOW_FREQUENCY) continue;
+                        sum += ReferenceSample(format, data + ((size_t)i * channels + ch) * bps);
+                        included++;
+                    }
+                    float err = fabsf(mono[i] - sum / included);
+                    if (err > maxError) maxError = err;
+                }
+
+                double ns = TimeKernel([&] { SampleConverter_Run(&cv, data, mono, frames); }, frames);
+                int ok = maxError < 1e-5f;
+                if (!ok) failures++;
+                printf("%-8s %-6s %-7s %.2e  %8.3f  %s\n", list[ki]->name, SampleFormat_Name(format),
+                       layouts[li].name, maxError, ns, ok ? "ok" : "FAIL");
+            }
+        }
+    }
+    DspKernels_Select(NULL);
+
+    free(raw);
+    free(mono);
+    printf("%s\n", failures ? "converter check FAILED" : "converter check passed");
+    return failures ? 1 : 0;
+}
+
+// ---------------------------------------------------------------------------
+// FFT 정확도 검증 (제거된 SimpleDFT 대비)
+// ---------------------------------------------------------------------------
+
+#define CHECK_FFT_MAG_ABS 1e-6      // |FFT_Magnitude - DFT| 상한 (진폭 1 입력의 |X[k]|/N 단위)
+#define CHECK_FFT_MAG_REL 2e-6      // 위 오차 / DFT 최대 크기 상한
+#define CHECK_FFT_BAR_ABS 1e-5      // 막대 (-60 ~ 0 dB -> 0.0 ~ 1.0) 차이 상한
+
+// 예전 audio_capture.cpp의 SimpleDFT (O(N^2), |X[k]| / N)
+// 기준값 자체의 오차가 비교를 가리지 않게 double로 누적하고 각도는 (k * t) mod N 표에서 읽음
+static void SimpleDFT(const float* input, double* output, int n) {
+    double* cosTable = (double*)malloc(sizeof(double) * n);
+    double* sinTable = (double*)malloc(sizeof(double) * n);
+    for (int t = 0; t < n; t++) {
+        cosTable[t] = cos(2.0 * HARNESS_PI * t / n);
+        sinTable[t] = sin(2.0 * HARNESS_PI * t / n);
+    }
+    for (int k = 0; k < n / 2; k++) {
+        double real = 0.0, imag = 0.0;
+        for (int t = 0, angle = 0; t < n; t++, angle = (angle + k) & (n - 1)) {
+            real += input[t] * cosTable[angle];
+            imag -= input[t] * sinTable[angle];
+        }
+        output[k] = sqrt(real * real + imag * imag) / n;
+    }
+    free(cosTable);
+    free(sinTable);
+}
+
+// 예전 GroupIntoBars (같은 폭 16막대 평균 -> dB -> -60 ~ 0 dB를 0.0 ~ 1.0으로, 스무딩 없이)
+static void ReferenceBars(const double* bins, int n, double* bars) {
+    int binsPerBar = (n / 2) / SPECTRUM_BARS;
+    for (int i = 0; i < SPECTRUM_BARS; i++) {
+        double sum = 0.0;
+        for (int j = i * binsPerBar; j < (i + 1) * binsPerBar; j++) sum += bins[j];
+        double normalized = (20.0 * log10(sum / binsPerBar + 0.0001) + 60.0) / 60.0;
+        bars[i] = normalized < 0.0 ? 0.0 : normalized > 1.0 ? 1.0 : normalized;
+    }
+}
+
+// 크기 512 ~ 8192 x 입력(사인, 잡음, 임펄스) x 커널: FFT_Magnitude(사각 윈도우)와 막대 경로(BarMapper 선형 + dB 커널)
+static int CheckFft(const char* kernel) {
+    static const char* inputs[] = { "sine", "noise", "impulse" };
+    const int inputCount = 3;
+    static float input[FFT_MAX_SIZE], output[FFT_MAX_SIZE / 2];
+    static double reference[FFT_MAX_SIZE / 2];
+    float bands[SPECTRUM_BARS], db[SPECTRUM_BARS];
+    double refBars[SPECTRUM_BARS];
+
+    const DspKernels* list[8];
+    int kernelCount = DspKernels_List(list, 8);
+    int failures = 0, checked = 0;
+
+    printf("kernel   size  input    mag max    mag rel    bar max\n");
+    for (int size = FFT_MIN_SIZE; size <= FFT_MAX_SIZE; size *= 2) {
+        BarMapper mapper;
+        if (!BarMapper_Init(&mapper, SPECTRUM_BARS, BAR_SCALE_LINEAR, size, 48000, 0.0f, 0.0f)) return 1;
+
+        for (int in = 0; in < inputCount; in++) {
+            unsigned int seed = 12345u;
+            for (int t = 0; t < size; t++) {
+                seed = seed * 1664525u + 1013904223u;
+                if (in == 0) input[t] = (float)(0.8 * sin(2.0 * HARNESS_PI * 1000.3 / 48000.0 * t));
+                if (in == 1) input[t] = (float)((seed >> 8) / 8388608.0 - 1.0);
+                if (in == 2) input[t] = t == size / 3 ? 1.0f : 0.0f;
+            }
+            SimpleDFT(input, reference, size);
+            ReferenceBars(reference, size, refBars);
+            double peak = 0.0;
+            for (int k = 0; k < size / 2; k++) if (reference[k] > peak) peak = reference[k];
+
+            for (int ki = 0; ki < kernelCount; ki++) {
+                if (kernel && strcmp(kernel, list[ki]->name) != 0) continue;
+                DspKernels_Select(list[ki]->name);
+                FFTContext fft;
+                if (!FFT_Init(&fft, size, FFT_WINDOW_RECT)) return 1;
+                FFT_Magnitude(&fft, input, output);
+                FFT_Free(&fft);
+
+                double magError = 0.0, barError = 0.0;
+                for (int k = 0; k < size / 2; k++) {
+                    double err = fabs(output[k] - reference[k]);
+                    if (err > magError) magError = err;
+                }
+                BarMapper_Apply(&mapper, output, bands);
+                DspKernels_Get()->toDecibels(bands, db, SPECTRUM_BARS, 0.0001f);
+                for (int i = 0; i < SPECTRUM_BARS; i++) {
+                    double normalized = (db[i] + 60.0) / 60.0;
+                    normalized = normalized < 0.0 ? 0.0 : normalized > 1.0 ? 1.0 : normalized;
+                    double err = fabs(normalized - refBars[i]);
+                    if (err > barError) barError = err;
+                }
+
+                double magRel = magError / peak;
+                int ok = magError <= CHECK_FFT_MAG_ABS && magRel <= CHECK_FFT_MAG_REL && barError <= CHECK_FFT_BAR_ABS;
+                if (!ok) failures++;
+                checked++;
+                printf("%-8s %5d  %-7s  %.2e   %.2e   %.2e  %s\n", list[ki]->name, size, inputs[in],
+                       magError, magRel, barError, ok ? "ok" : "FAIL");
+            }
+        }
+        BarMapper_Free(&mapper);
+    }
+    DspKernels_Select(NULL);
+
+    if (checked == 0) {
+        fprintf(stderr, "error: kernel '%s' is not available on this CPU\n", kernel);
+        return 2;
+    }
+    printf("%s\n", failures ? "fft check FAILED" : "fft check passed");
+    return failures ? 1 : 0;
+}
+
+// ---------------------------------------------------------------------------
+// 스레드 스트레스 (생산자 -> SPSC 링 -> DSP -> 최근 프레임 링 / 구독 슬롯 / 스펙트로그램 -> 읽는 스레드들)
+// ---------------------------------------------------------------------------
+
+#define STRESS_FFT_SIZE 1024
+#define STRESS_HOP_SIZE 256
+#define STRESS_SUB_FPS 60.0f                // 솎아 내는 구독자 빈도 (홉 여러 개마다 한 번)
+
+// DSP 스레드가 낸 프레임 (sequence - 1 번째)
+typedef struct {
+    unsigned long long position;
+    long long timestamp;
+    unsigned long long checksum;        // 막대 값 바이트의 FNV-1a
+} StressRecord;
+
+// 읽는 스레드가 본 프레임 (끝난 뒤 StressRecord와 대조)
+typedef struct {
+    unsigned long long sequence;
+    StressRecord record;
+} StressObservation;
+
+enum { STRESS_LATEST = 0, STRESS_AT, STRESS_SUBSCRIPTION, STRESS_DECIMATED, STRESS_SPECTROGRAM, STRESS_READERS };
+
+typedef struct {
+    AudioPipeline* pipeline;
+    std::atomic<int>* stop;
+    int kind;
+    int handle;                         // 구독 읽기일 때
+    unsigned long long reads;           // 성공한 읽기
+    unsigned long long misses;          // 0을 받은 읽기 (쓰는 중 / 덮어씀 / 아직 없음)
+    unsigned long long backwards;       // 시퀀스가 거꾸로 감
+    std::vector<StressObservation> seen;
+} StressReader;
+
+typedef struct {
+    std::vector<StressRecord> frames;
+    unsigned long long gaps;            // 시퀀스 / 샘플 위치가 한 홉씩 이어지지 않음
+} StressLog;
+
+static unsigned long long BarChecksum(const float* bars, int count) {
+    const unsigned char* p = (const unsigned char*)bars;
+    unsigned long long h = 14695981039346656037ULL;
+    for (size_t i = 0; i < sizeof(float) * count; i++) h = (h ^ p[i]) * 1099511628211ULL;
+    return h;
+}
+
+static void OnStressFrame(const SpectrumFrame* frame, void* user) {
+    StressLog* log = (StressLog*)user;
+    if (frame->sequence != log->frames.size() + 1 ||
+        (!log->frames.empty() && frame->samplePosition != log->frames.back().position + STRESS_HOP_SIZE)) {
+        log->gaps++;
+    }
+    StressRecord r = { frame->samplePosition, frame->timestamp, BarChecksum(frame->spectrum.bars, frame->barCount) };
+    log->frames.push_back(r);
+}
+
+static void Observe(StressReader* r, const SpectrumFrame* frame) {
+    if (!r->seen.empty()) {
+        unsigned long long last = r->seen.back().sequence;
+        if (frame->sequence < last) r->backwards++;
+        if (frame->sequence == last) return;
+    }
+    StressObservation o = { frame->sequence,
+        { frame->samplePosition, frame->timestamp, BarChecksum(frame->spectrum.bars, frame->barCount) } };
+    r->seen.push_back(o);
+}
+
+static void StressRead(StressReader* r) {
+    AudioPipeline* p = r->pipeline;
+    SpectrumFrame frame;
+    float rows[4 * SPECTRUM_BARS];
+
+    while (!r->stop->load(std::memory_order_relaxed)) {
+        int ok = 0;
+        if (r->kind == STRESS_LATEST) {
+            ok = AudioPipeline_ReadLatest(p, &frame);
+            if (ok) Observe(r, &frame);
+        } else if (r->kind == STRESS_AT) {
+            // 최신 프레임 몇 홉 전 시각 (타임스탬프 = 샘플 위치 + 1, 순서는 오가므로 대조만)
+            SpectrumFrame latest;
+            if (AudioPipeline_ReadLatest(p, &latest)) {
+                long long back = (long long)(r->reads % PIPELINE_HISTORY_FRAMES) * STRESS_HOP_SIZE;
+                ok = AudioPipeline_ReadAt(p, latest.timestamp - back, &frame);
+                if (ok) {
+                    StressObservation o = { frame.sequence,
+                        { frame.samplePosition, frame.timestamp, BarChecksum(frame.spectrum.bars, frame.barCount) } };
+                    if (r->seen.size() < (1u << 20)) r->seen.push_back(o);
+                }
+            }
+        } else if (r->kind == STRESS_SUBSCRIPTION || r->kind == STRESS_DECIMATED) {
+            ok = AudioPipeline_ReadSubscription(p, r->handle, &frame) > 0;
+            if (ok) Observe(r, &frame);
+        } else {
+            // 최근 4행을 복사한 뒤 그동안 덮어쓰이지 않았을 때만 (행 번호 + 1 = 메인 시퀀스)
+            SpectrogramView view;
+            int count = Spectrogram_Read(&p->spectrogram, 4, &view);
+            if (count > 0 && view.barCount == SPECTRUM_BARS) {
+                memcpy(rows, view.first, sizeof(float) * SPECTRUM_BARS * view.firstRows);
+                if (view.secondRows) {
+                    memcpy(rows + SPECTRUM_BARS * view.firstRows, view.second,
+                           sizeof(float) * SPECTRUM_BARS * view.secondRows);
+                }
+                ok = Spectrogram_Validate(&p->spectrogram, &view);
+                unsigned long long last = r->seen.empty() ? 0 : r->seen.back().sequence;
+                if (ok && view.start + count < last) r->backwards++;
+                for (int i = 0; ok && i < count; i++) {
+                    StressObservation o = { view.start + i + 1, { 0, 0, BarChecksum(rows + i * SPECTRUM_BARS, SPECTRUM_BARS) } };
+                    if (o.sequence > last) r->seen.push_back(o);
+                }
+            }
+        }
+        if (ok) r->reads++;
+        else r->misses++;
+    }
+}
+
+// 구독 / 해지를 되풀이 (해지한 슬롯을 DSP가 정리하고 다시 내주는 경로)
+// 첫 프레임이 다른 구독 설정이거나, 해지한 핸들로 (슬롯을 새 구독이 받은 뒤에도) 읽히면 오류
+static void StressChurn(AudioPipeline* p, std::atomic<int>* stop, unsigned long long* cycles,
+                        unsigned long long* errors) {
+    SpectrumFrame frame;
+    int stale = 0;
+    while (!stop->load(std::memory_order_relaxed)) {
+        SpectrumSubscription sub = { (*cycles & 1) ? 32 : 64, BAR_SCALE_MEL, 0.0f, 0.0f, 0.0f };
+        int handle = AudioPipeline_Subscribe(p, &sub);
+        if (!handle) {
+            std::this_thread::yield();      // DSP가 아직 해지한 슬롯을 정리하지 않음
+            continue;
+        }
+        int ok;
+        while ((ok = AudioPipeline_ReadSubscription(p, handle, &frame)) == 0 &&
+               !stop->load(std::memory_order_relaxed)) {
+            std::this_thread::yield();
+        }
+        if (ok < 0 || (ok > 0 && (frame.barCount != sub.barCount || frame.barScale != sub.barScale))) {
+            (*errors)++;
+        }
+        if (stale && AudioPipeline_ReadSubscription(p, stale, &frame) != 0) (*errors)++;
+        AudioPipeline_Unsubscribe(p, stale);    // 옛 핸들로 해지해도 지금 구독은 그대로여야 함
+        if (ok > 0 && AudioPipeline_ReadSubscription(p, handle, &frame) <= 0) (*errors)++;
+
+        AudioPipeline_Unsubscribe(p, handle);
+        if (AudioPipeline_ReadSubscription(p, handle, &frame) != 0) (*errors)++;
+        stale = handle;
+        (*cycles)++;
+    }
+}
+
+static int InitStressPipeline(AudioPipeline* p, StressLog* log, int spectrogram) {
+    if (!AudioPipeline_Init(p, 48000, 48000, STRESS_FFT_SIZE, STRESS_HOP_SIZE, SPECTRUM_BARS,
+                            BAR_SCALE_LINEAR, HARNESS_RING_CAPACITY)) {
+        return 0;
+    }
+    AudioPipeline_SetFrameCallback(p, OnStressFrame, log);
+    AudioPipeline_SetGate(p, -1000.0f);
+    if (spectrogram) AudioPipeline_SetSpectrogram(p, 64, SPECTRUM_BARS);
+    return 1;
+}
+
+// 프레임 하나를 DSP가 낸 기록과 대조 (시퀀스 / 위치 / 시각 / 막대가 모두 같은 프레임에서 왔는지)
+static int MatchRecord(const StressLog* log, unsigned long long sequence, const StressRecord* r, int barsOnly) {
+    if (sequence < 1 || sequence > log->frames.size()) return 0;
+    const StressRecord* d = &log->frames[sequence - 1];
+    if (d->checksum != r->checksum) return 0;
+    return barsOnly || (d->position == r->position && d->timestamp == r->timestamp);
+}
+
+// 구독 프레임은 메인 프레임과 샘플 위치로 짝지음 (같은 막대 설정이면 같은 막대 값)
+static const StressRecord* FindByPosition(const StressLog* log, unsigned long long position) {
+    if (log->frames.empty() || position < log->frames[0].position) return NULL;
+    unsigned long long offset = position - log->frames[0].position;
+    if (offset % STRESS_HOP_SIZE) return NULL;
+    size_t index = (size_t)(offset / STRESS_HOP_SIZE);
+    return index < log->frames.size() ? &log->frames[index] : NULL;
+}
+
+static int Stress(double seconds) {
+    static const char* names[STRESS_READERS] = { "latest", "read-at", "subscription", "decimated", "spectrogram" };
+    static AudioPipeline pipeline;
+    static AudioPipeline replica;
+    StressLog log, replicaLog;
+    log.gaps = replicaLog.gaps = 0;
+
+    AudioInput input;
+    if (!Generate("clicks:120", 4.0, 48000, &input)) return 1;
+    const float* signal = (const float*)input.data;
+    size_t signalFrames = input.frames;
+
+    if (!InitStressPipeline(&pipeline, &log, 1)) return 1;
+    // 메인과 같은 막대 설정 + 홉마다 (막대 값이 메인과 같아야 함), 솎아 낸 구독자 (연속성만)
+    SpectrumSubscription same = { SPECTRUM_BARS, BAR_SCALE_LINEAR, PIPELINE_ATTACK_MS, PIPELINE_RELEASE_MS, 0.0f };
+    SpectrumSubscription decimated = { 32, BAR_SCALE_OCTAVE, 0.0f, 0.0f, STRESS_SUB_FPS };
+    int sameHandle = AudioPipeline_Subscribe(&pipeline, &same);
+    int decimatedHandle = AudioPipeline_Subscribe(&pipeline, &decimated);
+    if (!sameHandle || !decimatedHandle) return 1;
+
+    std::atomic<int> producerDone(0), stop(0);
+    unsigned long long written = 0, fullWaits = 0;     // 링이 가득 차서 다시 쓴 횟수 (droppedSamples에도 집계됨)
+    unsigned long long churnCycles = 0, churnErrors = 0;
+    StressReader readers[STRESS_READERS];
+    for (int i = 0; i < STRESS_READERS; i++) {
+        readers[i].pipeline = &pipeline;
+        readers[i].stop = &stop;
+        readers[i].kind = i;
+        readers[i].handle = i == STRESS_SUBSCRIPTION ? sameHandle : decimatedHandle;
+        readers[i].reads = readers[i].misses = readers[i].backwards = 0;
+    }
+
+    double start = NowSec();
+    // 생산자: 블록 크기를 바꿔 가며 쓰고, 링이 가득 차면 남은 샘플을 다시 (버리는 샘플 없이)
+    std::thread producer([&]() {
+        size_t cursor = 0;
+        int block = 1;
+        static float buffer[HARNESS_BLOCK_FRAMES];
+        while (NowSec() - start < seconds) {
+            block = block * 7 % HARNESS_BLOCK_FRAMES + 1;
+            for (int i = 0; i < block; i++) buffer[i] = signal[(cursor + i) % signalFrames];
+            int done = 0;
+            while (done < block) {
+                // 타임스탬프 = 샘플 위치 + 1 (ticksPerSecond = 샘플레이트)
+                int n = AudioPipeline_Write(&pipeline, buffer + done, block - done, (long long)(written + done + 1));
+                done += n;
+                if (done < block) {
+                    fullWaits++;
+                    std::this_thread::yield();
+                }
+            }
+            cursor += block;
+            written += block;
+        }
+        producerDone.store(1, std::memory_order_release);
+    });
+    std::thread dsp([&]() {
+        while (1) {
+            int finished = producerDone.load(std::memory_order_acquire);
+            if (AudioPipeline_Process(&pipeline) == 0) {
+                if (finished && !SpscRing_Available(&pipeline.samples)) break;
+                std::this_thread::yield();
+            }
+        }
+    });
+    std::vector<std::thread> threads;
+    for (int i = 0; i < STRESS_READERS; i++) threads.emplace_back(StressRead, &readers[i]);
+    threads.emplace_back(StressChurn, &pipeline, &stop, &churnCycles, &churnErrors);
+
+    producer.join();
+    dsp.join();
+    stop.store(1);
+    for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+    double wall = NowSec() - start;
+
+    // 같은 입력을 한 스레드에서 다시 처리 (링이 샘플을 빠뜨리거나 섞으면 막대가 달라짐)
+    if (!InitStressPipeline(&replica, &replicaLog, 0)) return 1;
+    static float block[HARNESS_BLOCK_FRAMES];
+    for (unsigned long long done = 0; done < written; done += HARNESS_BLOCK_FRAMES) {
+        int n = written - done < HARNESS_BLOCK_FRAMES ? (int)(written - done) : HARNESS_BLOCK_FRAMES;
+        for (int i = 0; i < n; i++) block[i] = signal[(done + i) % signalFrames];
+        AudioPipeline_Write(&replica, block, n, (long long)(done + 1));
+        AudioPipeline_Process(&replica);
+    }
+
+    int failures = 0;
+    unsigned long long mismatched = 0;
+    if (replicaLog.frames.size() != log.frames.size()) mismatched++;
+    for (size_t i = 0; i < log.frames.size() && i < replicaLog.frames.size(); i++) {
+        if (memcmp(&log.frames[i], &replicaLog.frames[i], sizeof(StressRecord)) != 0) mismatched++;
+    }
+    printf("stress    %.1f s, %llu samples (%llu full-ring waits), %llu frames (%.0f frames/s)\n",
+           wall, written, fullWaits, (unsigned long long)log.frames.size(), log.frames.size() / wall);
+    printf("dsp       %llu gaps, %llu/%llu samples read, %llu/%llu frames differ from a single-thread run\n",
+           log.gaps, pipeline.readPosition, written, mismatched, (unsigned long long)log.frames.size());
+    if (log.gaps || mismatched || pipeline.readPosition != written) failures++;
+
+    unsigned int decimation = (unsigned int)pipeline.consumers[PIPELINE_HANDLE_SLOT(decimatedHandle)]->decimation;
+    printf("reader         reads     misses   frames  backwards  torn\n");
+    for (int i = 0; i < STRESS_READERS; i++) {
+        StressReader* r = &readers[i];
+        unsigned long long torn = 0;
+        for (size_t k = 0; k < r->seen.size(); k++) {
+            const StressObservation* o = &r->seen[k];
+            if (i == STRESS_LATEST || i == STRESS_AT) {
+                if (!MatchRecord(&log, o->sequence, &o->record, 0)) torn++;
+            } else if (i == STRESS_SPECTROGRAM) {
+                if (!MatchRecord(&log, o->sequence, &o->record, 1)) torn++;
+            } else {
+                // 구독 시퀀스 차이만큼 (홉 x 솎음 간격) 샘플 위치가 나아감
+                const StressRecord* main = FindByPosition(&log, o->record.position);
+                unsigned long long step = STRESS_HOP_SIZE * (i == STRESS_DECIMATED ? decimation : 1);
+                int ok = main && main->timestamp == o->record.timestamp;
+                if (i == STRESS_SUBSCRIPTION) ok = ok && main->checksum == o->record.checksum;
+                if (k > 0) {
+                    const StressObservation* prev = &r->seen[k - 1];
+                    ok = ok && o->record.position - prev->record.position == (o->sequence - prev->sequence) * step;
+                }
+                if (!ok) torn++;
+            }
+        }
+        printf("%-12s %9llu  %9llu  %7llu  %9llu  %4llu\n", names[i], r->reads, r->misses,
+               (unsigned long long)r->seen.size(), r->backwards, torn);
+        if (torn || r->backwards || r->seen.empty()) failures++;
+    }
+    printf("churn     %llu subscribe/unsubscribe cycles, %llu bad reads\n", churnCycles, churnErrors);
+    if (churnErrors || churnCycles == 0) failures++;
+
+    AudioPipeline_Free(&pipeline);
+    AudioPipeline_Free(&replica);
+    free(input.data);
+    printf("%s\n", failures ? "stress FAILED" : "stress passed");
+    return failures ? 1 : 0;
+}
+
+// ---------------------------------------------------------------------------
+// 실행
+// ---------------------------------------------------------------------------
+
+static void Usage(void) {
+    fprintf(stderr,
+        "usage: dsp_harness (FILE.wav | --gen SIGNAL) [options]\n"
+        "       dsp_harness --bench-kernels | --check-convert | --check-fft [--kernel NAME]\n"
+        "       dsp_harness --stress SECONDS [--kernel NAME]\n"
+        "\n"
+        "input:\n"
+        "  --gen sine:HZ | sweep:HZ0:HZ1 | noise | clicks:BPM | pads:BPM\n"
+        "  --seconds S        generated length (default 30)\n"
+        "  --rate HZ          generated sample rate (default 48000)\n"
+        "analysis (defaults match the widget):\n"
+        "  --fft N            FFT size 512..8192 (default 2048)\n"
+        "  --hop N            hop size (default 512)\n"
+        "  --bars N           16 / 32 / 64 / 128 (default 16)\n"
+        "  --scale NAME       linear / octave / mel / bark / cqt (default octave)\n"
+        "  --kernel NAME      force a SIMD kernel (scalar / sse2 / avx2 / neon)\n"
+        "  --gate DB          silence gate in dBFS RMS (default -70, 'off' to disable)\n"
+        "  --dual             bars below 300 Hz from a decimated 6-12 kHz stream and a small FFT\n"
+        "  --hpss             harmonic/percussive separation; beat tracking on the percussive part\n"
+        "                     (timed as 'hpss'; harmonic,percussive appended to the CSV)\n"
+        "  --auto-gain S      per-band auto gain over S seconds (default 5, clamped to 1..30,\n"
+        "                     'off' = fixed -60..0 dB)\n"
+        "  --attack MS --release MS --hold MS --gravity G\n"
+        "                     bar envelope and peak markers (default 30 / 30 / 500 / 3)\n"
+        "  --repeat N         process the input N times (timing)\n"
+        "output:\n"
+        "  --csv PATH         frame,time,bar0..barN-1,bpm,phase,confidence,onset\n"
+        "  --peaks            add peak0..peakN-1 after the bars in the CSV\n"
+        "  --features         extract centroid, rolloff, flatness and chroma (timed as 'features';\n"
+        "                     appended to the CSV as centroid,rolloff,flatness,chroma0..chroma11)\n"
+        "  --bin PATH         float32 [bars + 3] per frame (bars, bpm, phase, confidence)\n"
+        "  --subscribe B[:SCALE[:FPS]]\n"
+        "                     add a consumer of the shared FFT (repeatable, up to 8; timed as\n"
+        "                     'fan-out', default scale octave and every hop)\n"
+        "  --spectrogram R[:B] keep the last R frames as B-bar rows (default B = --bars) and\n"
+        "                     report the final two-span view\n"
+        "  --expect-bpm B[:T] exit 1 unless the final tempo is within T bpm (default 2)\n");
+}
+
+static int ParseScale(const char* name) {
+    if (strcmp(name, "linear") == 0) return BAR_SCALE_LINEAR;
+    if (strcmp(name, "octave") == 0) return BAR_SCALE_OCTAVE;
+    if (strcmp(name, "mel") == 0) return BAR_SCALE_MEL;
+    if (strcmp(name, "bark") == 0) return BAR_SCALE_BARK;
+    if (strcmp(name, "cqt") == 0) return BAR_SCALE_CQT;
+    return -1;
+}
+
+int main(int argc, char** argv) {
+    const char* wavPath = NULL;
+    const char* gen = NULL;
+    const char* csvPath = NULL;
+    const char* binPath = NULL;
+    const char* kernel = NULL;
+    double seconds = 30.0;
+    int rate = 48000;
+    int fftSize = 2048, hopSize = 512, barCount = SPECTRUM_BARS, barScale = BAR_SCALE_OCTAVE;
+    int repeat = 1;
+    double expectBpm = 0.0, bpmTolerance = 2.0;
+    float gateDb = PIPELINE_GATE_DEFAULT_DB;
+    float attackMs = PIPELINE_ATTACK_MS, releaseMs = PIPELINE_RELEASE_MS;
+    float holdMs = PIPELINE_PEAK_HOLD_MS, gravity = PIPELINE_PEAK_GRAVITY;
+    int peaks = 0;
+    int features = 0;
+    int dual = 0;
+    int hpss = 0;
+    int autoGain = 1;
+    float gainWindow = PIPELINE_AUTO_GAIN_WINDOW_SEC;
+    int spectrogramRows = 0, spectrogramBars = 0;
+    SpectrumSubscription subscriptions[PIPELINE_MAX_CONSUMERS];
+    int subscriptionCount = 0;
+    int checkFft = 0;
+    double stressSeconds = 0.0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        int takesValue = 1;
+
+        if (strcmp(arg, "--bench-kernels") == 0) return BenchKernels();
+        if (strcmp(arg, "--check-convert") == 0) return CheckConvert();
+
+        if (strcmp(arg, "--gen") == 0 && value) gen = value;
+        else if (strcmp(arg, "--seconds") == 0 && value) seconds = atof(value);
+        else if (strcmp(arg, "--rate") == 0 && value) rate = atoi(value);
+        else if (strcmp(arg, "--fft") == 0 && value) fftSize = atoi(value);
+        else if (strcmp(arg, "--hop") == 0 && value) hopSize = atoi(value);
+        else if (strcmp(arg, "--bars") == 0 && value) barCount = atoi(value);
+        else if (strcmp(arg, "--scale") == 0 && value) barScale = ParseScale(value);
+        else if (strcmp(arg, "--kernel") == 0 && value) kernel = value;
+        else if (strcmp(arg, "--check-fft") == 0) {
+            checkFft = 1;
+            takesValue = 0;
+        }
+        else if (strcmp(arg, "--stress") == 0 && value) stressSeconds = atof(value);
+        else if (strcmp(arg, "--repeat") == 0 && value) repeat = atoi(value);
+        else if (strcmp(arg, "--auto-gain") == 0 && value) {
+            autoGain = strcmp(value, "off") != 0;
+            if (autoGain) gainWindow = (float)atof(value);
+        } else if (strcmp(arg, "--attack") == 0 && value) attackMs = (float)atof(value);
+        else if (strcmp(arg, "--release") == 0 && value) releaseMs = (float)atof(value);
+        else if (strcmp(arg, "--hold") == 0 && value) holdMs = (float)atof(value);
+        else if (strcmp(arg, "--gravity") == 0 && value) gravity = (float)atof(value);
+        else if (strcmp(arg, "--peaks") == 0) {
+            peaks = 1;
+            takesValue = 0;
+        } else if (strcmp(arg, "--dual") == 0) {
+            dual = 1;
+            takesValue = 0;
+        } else if (strcmp(arg, "--hpss") == 0) {
+            hpss = 1;
+            takesValue = 0;
+        } else if (strcmp(arg, "--features") == 0) {
+            features = 1;
+            takesValue = 0;
+        } else if (strcmp(arg, "--gate") == 0 && value) {
+            gateDb = strcmp(value, "off") == 0 ? -1000.0f : (float)atof(value);
+        }
+        else if (strcmp(arg, "--csv") == 0 && value) csvPath = value;
+        else if (strcmp(arg, "--bin") == 0 && value) binPath = value;
+        else if (strcmp(arg, "--subscribe") == 0 && value) {
+            if (subscriptionCount == PIPELINE_MAX_CONSUMERS) {
+                Usage();
+                return 2;
+            }
+            SpectrumSubscription* sub = &subscriptions[subscriptionCount++];
+            char scale[16] = "octave";
+            memset(sub, 0, sizeof(*sub));
+            sub->attackMs = PIPELINE_ATTACK_MS;
+            sub->releaseMs = PIPELINE_RELEASE_MS;
+            if (sscanf(value, "%d:%15[a-z]:%f", &sub->barCount, scale, &sub->rate) < 1) sub->barCount = 0;
+            sub->barScale = ParseScale(scale);
+        }
+        else if (strcmp(arg, "--spectrogram") == 0 && value) {
+            if (sscanf(value, "%d:%d", &spectrogramRows, &spectrogramBars) < 1) spectrogramRows = -1;
+        }
+        else if (strcmp(arg, "--expect-bpm") == 0 && value) {
+            if (sscanf(value, "%lf:%lf", &expectBpm, &bpmTolerance) < 1) expectBpm = 0.0;
+        } else if (arg[0] != '-' && !wavPath) {
+            wavPath = arg;
+            takesValue = 0;
+        } else {
+            Usage();
+            return 2;
+        }
+        if (takesValue) i++;
+    }
+
+    // --check-fft: 입력 없이 검증만 (--kernel이 있으면 그 커널만)
+    if (checkFft) return CheckFft(kernel);
+
+    if (kernel && !DspKernels_Select(kernel)) {
+        fprintf(stderr, "error: kernel '%s' is not available on this CPU\n", kernel);
+        return 2;
+    }
+
+    // --stress: 생산자 / DSP / 읽는 스레드를 SECONDS초 동안 돌리고 연속성 / 찢어진 프레임 검사
+    if (stressSeconds > 0.0) return Stress(stressSeconds);
+
+    if ((!wavPath && !gen) || (wavPath && gen) || barScale < 0 || repeat < 1 || rate <= 0 ||
+        (autoGain && gainWindow <= 0.0f) ||
+        spectrogramRows < 0 || spectrogramRows > SPECTROGRAM_MAX_ROWS ||
+        spectrogramBars < 0 || spectrogramBars > SPECTRUM_MAX_BARS ||
+        !FFT_IsValidSize(fftSize) || hopSize < 1 || hopSize > fftSize ||
+        (barCount != 16 && barCount != 32 && barCount != 64 && barCount != 128)) {
+        Usage();
+        return 2;
+    }
+
+    AudioInput input;
+    if (wavPath ? !LoadWav(wavPath, &input) : !Generate(gen, seconds, rate, &input)) return 1;
+
+    static SampleConverter converter;
+    static AudioPipeline g_pipeline;
+    SampleConverter* cv = &converter;
+    AudioPipeline* pipeline = &g_pipeline;
+    if (!SampleConverter_Init(cv, input.format, input.channels, input.channelMask)) {
+        fprintf(stderr, "error: unsupported channel layout (%d channels)\n", input.channels);
+        return 1;
+    }
+    // 타임스탬프 없이 샘플 위치만 사용 (ticksPerSecond는 쓰이지 않음)
+    if (!AudioPipeline_Init(pipeline, input.sampleRate, 1, fftSize, hopSize, barCount, barScale,
+                            HARNESS_RING_CAPACITY)) {
+        fprintf(stderr, "error: pipeline init failed\n");
+        return 1;
+    }
+
+    FrameSink sink;
+    memset(&sink, 0, sizeof(sink));
+    sink.sampleRate = input.sampleRate;
+    sink.peaks = peaks;
+    sink.features = features;
+    sink.hpss = hpss;
+    if (csvPath) {
+        sink.csv = fopen(csvPath, "w");
+        if (!sink.csv) {
+            fprintf(stderr, "error: cannot write %s\n", csvPath);
+            return 1;
+        }
+        fprintf(sink.csv, "frame,time");
+        for (int i = 0; i < barCount; i++) fprintf(sink.csv, ",bar%d", i);
+        for (int i = 0; peaks && i < barCount; i++) fprintf(sink.csv, ",peak%d", i);
+        fprintf(sink.csv, ",bpm,phase,confidence,onset");
+        if (features) {
+            fprintf(sink.csv, ",centroid,rolloff,flatness");
+            for (int i = 0; i < FEATURE_CHROMA_BINS; i++) fprintf(sink.csv, ",chroma%d", i);
+        }
+        if (hpss) fprintf(sink.csv, ",harmonic,percussive");
+        fprintf(sink.csv, "\n");
+    }
+    if (binPath) {
+        sink.bin = fopen(binPath, "wb");
+        if (!sink.bin) {
+            fprintf(stderr, "error: cannot write %s\n", binPath);
+            return 1;
+        }
+    }
+    AudioPipeline_SetFrameCallback(pipeline, OnFrame, &sink);
+    AudioPipeline_EnableProfiling(pipeline, 1);
+    AudioPipeline_SetGate(pipeline, gateDb);
+    AudioPipeline_SetEnvelope(pipeline, attackMs, releaseMs, holdMs, gravity);
+    AudioPipeline_SetAutoGain(pipeline, autoGain, gainWindow);
+    AudioPipeline_EnableFeatures(pipeline, features);
+    AudioPipeline_SetDualResolution(pipeline, dual);
+    AudioPipeline_EnableHpss(pipeline, hpss);
+    AudioPipeline_SetSpectrogram(pipeline, spectrogramRows, spectrogramBars ? spectrogramBars : barCount);
+    int handles[PIPELINE_MAX_CONSUMERS];
+    for (int i = 0; i < subscriptionCount; i++) {
+        handles[i] = AudioPipeline_Subscribe(pipeline, &subscriptions[i]);
+        if (!handles[i]) {
+            fprintf(stderr, "error: invalid --subscribe %d\n", i + 1);
+            return 2;
+        }
+    }
+
+    static float mono[HARNESS_BLOCK_FRAMES];
+    double convertSec = 0.0;
+    double start = NowSec();
+
+    for (int r = 0; r < repeat; r++) {
+        for (size_t done = 0; done < input.frames; done += HARNESS_BLOCK_FRAMES) {
+            size_t left = input.frames - done;
+            int n = left < HARNESS_BLOCK_FRAMES ? (int)left : HARNESS_BLOCK_FRAMES;
+
+            double t0 = NowSec();
+            SampleConverter_Run(cv, input.data + done * cv->bytesPerFrame, mono, n);
+            convertSec += NowSec() - t0;
+
+            AudioPipeline_Write(pipeline, mono, n, 0);
+            AudioPipeline_Process(pipeline);
+        }
+    }
+
+    double wall = NowSec() - start;
+    double audioSec = (double)input.frames * repeat / input.sampleRate;
+    const PipelineStats* stats = &pipeline->stats;
+    double frames = stats->frames ? (double)stats->frames : 1.0;
+
+    printf("input     %s (%s, %d ch, %d Hz, %.2f s)\n", wavPath ? wavPath : gen,
+           SampleFormat_Name(input.format), input.channels, input.sampleRate,
+           (double)input.frames / input.sampleRate);
+    printf("config    fft %d, hop %d, %d bars (%s scale), kernel %s\n", fftSize, hopSize, barCount,
+           barScale == BAR_SCALE_LINEAR ? "linear" : barScale == BAR_SCALE_OCTAVE ? "octave" :
+           barScale == BAR_SCALE_MEL ? "mel" : barScale == BAR_SCALE_BARK ? "bark" : "cqt",
+           DspKernels_Get()->name);
+    printf("frames    %llu in %.3f s (%.0f frames/s, %.1fx realtime)\n", stats->frames, wall,
+           stats->frames / wall, audioSec / wall);
+    printf("stage     us/frame  share\n");
+
+    double total = convertSec * 1e9 + stats->stftNs + stats->gateNs + stats->fftNs +
+                   stats->barsNs + stats->beatNs + stats->featuresNs + stats->bassNs +
+                   stats->hpssNs + stats->publishNs + stats->consumersNs;
+    if (total <= 0.0) total = 1.0;
+    const struct { const char* name; double ns; } stages[] = {
+        { "convert", convertSec * 1e9 }, { "stft", stats->stftNs }, { "gate", stats->gateNs },
+        { "fft", stats->fftNs }, { "bass", stats->bassNs },
+        { "bars", stats->barsNs }, { "hpss", stats->hpssNs }, { "beat", stats->beatNs }, { "features", stats->featuresNs },
+        { "publish", stats->publishNs }, { "fan-out", stats->consumersNs }
+    };
+    for (int i = 0; i < (int)(sizeof(stages) / sizeof(stages[0])); i++) {
+        printf("  %-8s %8.2f  %5.1f%%\n", stages[i].name, stages[i].ns / frames / 1000.0,
+               100.0 * stages[i].ns / total);
+    }
+    if (pipeline->cqt) {
+        const ConstantQKernel* cqt = pipeline->cqt;
+        printf("cqt       %d bins/octave from %.1f Hz, %d kernel entries (%.1f per bar), full Q from %.0f Hz\n",
+               cqt->binsPerOctave, cqt->minFreq, cqt->nonZero, (float)cqt->nonZero / cqt->binCount,
+               ConstantQ_BinFrequency(cqt, cqt->fullQ));
+    }
+    if (pipeline->bassBars > 0) {
+        printf("bass      bars 0-%d from %d Hz (%d decimation stages), fft %d (%.1f Hz bins)\n",
+               pipeline->bassBars - 1, pipeline->bassRate, pipeline->decimator.stages,
+               pipeline->bassFftSize, (float)pipeline->bassRate / pipeline->bassFftSize);
+    } else if (dual) {
+        printf("bass      not used (no bar lies entirely below %.0f Hz)\n", PIPELINE_BASS_CROSSOVER_HZ);
+    }
+    if (features) {
+        // 막대만 계산할 때 (fft + bars) 대비 추가 비용
+        double barsOnly = stats->fftNs + stats->barsNs;
+        printf("features  +%.2f us/frame, %.1f%% over bars-only (fft + bars)\n",
+               stats->featuresNs / frames / 1000.0,
+               barsOnly > 0.0 ? 100.0 * stats->featuresNs / barsOnly : 0.0);
+    }
+    if (hpss) {
+        // 실시간 예산 대비 (FFT 크기에 거의 비례: 빈마다 두 중앙값 갱신)
+        double us = stats->hpssNs / frames / 1000.0;
+        double sinkFrames = sink.frames ? (double)sink.frames : 1.0;
+        printf("hpss      +%.2f us/frame (budget %.0f us, %s), %dx%d medians, mean harmonic %.2f / percussive %.2f\n",
+               us, PIPELINE_HPSS_BUDGET_US, us <= PIPELINE_HPSS_BUDGET_US ? "ok" : "over",
+               pipeline->separator.frames, pipeline->separator.bins,
+               sink.harmonicSum / sinkFrames, sink.percussiveSum / sinkFrames);
+    }
+    for (int i = 0; i < subscriptionCount; i++) {
+        // 구독자는 자기 막대만 계산: 메인 FFT 한 번을 모두가 공유
+        SpectrumFrame frame;
+        float loudest = 0.0f;
+        int ok = AudioPipeline_ReadSubscription(pipeline, handles[i], &frame);
+        int slot = PIPELINE_HANDLE_SLOT(handles[i]);
+        if (ok < 0) {
+            printf("consumer  #%d %d bars: failed to build its bar table\n", slot + 1, subscriptions[i].barCount);
+            continue;
+        }
+        for (int b = 0; ok && b < frame.barCount; b++) {
+            if (frame.spectrum.bars[b] > loudest) loudest = frame.spectrum.bars[b];
+        }
+        const PipelineConsumer* c = pipeline->consumers[slot];
+        printf("consumer  #%d %d bars, every %d hop(s), %llu frames, loudest bar %.2f\n",
+               slot + 1, subscriptions[i].barCount, c->decimation,
+               ok ? frame.sequence : 0ULL, loudest);
+    }
+    if (subscriptionCount > 0) {
+        printf("fan-out   +%.2f us/frame for %d consumer(s) on one FFT (fft %.2f us/frame)\n",
+               stats->consumersNs / frames / 1000.0, subscriptionCount, stats->fftNs / frames / 1000.0);
+    }
+    if (spectrogramRows > 0) {
+        SpectrogramView view;
+        int rows = Spectrogram_Read(&pipeline->spectrogram, 0, &view);
+        printf("spectrogram %d rows x %d bars (%.0f KB ring), view %d + %d rows, %s\n",
+               rows, view.barCount,
+               (double)pipeline->spectrogram.capacity.load() * view.barCount * sizeof(float) / 1024.0,
+               view.firstRows, view.secondRows,
+               Spectrogram_Validate(&pipeline->spectrogram, &view) ? "valid" : "overwritten");
+    }
+    printf("gated     %llu frames skipped the FFT, %llu gate openings\n",
+           (unsigned long long)pipeline->gatedFrames.load(),
+           (unsigned long long)pipeline->gateOpenings.load());
+    if (pipeline->droppedSamples.load()) {
+        printf("dropped   %llu samples\n", (unsigned long long)pipeline->droppedSamples.load());
+    }
+    printf("tempo     %.2f bpm (confidence %.2f, %llu beats)\n", sink.lastBeat.bpm,
+           sink.lastBeat.confidence, sink.lastBeat.beatCount);
+    if (binPath) printf("binary    %d floats per frame (%d bars + bpm, phase, confidence)\n",
+                        barCount + 3, barCount);
+
+    int result = 0;
+    if (expectBpm > 0.0) {
+        double error = fabs(sink.lastBeat.bpm - expectBpm);
+        result = error <= bpmTolerance ? 0 : 1;
+        printf("expect    %.2f +/- %.2f bpm: %s\n", expectBpm, bpmTolerance, result ? "FAIL" : "ok");
+    }
+
+    if (sink.csv) fclose(sink.csv);
+    if (sink.bin) fclose(sink.bin);
+    AudioPipeline_Free(pipeline);
+    free(input.data);
+    return result;
+}
@@ -0,0 +1,1108 @@
+/*
+ * dsp_kernels.cpp - SIMD DSP Kernels
+ * 스칼라 구현을 기준으로 SSE2 / AVX2 / NEON 버전을 두고 CPU 기능으로 선택
+ */
+
+#include "dsp_kernels.h"
+
+#include <string.h>
+#include <math.h>
+
+#include <atomic>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define DSP_ARCH_X86 1
+#include <emmintrin.h>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define DSP_TARGET_AVX2
+#else
+#define DSP_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+#define DSP_ARCH_NEON 1
+#include <arm_neon.h>
+#endif
+
+// 20 / ln(10): 자연로그 -> dB
+#define DB_PER_NEPER 8.685889638065037f
+
+// 정수 PCM 정규화 배율
+#define INT16_SCALE (1.0f / 32768.0f)
+#define INT32_SCALE (1.0f / 2147483648.0f)
+
+// ---------------------------------------------------------------------------
+// 스칼라
+// ---------------------------------------------------------------------------
+
+static void Downmix_Scalar(const float* in, float* mono, int frames, int channels) {
+    if (channels == 1) {
+        memcpy(mono, in, sizeof(float) * frames);
+        return;
+    }
+    float inv = 1.0f / channels;
+    for (int i = 0; i < frames; i++) {
+        float sum = 0.0f;
+        for (int ch = 0; ch < channels; ch++) {
+            sum += in[i * channels + ch];
+        }
+        mono[i] = sum * inv;
+    }
+}
+
+static void ApplyWindow_Scalar(const float* in, const float* window, float* out, int count) {
+    for (int i = 0; i < count; i++) {
+        out[i] = in[i] * window[i];
+    }
+}
+
+static void ComplexMultiply_Scalar(const float* a, const float* b, float* out, int count) {
+    for (int k = 0; k < count; k++) {
+        float ar = a[2 * k], ai = a[2 * k + 1];
+        float br = b[2 * k], bi = b[2 * k + 1];
+        out[2 * k] = ar * br - ai * bi;
+        out[2 * k + 1] = ar * bi + ai * br;
+    }
+}
+
+static void Butterfly_Scalar(float* a, float* b, const float* w, int count) {
+    for (int k = 0; k < count; k++) {
+        float br = b[2 * k], bi = b[2 * k + 1];
+        float wr = w[2 * k], wi = w[2 * k + 1];
+        float tr = br * wr - bi * wi;
+        float ti = br * wi + bi * wr;
+        b[2 * k] = a[2 * k] - tr;
+        b[2 * k + 1] = a[2 * k + 1] - ti;
+        a[2 * k] += tr;
+        a[2 * k + 1] += ti;
+    }
+}
+
+static void Magnitude_Scalar(const float* c, float* out, int count, float scale) {
+    for (int k = 0; k < count; k++) {
+        float re = c[2 * k], im = c[2 * k + 1];
+        out[k] = sqrtf(re * re + im * im) * scale;
+    }
+}
+
+static void ToDecibels_Scalar(const float* in, float* out, int count, float floor) {
+    for (int i = 0; i < count; i++) {
+        out[i] = 20.0f * log10f(in[i] + floor);
+    }
+}
+
+static void Int16ToFloat_Scalar(const short* in, float* out, int count) {
+    for (int i = 0; i < count; i++) {
+        out[i] = in[i] * INT16_SCALE;
+    }
+}
+
+static void Int32ToFloat_Scalar(const int* in, float* out, int count) {
+    for (int i = 0; i < count; i++) {
+        out[i] = (float)in[i] * INT32_SCALE;
+    }
+}
+
+static void Envelope_Scalar(float* value, const float* target, int count, float attack, float release) {
+    for (int i = 0; i < count; i++) {
+        float d = target[i] - value[i];
+        value[i] += d * (d > 0.0f ? attack : release);
+    }
+}
+
+static void PeakHold_Scalar(float* peak, float* hold, float* velocity, const float* value, int count,
+                            float dt, float holdTime, float gravity) {
+    for (int i = 0; i < count; i++) {
+        float v = value[i];
+        if (v >= peak[i]) {
+            peak[i] = v;
+            hold[i] = holdTime;
+            velocity[i] = 0.0f;
+        } else if (hold[i] > 0.0f) {
+            float h = hold[i] - dt;
+            hold[i] = h > 0.0f ? h : 0.0f;
+        } else {
+            velocity[i] += gravity * dt;
+            float p = peak[i] - velocity[i] * dt;
+            peak[i] = p > v ? p : v;
+        }
+    }
+}
+
+static void PaletteExpand_Scalar(const unsigned char* indices, const unsigned int* palette, unsigned int* out,
+                                 int count) {
+    for (int i = 0; i < count; i++) {
+        out[i] = palette[indices[i]];
+    }
+}
+
+static void PaletteComposite_Scalar(const unsigned char* indices, const unsigned int* palette, unsigned int* out,
+                                    int count, int transparent) {
+    for (int i = 0; i < count; i++) {
+        if (indices[i] != transparent) out[i] = palette[indices[i]];
+    }
+}
+
+static const DspKernels g_scalarKernels = {
+    "scalar",
+    Downmix_Scalar,
+    ApplyWindow_Scalar,
+    ComplexMultiply_Scalar,
+    Butterfly_Scalar,
+    Magnitude_Scalar,
+    ToDecibels_Scalar,
+    Int16ToFloat_Scalar,
+    Int32ToFloat_Scalar,
+    Envelope_Scalar,
+    PeakHold_Scalar,
+    PaletteExpand_Scalar,
+    PaletteComposite_Scalar
+};
+
+#if defined(DSP_ARCH_X86)
+
+// ---------------------------------------------------------------------------
+// SSE2
+// ---------------------------------------------------------------------------
+
+// 자연로그 근사 (cephes logf 다항식, x > 0)
+static inline __m128 Log_SSE2(__m128 x) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    __m128i xi = _mm_castps_si128(x);
+    __m128i expBits = _mm_srli_epi32(xi, 23);
+    __m128 e = _mm_cvtepi32_ps(_mm_sub_epi32(expBits, _mm_set1_epi32(126)));
+
+    // 가수부를 [0.5, 1) 로
+    xi = _mm_and_si128(xi, _mm_set1_epi32(0x007FFFFF));
+    xi = _mm_or_si128(xi, _mm_set1_epi32(0x3F000000));
+    x = _mm_castsi128_ps(xi);
+
+    // x < sqrt(1/2) 이면 x *= 2, e -= 1
+    __m128 mask = _mm_cmplt_ps(x, _mm_set1_ps(0.707106781186547524f));
+    __m128 tmp = _mm_and_ps(x, mask);
+    x = _mm_sub_ps(x, one);
+    e = _mm_sub_ps(e, _mm_and_ps(one, mask));
+    x = _mm_add_ps(x, tmp);
+
+    __m128 z = _mm_mul_ps(x, x);
+    __m128 y = _mm_set1_ps(7.0376836292E-2f);
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-1.1514610310E-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.1676998740E-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-1.2420140846E-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.4249322787E-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-1.6668057665E-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(2.0000714765E-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-2.4999993993E-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(3.3333331174E-1f));
+    y = _mm_mul_ps(_mm_mul_ps(y, x), z);
+
+    y = _mm_add_ps(y, _mm_mul_ps(e, _mm_set1_ps(-2.12194440e-4f)));
+    y = _mm_sub_ps(y, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+    x = _mm_add_ps(x, y);
+    x = _mm_add_ps(x, _mm_mul_ps(e, _mm_set1_ps(0.693359375f)));
+    return x;
+}
+
+// (r0,i0,r1,i1) * (wr0,wi0,wr1,wi1)
+static inline __m128 ComplexMul_SSE2(__m128 b, __m128 w) {
+    const __m128 signMask = _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f);
+    __m128 br = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 2, 0, 0));
+    __m128 bi = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 1, 1));
+    __m128 ws = _mm_shuffle_ps(w, w, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_add_ps(_mm_mul_ps(br, w), _mm_xor_ps(_mm_mul_ps(bi, ws), signMask));
+}
+
+static void Downmix_SSE2(const float* in, float* mono, int frames, int channels) {
+    if (channels != 2) {
+        Downmix_Scalar(in, mono, frames, channels);
+        return;
+    }
+    const __m128 half = _mm_set1_ps(0.5f);
+    int i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        __m128 v0 = _mm_loadu_ps(in + 2 * i);
+        __m128 v1 = _mm_loadu_ps(in + 2 * i + 4);
+        __m128 l = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 r = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(mono + i, _mm_mul_ps(_mm_add_ps(l, r), half));
+    }
+    Downmix_Scalar(in + 2 * i, mono + i, frames - i, 2);
+}
+
+static void ApplyWindow_SSE2(const float* in, const float* window, float* out, int count) {
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(in + i), _mm_loadu_ps(window + i)));
+    }
+    ApplyWindow_Scalar(in + i, window + i, out + i, count - i);
+}
+
+static void ComplexMultiply_SSE2(const float* a, const float* b, float* out, int count) {
+    int k = 0;
+    for (; k + 2 <= count; k += 2) {
+        __m128 va = _mm_loadu_ps(a + 2 * k);
+        __m128 vb = _mm_loadu_ps(b + 2 * k);
+        _mm_storeu_ps(out + 2 * k, ComplexMul_SSE2(va, vb));
+    }
+    ComplexMultiply_Scalar(a + 2 * k, b + 2 * k, out + 2 * k, count - k);
+}
+
+static void Butterfly_SSE2(float* a, float* b, const float* w, int count) {
+    int k = 0;
+    for (; k + 2 <= count; k += 2) {
+        __m128 va = _mm_loadu_ps(a + 2 * k);
+        __m128 t = ComplexMul_SSE2(_mm_loadu_ps(b + 2 * k), _mm_loadu_ps(w + 2 * k));
+        _mm_storeu_ps(b + 2 * k, _mm_sub_ps(va, t));
+        _mm_storeu_ps(a + 2 * k, _mm_add_ps(va, t));
+    }
+    Butterfly_Scalar(a + 2 * k, b + 2 * k, w + 2 * k, count - k);
+}
+
+static void Magnitude_SSE2(const float* c, float* out, int count, float scale) {
+    const __m128 vs = _mm_set1_ps(scale);
+    int k = 0;
+    for (; k + 4 <= count; k += 4) {
+        __m128 v0 = _mm_loadu_ps(c + 2 * k);
+        __m128 v1 = _mm_loadu_ps(c + 2 * k + 4);
+        v0 = _mm_mul_ps(v0, v0);
+        v1 = _mm_mul_ps(v1, v1);
+        __m128 re2 = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 im2 = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(out + k, _mm_mul_ps(_mm_sqrt_ps(_mm_add_ps(re2, im2)), vs));
+    }
+    Magnitude_Scalar(c + 2 * k, out + k, count - k, scale);
+}
+
+static void ToDecibels_SSE2(const float* in, float* out, int count, float floor) {
+    const __m128 vf = _mm_set1_ps(floor);
+    const __m128 vdb = _mm_set1_ps(DB_PER_NEPER);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 v = _mm_add_ps(_mm_loadu_ps(in + i), vf);
+        _mm_storeu_ps(out + i, _mm_mul_ps(Log_SSE2(v), vdb));
+    }
+    ToDecibels_Scalar(in + i, out + i, count - i, floor);
+}
+
+static void Int16ToFloat_SSE2(const short* in, float* out, int count) {
+    const __m128 scale = _mm_set1_ps(INT16_SCALE);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+        // 상위 16비트에 놓고 산술 시프트로 부호 확장
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+    Int16ToFloat_Scalar(in + i, out + i, count - i);
+}
+
+static void Int32ToFloat_SSE2(const int* in, float* out, int count) {
+    const __m128 scale = _mm_set1_ps(INT32_SCALE);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+    }
+    Int32ToFloat_Scalar(in + i, out + i, count - i);
+}
+
+// mask ? a : b
+static inline __m128 Select_SSE2(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static void Envelope_SSE2(float* value, const float* target, int count, float attack, float release) {
+    const __m128 va = _mm_set1_ps(attack);
+    const __m128 vr = _mm_set1_ps(release);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 v = _mm_loadu_ps(value + i);
+        __m128 d = _mm_sub_ps(_mm_loadu_ps(target + i), v);
+        __m128 k = Select_SSE2(_mm_cmpgt_ps(d, _mm_setzero_ps()), va, vr);
+        _mm_storeu_ps(value + i, _mm_add_ps(v, _mm_mul_ps(d, k)));
+    }
+    Envelope_Scalar(value + i, target + i, count - i, attack, release);
+}
+
+static void PeakHold_SSE2(float* peak, float* hold, float* velocity, const float* value, int count,
+                          float dt, float holdTime, float gravity) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 vhold = _mm_set1_ps(holdTime);
+    const __m128 vgdt = _mm_set1_ps(gravity * dt);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 v = _mm_loadu_ps(value + i);
+        __m128 p = _mm_loadu_ps(peak + i);
+        __m128 h = _mm_loadu_ps(hold + i);
+        __m128 vel = _mm_loadu_ps(velocity + i);
+
+        __m128 rise = _mm_cmpge_ps(v, p);
+        __m128 fall = _mm_andnot_ps(rise, _mm_cmple_ps(h, zero));
+
+        __m128 newVel = _mm_add_ps(vel, _mm_and_ps(fall, vgdt));
+        __m128 fallen = _mm_max_ps(_mm_sub_ps(p, _mm_mul_ps(newVel, vdt)), v);
+
+        _mm_storeu_ps(peak + i, Select_SSE2(rise, v, Select_SSE2(fall, fallen, p)));
+        _mm_storeu_ps(hold + i, Select_SSE2(rise, vhold, _mm_max_ps(_mm_sub_ps(h, vdt), zero)));
+        _mm_storeu_ps(velocity + i, _mm_andnot_ps(rise, newVel));
+    }
+    PeakHold_Scalar(peak + i, hold + i, velocity + i, value + i, count - i, dt, holdTime, gravity);
+}
+
+// SSE2에는 gather가 없어서 조회는 스칼라로 4개씩 모으고, 같은 색 구간 / 투명 구간 판정과 섞기만 벡터로
+static inline __m128i Lookup4_SSE2(const unsigned char* indices, const unsigned int* palette) {
+    return _mm_setr_epi32((int)palette[indices[0]], (int)palette[indices[1]],
+                          (int)palette[indices[2]], (int)palette[indices[3]]);
+}
+
+// 인덱스 16개 -> 색 16개 (모두 같은 인덱스면 한 색으로 채움: GIF는 같은 색이 길게 이어지는 경우가 많음)
+static inline void Expand16_SSE2(const unsigned char* indices, __m128i v, const unsigned int* palette,
+                                 unsigned int* out) {
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8((char)indices[0]))) == 0xFFFF) {
+        __m128i c = _mm_set1_epi32((int)palette[indices[0]]);
+        for (int j = 0; j < 16; j += 4) _mm_storeu_si128((__m128i*)(out + j), c);
+        return;
+    }
+    for (int j = 0; j < 16; j += 4) {
+        _mm_storeu_si128((__m128i*)(out + j), Lookup4_SSE2(indices + j, palette));
+    }
+}
+
+static void PaletteExpand_SSE2(const unsigned char* indices, const unsigned int* palette, unsigned int* out,
+                               int count) {
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        Expand16_SSE2(indices + i, _mm_loadu_si128((const __m128i*)(indices + i)), palette, out + i);
+    }
+    PaletteExpand_Scalar(indices + i, palette, out + i, count - i);
+}
+
+static void PaletteComposite_SSE2(const unsigned char* indices, const unsigned int* palette, unsigned int* out,
+                                  int count, int transparent) {
+    if (transparent < 0 || transparent > 255) {
+        PaletteExpand_SSE2(indices, palette, out, count);
+        return;
+    }
+    const __m128i vt = _mm_set1_epi8((char)transparent);
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(indices + i));
+        __m128i skip = _mm_cmpeq_epi8(v, vt);
+        int mask = _mm_movemask_epi8(skip);
+        if (mask == 0xFFFF) continue;  // 전부 투명: 캔버스를 읽지도 않음
+        if (mask == 0) {
+            Expand16_SSE2(indices + i, v, palette, out + i);
+            continue;
+        }
+
+        // 섞임: 바이트 마스크를 픽셀(32비트) 마스크로 넓혀서 기존 캔버스와 섞음
+        __m128i lo = _mm_unpacklo_epi8(skip, skip);
+        __m128i hi = _mm_unpackhi_epi8(skip, skip);
+        __m128i m[4] = { _mm_unpacklo_epi16(lo, lo), _mm_unpackhi_epi16(lo, lo),
+                         _mm_unpacklo_epi16(hi, hi), _mm_unpackhi_epi16(hi, hi) };
+        for (int j = 0; j < 4; j++) {
+            __m128i* dst = (__m128i*)(out + i + 4 * j);
+            __m128i c = Lookup4_SSE2(indices + i + 4 * j, palette);
+            _mm_storeu_si128(dst, _mm_or_si128(_mm_and_si128(m[j], _mm_loadu_si128(dst)), _mm_andnot_si128(m[j], c)));
+        }
+    }
+    PaletteComposite_Scalar(indices + i, palette, out + i, count - i, transparent);
+}
+
+static const DspKernels g_sse2Kernels = {
+    "sse2",
+    Downmix_SSE2,
+    ApplyWindow_SSE2,
+    ComplexMultiply_SSE2,
+    Butterfly_SSE2,
+    Magnitude_SSE2,
+    ToDecibels_SSE2,
+    Int16ToFloat_SSE2,
+    Int32ToFloat_SSE2,
+    Envelope_SSE2,
+    PeakHold_SSE2,
+    PaletteExpand_SSE2,
+    PaletteComposite_SSE2
+};
+
+// ---------------------------------------------------------------------------
+// AVX2
+// ---------------------------------------------------------------------------
+
+DSP_TARGET_AVX2
+static inline __m256 Log_AVX2(__m256 x) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    __m256i xi = _mm256_castps_si256(x);
+    __m256i expBits = _mm256_srli_epi32(xi, 23);
+    __m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(expBits, _mm256_set1_epi32(126)));
+
+    xi = _mm256_and_si256(xi, _mm256_set1_epi32(0x007FFFFF));
+    xi = _mm256_or_si256(xi, _mm256_set1_epi32(0x3F000000));
+    x = _mm256_castsi256_ps(xi);
+
+    __m256 mask = _mm256_cmp_ps(x, _mm256_set1_ps(0.707106781186547524f), _CMP_LT_OS);
+    __m256 tmp = _mm256_and_ps(x, mask);
+    x = _mm256_sub_ps(x, one);
+    e = _mm256_sub_ps(e, _mm256_and_ps(one, mask));
+    x = _mm256_add_ps(x, tmp);
+
+    __m256 z = _mm256_mul_ps(x, x);
+    __m256 y = _mm256_set1_ps(7.0376836292E-2f);
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(-1.1514610310E-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(1.1676998740E-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(-1.2420140846E-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(1.4249322787E-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(-1.6668057665E-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(2.0000714765E-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(-2.4999993993E-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(3.3333331174E-1f));
+    y = _mm256_mul_ps(_mm256_mul_ps(y, x), z);
+
+    y = _mm256_add_ps(y, _mm256_mul_ps(e, _mm256_set1_ps(-2.12194440e-4f)));
+    y = _mm256_sub_ps(y, _mm256_mul_ps(z, _mm256_set1_ps(0.5f)));
+    x = _mm256_add_ps(x, y);
+    x = _mm256_add_ps(x, _mm256_mul_ps(e, _mm256_set1_ps(0.693359375f)));
+    return x;
+}
+
+DSP_TARGET_AVX2
+static inline __m256 ComplexMul_AVX2(__m256 b, __m256 w) {
+    __m256 br = _mm256_moveldup_ps(b);
+    __m256 bi = _mm256_movehdup_ps(b);
+    __m256 ws = _mm256_permute_ps(w, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm256_addsub_ps(_mm256_mul_ps(br, w), _mm256_mul_ps(bi, ws));
+}
+
+// 레인 내 셔플 결과 (0,1,4,5,2,3,6,7) 를 (0..7) 순서로
+DSP_TARGET_AVX2
+static inline __m256 FixLaneOrder_AVX2(__m256 v) {
+    return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(v), _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+DSP_TARGET_AVX2
+static void Downmix_AVX2(const float* in, float* mono, int frames, int channels) {
+    if (channels != 2) {
+        Downmix_Scalar(in, mono, frames, channels);
+        return;
+    }
+    const __m256 half = _mm256_set1_ps(0.5f);
+    int i = 0;
+    for (; i + 8 <= frames; i += 8) {
+        __m256 v0 = _mm256_loadu_ps(in + 2 * i);
+        __m256 v1 = _mm256_loadu_ps(in + 2 * i + 8);
+        __m256 l = _mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 r = _mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1));
+        __m256 m = _mm256_mul_ps(_mm256_add_ps(l, r), half);
+        _mm256_storeu_ps(mono + i, FixLaneOrder_AVX2(m));
+    }
+    Downmix_SSE2(in + 2 * i, mono + i, frames - i, 2);
+}
+
+DSP_TARGET_AVX2
+static void ApplyWindow_AVX2(const float* in, const float* window, float* out, int count) {
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_loadu_ps(in + i), _mm256_loadu_ps(window + i)));
+    }
+    ApplyWindow_Scalar(in + i, window + i, out + i, count - i);
+}
+
+DSP_TARGET_AVX2
+static void ComplexMultiply_AVX2(const float* a, const float* b, float* out, int count) {
+    int k = 0;
+    for (; k + 4 <= count; k += 4) {
+        __m256 va = _mm256_loadu_ps(a + 2 * k);
+        __m256 vb = _mm256_loadu_ps(b + 2 * k);
+        _mm256_storeu_ps(out + 2 * k, ComplexMul_AVX2(va, vb));
+    }
+    ComplexMultiply_Scalar(a + 2 * k, b + 2 * k, out + 2 * k, count - k);
+}
+
+DSP_TARGET_AVX2
+static void Butterfly_AVX2(float* a, float* b, const float* w, int count) {
+    int k = 0;
+    for (; k + 4 <= count; k += 4) {
+        __m256 va = _mm256_loadu_ps(a + 2 * k);
+        __m256 t = ComplexMul_AVX2(_mm256_loadu_ps(b + 2 * k), _mm256_loadu_ps(w + 2 * k));
+        _mm256_storeu_ps(b + 2 * k, _mm256_sub_ps(va, t));
+        _mm256_storeu_ps(a + 2 * k, _mm256_add_ps(va, t));
+    }
+    Butterfly_SSE2(a + 2 * k, b + 2 * k, w + 2 * k, count - k);
+}
+
+DSP_TARGET_AVX2
+static void Magnitude_AVX2(const float* c, float* out, int count, float scale) {
+    const __m256 vs = _mm256_set1_ps(scale);
+    int k = 0;
+    for (; k + 8 <= count; k += 8) {
+        __m256 v0 = _mm256_loadu_ps(c + 2 * k);
+        __m256 v1 = _mm256_loadu_ps(c + 2 * k + 8);
+        v0 = _mm256_mul_ps(v0, v0);
+        v1 = _mm256_mul_ps(v1, v1);
+        __m256 re2 = _mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 im2 = _mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1));
+        __m256 m = _mm256_mul_ps(_mm256_sqrt_ps(_mm256_add_ps(re2, im2)), vs);
+        _mm256_storeu_ps(out + k, FixLaneOrder_AVX2(m));
+    }
+    Magnitude_SSE2(c + 2 * k, out + k, count - k, scale);
+}
+
+DSP_TARGET_AVX2
+static void ToDecibels_AVX2(const float* in, float* out, int count, float floor) {
+    const __m256 vf = _mm256_set1_ps(floor);
+    const __m256 vdb = _mm256_set1_ps(DB_PER_NEPER);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 v = _mm256_add_ps(_mm256_loadu_ps(in + i), vf);
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(Log_AVX2(v), vdb));
+    }
+    ToDecibels_SSE2(in + i, out + i, count - i, floor);
+}
+
+DSP_TARGET_AVX2
+static void Int16ToFloat_AVX2(const short* in, float* out, int count) {
+    const __m256 scale = _mm256_set1_ps(INT16_SCALE);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(in + i)));
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+    }
+    Int16ToFloat_SSE2(in + i, out + i, count - i);
+}
+
+DSP_TARGET_AVX2
+static void Int32ToFloat_AVX2(const int* in, float* out, int count) {
+    const __m256 scale = _mm256_set1_ps(INT32_SCALE);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(in + i));
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+    }
+    Int32ToFloat_SSE2(in + i, out + i, count - i);
+}
+
+DSP_TARGET_AVX2
+static void Envelope_AVX2(float* value, const float* target, int count, float attack, float release) {
+    const __m256 va = _mm256_set1_ps(attack);
+    const __m256 vr = _mm256_set1_ps(release);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 v = _mm256_loadu_ps(value + i);
+        __m256 d = _mm256_sub_ps(_mm256_loadu_ps(target + i), v);
+        __m256 k = _mm256_blendv_ps(vr, va, _mm256_cmp_ps(d, _mm256_setzero_ps(), _CMP_GT_OQ));
+        _mm256_storeu_ps(value + i, _mm256_add_ps(v, _mm256_mul_ps(d, k)));
+    }
+    Envelope_SSE2(value + i, target + i, count - i, attack, release);
+}
+
+DSP_TARGET_AVX2
+static void PeakHold_AVX2(float* peak, float* hold, float* velocity, const float* value, int count,
+                          float dt, float holdTime, float gravity) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 vdt = _mm256_set1_ps(dt);
+    const __m256 vhold = _mm256_set1_ps(holdTime);
+    const __m256 vgdt = _mm256_set1_ps(gravity * dt);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 v = _mm256_loadu_ps(value + i);
+        __m256 p = _mm256_loadu_ps(peak + i);
+        __m256 h = _mm256_loadu_ps(hold + i);
+        __m256 vel = _mm256_loadu_ps(velocity + i);
+
+        __m256 rise = _mm256_cmp_ps(v, p, _CMP_GE_OQ);
+        __m256 fall = _mm256_andnot_ps(rise, _mm256_cmp_ps(h, zero, _CMP_LE_OQ));
+
+        __m256 newVel = _mm256_add_ps(vel, _mm256_and_ps(fall, vgdt));
+        __m256 fallen = _mm256_max_ps(_mm256_sub_ps(p, _mm256_mul_ps(newVel, vdt)), v);
+
+        _mm256_storeu_ps(peak + i, _mm256_blendv_ps(_mm256_blendv_ps(p, fallen, fall), v, rise));
+        _mm256_storeu_ps(hold + i, _mm256_blendv_ps(_mm256_max_ps(_mm256_sub_ps(h, vdt), zero), vhold, rise));
+        _mm256_storeu_ps(velocity + i, _mm256_andnot_ps(rise, newVel));
+    }
+    PeakHold_SSE2(peak + i, hold + i, velocity + i, value + i, count - i, dt, holdTime, gravity);
+}
+
+// 팔레트 앞 16색을 바이트 평면 4개로 (B, G, R, A 각각 16바이트, 두 128비트 레인에 같은 값)
+// 인덱스가 모두 16 미만인 구간은 gather 대신 pshufb 네 번으로 조회
+DSP_TARGET_AVX2
+static inline void PalettePlanes_AVX2(const unsigned int* palette, __m256i* planes) {
+    const __m128i split = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+    __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(palette + 0)), split);
+    __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(palette + 4)), split);
+    __m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(palette + 8)), split);
+    __m128i p3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(palette + 12)), split);
+    // 4x4 (32비트) 전치
+    __m128i t0 = _mm_unpacklo_epi32(p0, p1);
+    __m128i t1 = _mm_unpackhi_epi32(p0, p1);
+    __m128i t2 = _mm_unpacklo_epi32(p2, p3);
+    __m128i t3 = _mm_unpackhi_epi32(p2, p3);
+    planes[0] = _mm256_broadcastsi128_si256(_mm_unpacklo_epi64(t0, t2));
+    planes[1] = _mm256_broadcastsi128_si256(_mm_unpackhi_epi64(t0, t2));
+    planes[2] = _mm256_broadcastsi128_si256(_mm_unpacklo_epi64(t1, t3));
+    planes[3] = _mm256_broadcastsi128_si256(_mm_unpackhi_epi64(t1, t3));
+}
+
+// 인덱스 32개 -> 색 32개 (c[0] = 0~7, c[1] = 8~15, ...): 같은 인덱스 / 16색 LUT / gather 순으로 시도
+DSP_TARGET_AVX2
+static inline void Lookup32_AVX2(const unsigned char* indices, __m256i v, const unsigned int* palette,
+                                 const __m256i* planes, __m256i* c) {
+    if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8((char)indices[0]))) == -1) {
+        c[0] = c[1] = c[2] = c[3] = _mm256_set1_epi32((int)palette[indices[0]]);
+        return;
+    }
+    if (_mm256_testz_si256(v, _mm256_set1_epi8((char)0xF0))) {
+        __m256i b = _mm256_shuffle_epi8(planes[0], v);
+        __m256i g = _mm256_shuffle_epi8(planes[1], v);
+        __m256i r = _mm256_shuffle_epi8(planes[2], v);
+        __m256i a = _mm256_shuffle_epi8(planes[3], v);
+        // 레인마다 B G R A 교차 -> q0 = 0~3 | 16~19, q1 = 4~7 | 20~23, q2 = 8~11 | 24~27, q3 = 12~15 | 28~31
+        __m256i bgLo = _mm256_unpacklo_epi8(b, g), bgHi = _mm256_unpackhi_epi8(b, g);
+        __m256i raLo = _mm256_unpacklo_epi8(r, a), raHi = _mm256_unpackhi_epi8(r, a);
+        __m256i q0 = _mm256_unpacklo_epi16(bgLo, raLo), q1 = _mm256_unpackhi_epi16(bgLo, raLo);
+        __m256i q2 = _mm256_unpacklo_epi16(bgHi, raHi), q3 = _mm256_unpackhi_epi16(bgHi, raHi);
+        c[0] = _mm256_permute2x128_si256(q0, q1, 0x20);
+        c[1] = _mm256_permute2x128_si256(q2, q3, 0x20);
+        c[2] = _mm256_permute2x128_si256(q0, q1, 0x31);
+        c[3] = _mm256_permute2x128_si256(q2, q3, 0x31);
+        return;
+    }
+    for (int j = 0; j < 4; j++) {
+        __m256i idx = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(indices + 8 * j)));
+        c[j] = _mm256_i32gather_epi32((const int*)palette, idx, 4);
+    }
+}
+
+DSP_TARGET_AVX2
+static void PaletteExpand_AVX2(const unsigned char* indices, const unsigned int* palette, unsigned int* out,
+                               int count) {
+    __m256i planes[4];
+    if (count >= 32) PalettePlanes_AVX2(palette, planes);
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i c[4];
+        Lookup32_AVX2(indices + i, _mm256_loadu_si256((const __m256i*)(indices + i)), palette, planes, c);
+        for (int j = 0; j < 4; j++) _mm256_storeu_si256((__m256i*)(out + i + 8 * j), c[j]);
+    }
+    _mm256_zeroupper();  // 끝부분은 SSE2 코드: 상위 레인 상태를 비워서 전환 비용 방지
+    PaletteExpand_SSE2(indices + i, palette, out + i, count - i);
+}
+
+DSP_TARGET_AVX2
+static void PaletteComposite_AVX2(const unsigned char* indices, const unsigned int* palette, unsigned int* out,
+                                  int count, int transparent) {
+    if (transparent < 0 || transparent > 255) {
+        PaletteExpand_AVX2(indices, palette, out, count);
+        return;
+    }
+    __m256i planes[4];
+    if (count >= 32) PalettePlanes_AVX2(palette, planes);
+    const __m256i vt = _mm256_set1_epi8((char)transparent);
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(indices + i));
+        __m256i skip = _mm256_cmpeq_epi8(v, vt);
+        int mask = _mm256_movemask_epi8(skip);
+        if (mask == -1) continue;  // 전부 투명
+
+        __m256i c[4];
+        Lookup32_AVX2(indices + i, v, palette, planes, c);
+        if (mask == 0) {
+            for (int j = 0; j < 4; j++) _mm256_storeu_si256((__m256i*)(out + i + 8 * j), c[j]);
+            continue;
+        }
+
+        // 섞임: 바이트 마스크 8개씩 부호 확장 -> 픽셀 마스크, 투명 픽셀은 기존 캔버스 값
+        __m128i skipLo = _mm256_castsi256_si128(skip);
+        __m128i skipHi = _mm256_extracti128_si256(skip, 1);
+        __m128i s[4] = { skipLo, _mm_srli_si128(skipLo, 8), skipHi, _mm_srli_si128(skipHi, 8) };
+        for (int j = 0; j < 4; j++) {
+            __m256i* dst = (__m256i*)(out + i + 8 * j);
+            __m256i m = _mm256_cvtepi8_epi32(s[j]);
+            _mm256_storeu_si256(dst, _mm256_blendv_epi8(c[j], _mm256_loadu_si256(dst), m));
+        }
+    }
+    _mm256_zeroupper();  // 끝부분은 SSE2 코드: 상위 레인 상태를 비워서 전환 비용 방지
+    PaletteComposite_SSE2(indices + i, palette, out + i, count - i, transparent);
+}
+
+static const DspKernels g_avx2Kernels = {
+    "avx2",
+    Downmix_AVX2,
+    ApplyWindow_AVX2,
+    ComplexMultiply_AVX2,
+    Butterfly_AVX2,
+    Magnitude_AVX2,
+    ToDecibels_AVX2,
+    Int16ToFloat_AVX2,
+    Int32ToFloat_AVX2,
+    Envelope_AVX2,
+    PeakHold_AVX2,
+    PaletteExpand_AVX2,
+    PaletteComposite_AVX2
+};
+
+// CPU 기능 확인
+static int CpuHasSSE2(void) {
+#if defined(_M_X64) || defined(__x86_64__)
+    return 1;  // x64는 SSE2가 기본
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+static int CpuHasAVX2(void) {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return 0;
+    __cpuid(info, 1);
+    // OSXSAVE + AVX, 그리고 OS가 YMM 레지스터를 저장하는지
+    if (!(info[2] & (1 << 27)) || !(info[2] & (1 << 28))) return 0;
+    if ((_xgetbv(0) & 6) != 6) return 0;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // DSP_ARCH_X86
+
+#if defined(DSP_ARCH_NEON)
+
+// ---------------------------------------------------------------------------
+// NEON
+// ---------------------------------------------------------------------------
+
+static inline float32x4_t Log_NEON(float32x4_t x) {
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    int32x4_t xi = vreinterpretq_s32_f32(x);
+    int32x4_t expBits = vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(xi), 23));
+    float32x4_t e = vcvtq_f32_s32(vsubq_s32(expBits, vdupq_n_s32(126)));
+
+    xi = vandq_s32(xi, vdupq_n_s32(0x007FFFFF));
+    xi = vorrq_s32(xi, vdupq_n_s32(0x3F000000));
+    x = vreinterpretq_f32_s32(xi);
+
+    uint32x4_t mask = vcltq_f32(x, vdupq_n_f32(0.707106781186547524f));
+    float32x4_t tmp = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(x), mask));
+    x = vsubq_f32(x, one);
+    e = vsubq_f32(e, vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(one), mask)));
+    x = vaddq_f32(x, tmp);
+
+    float32x4_t z = vmulq_f32(x, x);
+    float32x4_t y = vdupq_n_f32(7.0376836292E-2f);
+    y = vmlaq_f32(vdupq_n_f32(-1.1514610310E-1f), y, x);
+    y = vmlaq_f32(vdupq_n_f32(1.1676998740E-1f), y, x);
+    y = vmlaq_f32(vdupq_n_f32(-1.2420140846E-1f), y, x);
+    y = vmlaq_f32(vdupq_n_f32(1.4249322787E-1f), y, x);
+    y = vmlaq_f32(vdupq_n_f32(-1.6668057665E-1f), y, x);
+    y = vmlaq_f32(vdupq_n_f32(2.0000714765E-1f), y, x);
+    y = vmlaq_f32(vdupq_n_f32(-2.4999993993E-1f), y, x);
+    y = vmlaq_f32(vdupq_n_f32(3.3333331174E-1f), y, x);
+    y = vmulq_f32(vmulq_f32(y, x), z);
+
+    y = vmlaq_f32(y, e, vdupq_n_f32(-2.12194440e-4f));
+    y = vmlsq_f32(y, z, vdupq_n_f32(0.5f));
+    x = vaddq_f32(x, y);
+    x = vmlaq_f32(x, e, vdupq_n_f32(0.693359375f));
+    return x;
+}
+
+static void Downmix_NEON(const float* in, float* mono, int frames, int channels) {
+    if (channels != 2) {
+        Downmix_Scalar(in, mono, frames, channels);
+        return;
+    }
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    int i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        float32x4x2_t lr = vld2q_f32(in + 2 * i);
+        vst1q_f32(mono + i, vmulq_f32(vaddq_f32(lr.val[0], lr.val[1]), half));
+    }
+    Downmix_Scalar(in + 2 * i, mono + i, frames - i, 2);
+}
+
+static void ApplyWindow_NEON(const float* in, const float* window, float* out, int count) {
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(out + i, vmulq_f32(vld1q_f32(in + i), vld1q_f32(window + i)));
+    }
+    ApplyWindow_Scalar(in + i, window + i, out + i, count - i);
+}
+
+static void ComplexMultiply_NEON(const float* a, const float* b, float* out, int count) {
+    int k = 0;
+    for (; k + 4 <= count; k += 4) {
+        float32x4x2_t va = vld2q_f32(a + 2 * k);
+        float32x4x2_t vb = vld2q_f32(b + 2 * k);
+        float32x4x2_t r;
+        r.val[0] = vmlsq_f32(vmulq_f32(va.val[0], vb.val[0]), va.val[1], vb.val[1]);
+        r.val[1] = vmlaq_f32(vmulq_f32(va.val[0], vb.val[1]), va.val[1], vb.val[0]);
+        vst2q_f32(out + 2 * k, r);
+    }
+    ComplexMultiply_Scalar(a + 2 * k, b + 2 * k, out + 2 * k, count - k);
+}
+
+static void Butterfly_NEON(float* a, float* b, const float* w, int count) {
+    int k = 0;
+    for (; k + 4 <= count; k += 4) {
+        float32x4x2_t va = vld2q_f32(a + 2 * k);
+        float32x4x2_t vb = vld2q_f32(b + 2 * k);
+        float32x4x2_t vw = vld2q_f32(w + 2 * k);
+        float32x4_t tr = vmlsq_f32(vmulq_f32(vb.val[0], vw.val[0]), vb.val[1], vw.val[1]);
+        float32x4_t ti = vmlaq_f32(vmulq_f32(vb.val[0], vw.val[1]), vb.val[1], vw.val[0]);
+        float32x4x2_t ra, rb;
+        rb.val[0] = vsubq_f32(va.val[0], tr);
+        rb.val[1] = vsubq_f32(va.val[1], ti);
+        ra.val[0] = vaddq_f32(va.val[0], tr);
+        ra.val[1] = vaddq_f32(va.val[1], ti);
+        vst2q_f32(b + 2 * k, rb);
+        vst2q_f32(a + 2 * k, ra);
+    }
+    Butterfly_Scalar(a + 2 * k, b + 2 * k, w + 2 * k, count - k);
+}
+
+static void Magnitude_NEON(const float* c, float* out, int count, float scale) {
+    const float32x4_t vs = vdupq_n_f32(scale);
+    int k = 0;
+    for (; k + 4 <= count; k += 4) {
+        float32x4x2_t v = vld2q_f32(c + 2 * k);
+        float32x4_t p = vmlaq_f32(vmulq_f32(v.val[0], v.val[0]), v.val[1], v.val[1]);
+        vst1q_f32(out + k, vmulq_f32(vsqrtq_f32(p), vs));
+    }
+    Magnitude_Scalar(c + 2 * k, out + k, count - k, scale);
+}
+
+static void ToDecibels_NEON(const float* in, float* out, int count, float floor) {
+    const float32x4_t vf = vdupq_n_f32(floor);
+    const float32x4_t vdb = vdupq_n_f32(DB_PER_NEPER);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t v = vaddq_f32(vld1q_f32(in + i), vf);
+        vst1q_f32(out + i, vmulq_f32(Log_NEON(v), vdb));
+    }
+    ToDecibels_Scalar(in + i, out + i, count - i, floor);
+}
+
+static void Int16ToFloat_NEON(const short* in, float* out, int count) {
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t v = vld1q_s16(in + i);
+        // 고정소수점 변환 (소수부 15비트)
+        vst1q_f32(out + i, vcvtq_n_f32_s32(vmovl_s16(vget_low_s16(v)), 15));
+        vst1q_f32(out + i + 4, vcvtq_n_f32_s32(vmovl_s16(vget_high_s16(v)), 15));
+    }
+    Int16ToFloat_Scalar(in + i, out + i, count - i);
+}
+
+static void Int32ToFloat_NEON(const int* in, float* out, int count) {
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(out + i, vcvtq_n_f32_s32(vld1q_s32(in + i), 31));
+    }
+    Int32ToFloat_Scalar(in + i, out + i, count - i);
+}
+
+static void Envelope_NEON(float* value, const float* target, int count, float attack, float release) {
+    const float32x4_t va = vdupq_n_f32(attack);
+    const float32x4_t vr = vdupq_n_f32(release);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t v = vld1q_f32(value + i);
+        float32x4_t d = vsubq_f32(vld1q_f32(target + i), v);
+        float32x4_t k = vbslq_f32(vcgtq_f32(d, vdupq_n_f32(0.0f)), va, vr);
+        vst1q_f32(value + i, vmlaq_f32(v, d, k));
+    }
+    Envelope_Scalar(value + i, target + i, count - i, attack, release);
+}
+
+static void PeakHold_NEON(float* peak, float* hold, float* velocity, const float* value, int count,
+                          float dt, float holdTime, float gravity) {
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t vdt = vdupq_n_f32(dt);
+    const float32x4_t vhold = vdupq_n_f32(holdTime);
+    const float32x4_t vgdt = vdupq_n_f32(gravity * dt);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t v = vld1q_f32(value + i);
+        float32x4_t p = vld1q_f32(peak + i);
+        float32x4_t h = vld1q_f32(hold + i);
+        float32x4_t vel = vld1q_f32(velocity + i);
+
+        uint32x4_t rise = vcgeq_f32(v, p);
+        uint32x4_t fall = vbicq_u32(vcleq_f32(h, zero), rise);
+
+        float32x4_t newVel = vaddq_f32(vel, vbslq_f32(fall, vgdt, zero));
+        float32x4_t fallen = vmaxq_f32(vmlsq_f32(p, newVel, vdt), v);
+
+        vst1q_f32(peak + i, vbslq_f32(rise, v, vbslq_f32(fall, fallen, p)));
+        vst1q_f32(hold + i, vbslq_f32(rise, vhold, vmaxq_f32(vsubq_f32(h, vdt), zero)));
+        vst1q_f32(velocity + i, vbslq_f32(rise, zero, newVel));
+    }
+    PeakHold_Scalar(peak + i, hold + i, velocity + i, value + i, count - i, dt, holdTime, gravity);
+}
+
+// NEON도 표 조회는 스칼라로 4개씩 모으고, 같은 색 / 투명 구간 판정과 섞기만 벡터로
+static inline uint32x4_t Lookup4_NEON(const unsigned char* indices, const unsigned int* palette) {
+    uint32x4_t c = vdupq_n_u32(palette[indices[0]]);
+    c = vsetq_lane_u32(palette[indices[1]], c, 1);
+    c = vsetq_lane_u32(palette[indices[2]], c, 2);
+    c = vsetq_lane_u32(palette[indices[3]], c, 3);
+    return c;
+}
+
+// 바이트 마스크 16개가 모두 1 / 모두 0인지 (AArch32에도 있는 명령만 사용)
+static inline int AllSet_NEON(uint8x16_t m) {
+    uint64x2_t w = vreinterpretq_u64_u8(m);
+    return (vgetq_lane_u64(w, 0) & vgetq_lane_u64(w, 1)) == ~0ull;
+}
+
+static inline int NoneSet_NEON(uint8x16_t m) {
+    uint64x2_t w = vreinterpretq_u64_u8(m);
+    return (vgetq_lane_u64(w, 0) | vgetq_lane_u64(w, 1)) == 0;
+}
+
+static inline void Expand16_NEON(const unsigned char* indices, uint8x16_t v, const unsigned int* palette,
+                                 unsigned int* out) {
+    if (AllSet_NEON(vceqq_u8(v, vdupq_n_u8(indices[0])))) {
+        uint32x4_t c = vdupq_n_u32(palette[indices[0]]);
+        for (int j = 0; j < 16; j += 4) vst1q_u32(out + j, c);
+        return;
+    }
+    for (int j = 0; j < 16; j += 4) {
+        vst1q_u32(out + j, Lookup4_NEON(indices + j, palette));
+    }
+}
+
+static void PaletteExpand_NEON(const unsigned char* indices, const unsigned int* palette, unsigned int* out,
+                               int count) {
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        Expand16_NEON(indices + i, vld1q_u8(indices + i), palette, out + i);
+    }
+    PaletteExpand_Scalar(indices + i, palette, out + i, count - i);
+}
+
+static void PaletteComposite_NEON(const unsigned char* indices, const unsigned int* palette, unsigned int* out,
+                                  int count, int transparent) {
+    if (transparent < 0 || transparent > 255) {
+        PaletteExpand_NEON(indices, palette, out, count);
+        return;
+    }
+    const uint8x16_t vt = vdupq_n_u8((unsigned char)transparent);
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t v = vld1q_u8(indices + i);
+        uint8x16_t skip = vceqq_u8(v, vt);
+        if (AllSet_NEON(skip)) continue;
+        if (NoneSet_NEON(skip)) {
+            Expand16_NEON(indices + i, v, palette, out + i);
+            continue;
+        }
+
+        // 섞임: 바이트 마스크를 부호 확장해서 픽셀 마스크로
+        int16x8_t lo = vmovl_s8(vreinterpret_s8_u8(vget_low_u8(skip)));
+        int16x8_t hi = vmovl_s8(vreinterpret_s8_u8(vget_high_u8(skip)));
+        uint32x4_t m[4] = { vreinterpretq_u32_s32(vmovl_s16(vget_low_s16(lo))),
+                            vreinterpretq_u32_s32(vmovl_s16(vget_high_s16(lo))),
+                            vreinterpretq_u32_s32(vmovl_s16(vget_low_s16(hi))),
+                            vreinterpretq_u32_s32(vmovl_s16(vget_high_s16(hi))) };
+        for (int j = 0; j < 4; j++) {
+            unsigned int* dst = out + i + 4 * j;
+            vst1q_u32(dst, vbslq_u32(m[j], vld1q_u32(dst), Lookup4_NEON(indices + i + 4 * j, palette)));
+        }
+    }
+    PaletteComposite_Scalar(indices + i, palette, out + i, count - i, transparent);
+}
+
+static const DspKernels g_neonKernels = {
+    "neon",
+    Downmix_NEON,
+    ApplyWindow_NEON,
+    ComplexMultiply_NEON,
+    Butterfly_NEON,
+    Magnitude_NEON,
+    ToDecibels_NEON,
+    Int16ToFloat_NEON,
+    Int32ToFloat_NEON,
+    Envelope_NEON,
+    PeakHold_NEON,
+    PaletteExpand_NEON,
+    PaletteComposite_NEON
+};
+
+#endif // DSP_ARCH_NEON
+
+// ---------------------------------------------------------------------------
+// 선택
+// ---------------------------------------------------------------------------
+
+// 캡처 / DSP / UI 스레드가 동시에 읽으므로 원자적으로 (구현 테이블은 정적이라 포인터만 맞으면 됨)
+static std::atomic<const DspKernels*> g_selected(NULL);
+
+// 목록 마지막이 가장 빠른 구현
+static const DspKernels* Fastest() {
+    const DspKernels* list[4];
+    int count = DspKernels_List(list, 4);
+    return list[count - 1];
+}
+
+extern "C" {
+
+int DspKernels_List(const DspKernels** out, int maxCount) {
+    int count = 0;
+    if (count < maxCount) out[count++] = &g_scalarKernels;
+#if defined(DSP_ARCH_X86)
+    if (CpuHasSSE2() && count < maxCount) out[count++] = &g_sse2Kernels;
+    if (CpuHasAVX2() && count < maxCount) out[count++] = &g_avx2Kernels;
+#elif defined(DSP_ARCH_NEON)
+    if (count < maxCount) out[count++] = &g_neonKernels;
+#endif
+    return count;
+}
+
+const DspKernels* DspKernels_Get(void) {
+    const DspKernels* k = g_selected.load(std::memory_order_acquire);
+    if (k) return k;
+
+    // 처음 부른 스레드가 정함 (동시에 부르면 먼저 넣은 쪽, 그 사이 Select한 값은 덮지 않음)
+    const DspKernels* fastest = Fastest();
+    if (g_selected.compare_exchange_strong(k, fastest, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        return fastest;
+    }
+    return k;
+}
+
+const DspKernels* DspKernels_GetScalar(void) {
+    return &g_scalarKernels;
+}
+
+int DspKernels_Select(const char* name) {
+    if (!name) {
+        g_selected.store(Fastest(), std::memory_order_release);
+        return 1;
+    }
+
+    const DspKernels* list[4];
+    int count = DspKernels_List(list, 4);
+    for (int i = 0; i < count; i++) {
+        if (strcmp(list[i]->name, name) == 0) {
+            g_selected.store(list[i], std::memory_order_release);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+} // extern "C"
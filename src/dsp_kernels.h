@@ -0,0 +1,71 @@
+/*
+ * dsp_kernels.h - SIMD DSP Kernels (SSE2 / AVX2 / NEON + scalar fallback)
+ */
+
+#ifndef DSP_KERNELS_H
+#define DSP_KERNELS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 커널 테이블 (CPU 기능에 따라 런타임에 하나 선택)
+// 복소수 배열은 모두 (re, im) 교차 배치, count는 복소수 개수
+typedef struct {
+    const char* name;   // "scalar", "sse2", "avx2", "neon"
+
+    // 인터리브 다채널 -> 모노 (채널 평균)
+    void (*downmix)(const float* interleaved, float* mono, int frames, int channels);
+
+    // out[i] = in[i] * window[i]
+    void (*applyWindow)(const float* in, const float* window, float* out, int count);
+
+    // out[k] = a[k] * b[k] (복소 곱)
+    void (*complexMultiply)(const float* a, const float* b, float* out, int count);
+
+    // radix-2 나비: t = b[k] * w[k]; b[k] = a[k] - t; a[k] = a[k] + t
+    void (*butterfly)(float* a, float* b, const float* w, int count);
+
+    // out[k] = |c[k]| * scale
+    void (*magnitude)(const float* complexData, float* out, int count, float scale);
+
+    // out[i] = 20 * log10(in[i] + floor)
+    void (*toDecibels)(const float* in, float* out, int count, float floor);
+
+    // 정수 PCM -> float (-1.0 ~ 1.0), out[i] = in[i] / 2^15, in[i] / 2^31
+    void (*int16ToFloat)(const short* in, float* out, int count);
+    void (*int32ToFloat)(const int* in, float* out, int count);
+
+    // 막대 포락선: value[i] += (target[i] - value[i]) * (올라가면 attack, 내려가면 release)
+    void (*envelope)(float* value, const float* target, int count, float attack, float release);
+
+    // 피크 유지 + 중력 낙하 (dt초 경과)
+    // value >= peak이면 peak = value, holdTime 동안 유지, 그 뒤 velocity += gravity * dt로 떨어짐
+    void (*peakHold)(float* peak, float* hold, float* velocity, const float* value, int count,
+                     float dt, float holdTime, float gravity);
+
+    // GIF 팔레트 인덱스 -> 프리멀티플라이 BGRA: out[i] = palette[indices[i]] (palette는 256개 항목)
+    void (*paletteExpand)(const unsigned char* indices, const unsigned int* palette, unsigned int* out, int count);
+
+    // 캔버스 위에 합성: indices[i] == transparent인 픽셀은 out을 그대로 둠 (transparent < 0 = 투명 없음)
+    void (*paletteComposite)(const unsigned char* indices, const unsigned int* palette, unsigned int* out, int count,
+                             int transparent);
+} DspKernels;
+
+// 현재 CPU에서 가장 빠른 커널 (최초 호출 시 선택, 어느 스레드에서 불러도 됨)
+const DspKernels* DspKernels_Get(void);
+
+// 스칼라 기준 구현
+const DspKernels* DspKernels_GetScalar(void);
+
+// 현재 CPU에서 사용 가능한 모든 커널 (벤치마크/비교용), 반환값 = 개수
+int DspKernels_List(const DspKernels** out, int maxCount);
+
+// 강제로 특정 커널 사용 (name이 NULL이면 자동 선택으로 복귀)
+int DspKernels_Select(const char* name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DSP_KERNELS_H
@@ -0,0 +1,229 @@
+/*
+ * fft.cpp - Real FFT Engine
+ * N 실수 샘플을 N/2 복소수로 묶어서 radix-2 FFT 후 분리 (O(N log N))
+ */
+
+#include "fft.h"
+#include "dsp_kernels.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define FFT_PI 3.14159265358979323846
+
+int FFT_IsValidSize(int size) {
+    if (size < FFT_MIN_SIZE || size > FFT_MAX_SIZE) return 0;
+    return (size & (size - 1)) == 0;
+}
+
+int FFT_Init(FFTContext* ctx, int size, int windowType) {
+    if (!ctx || !FFT_IsValidSize(size)) return 0;
+
+    memset(ctx, 0, sizeof(FFTContext));
+    ctx->size = size;
+    ctx->halfSize = size / 2;
+    ctx->windowType = windowType;
+
+    int half = ctx->halfSize;
+    ctx->window = (float*)malloc(sizeof(float) * size);
+    ctx->twiddle = (float*)malloc(sizeof(float) * size);
+    ctx->splitTwiddle = (float*)malloc(sizeof(float) * half);
+    ctx->bitrev = (unsigned short*)malloc(sizeof(unsigned short) * half);
+    ctx->work = (float*)malloc(sizeof(float) * size);
+
+    if (!ctx->window || !ctx->twiddle || !ctx->splitTwiddle || !ctx->bitrev || !ctx->work) {
+        FFT_Free(ctx);
+        return 0;
+    }
+
+    // 윈도우 테이블 (double로 계산 후 float 저장)
+    double windowSum = 0.0;
+    for (int i = 0; i < size; i++) {
+        double w = 1.0;
+        double phase = 2.0 * FFT_PI * i / (size - 1);
+        if (windowType == FFT_WINDOW_HANN) {
+            w = 0.5 - 0.5 * cos(phase);
+        } else if (windowType == FFT_WINDOW_BLACKMAN) {
+            w = 0.42 - 0.5 * cos(phase) + 0.08 * cos(2.0 * phase);
+        }
+        ctx->window[i] = (float)w;
+        windowSum += w;
+    }
+    ctx->windowSum = (float)windowSum;
+
+    // 복소 FFT 트위들: 길이 len 단계마다 W_len^j (j < len/2) 를 연속으로 저장
+    // SIMD 나비 커널이 stride 없이 바로 읽을 수 있도록 (총 M-1개)
+    float* tw = ctx->twiddle;
+    for (int len = 2; len <= half; len <<= 1) {
+        for (int j = 0; j < len / 2; j++) {
+            double angle = -2.0 * FFT_PI * j / len;
+            *tw++ = (float)cos(angle);
+            *tw++ = (float)sin(angle);
+        }
+    }
+
+    // 실수 분리 트위들: W_N^k = e^(-2*pi*i*k/N), k < N/4 (+ 1)
+    for (int k = 0; k < half / 2; k++) {
+        double angle = -2.0 * FFT_PI * k / size;
+        ctx->splitTwiddle[2 * k] = (float)cos(angle);
+        ctx->splitTwiddle[2 * k + 1] = (float)sin(angle);
+    }
+
+    // 비트 반전 테이블
+    int bits = 0;
+    while ((1 << bits) < half) bits++;
+    for (int i = 0; i < half; i++) {
+        int r = 0;
+        for (int b = 0; b < bits; b++) {
+            if (i & (1 << b)) r |= 1 << (bits - 1 - b);
+        }
+        ctx->bitrev[i] = (unsigned short)r;
+    }
+
+    return 1;
+}
+
+void FFT_Free(FFTContext* ctx) {
+    if (!ctx) return;
+    free(ctx->window);
+    free(ctx->twiddle);
+    free(ctx->splitTwiddle);
+    free(ctx->bitrev);
+    free(ctx->work);
+    memset(ctx, 0, sizeof(FFTContext));
+}
+
+// 제자리 복소 FFT (re, im 교차 배열, 길이 M)
+static void ComplexFFT(const FFTContext* ctx, float* data) {
+    int m = ctx->halfSize;
+
+    // 비트 반전 순서로 재배치
+    for (int i = 0; i < m; i++) {
+        int j = ctx->bitrev[i];
+        if (j > i) {
+            float tr = data[2 * i];
+            float ti = data[2 * i + 1];
+            data[2 * i] = data[2 * j];
+            data[2 * i + 1] = data[2 * j + 1];
+            data[2 * j] = tr;
+            data[2 * j + 1] = ti;
+        }
+    }
+
+    // 첫 단계 (W = 1) 는 덧셈/뺄셈만
+    for (int i = 0; i < m; i += 2) {
+        float* a = &data[2 * i];
+        float* b = &data[2 * i + 2];
+        float tr = b[0], ti = b[1];
+        b[0] = a[0] - tr;
+        b[1] = a[1] - ti;
+        a[0] += tr;
+        a[1] += ti;
+    }
+
+    // 나머지 단계는 SIMD 나비 커널
+    const DspKernels* kernels = DspKernels_Get();
+    const float* tw = ctx->twiddle + 2;
+    for (int len = 4; len <= m; len <<= 1) {
+        int halfLen = len >> 1;
+        for (int start = 0; start < m; start += len) {
+            kernels->butterfly(&data[2 * start], &data[2 * (start + halfLen)], tw, halfLen);
+        }
+        tw += 2 * halfLen;
+    }
+}
+
+void FFT_RealForward(const FFTContext* ctx, float* data) {
+    if (!ctx || !data || !ctx->size) return;
+
+    int m = ctx->halfSize;
+
+    // z[n] = x[2n] + i*x[2n+1] 로 보고 N/2 복소 FFT
+    ComplexFFT(ctx, data);
+
+    // DC / 나이퀴스트
+    float z0r = data[0];
+    float z0i = data[1];
+    data[0] = z0r + z0i;
+    data[1] = z0r - z0i;
+
+    // X[k] = Fe + W^k * Fo, X[M-k] = conj(Fe) - conj(W^k * Fo)
+    for (int k = 1; k <= m / 2; k++) {
+        int nk = m - k;
+        float zkr = data[2 * k], zki = data[2 * k + 1];
+        float znr = data[2 * nk], zni = data[2 * nk + 1];
+
+        // Fe = (Z[k] + conj(Z[M-k])) / 2, Fo = -i * (Z[k] - conj(Z[M-k])) / 2
+        float fer = 0.5f * (zkr + znr);
+        float fei = 0.5f * (zki - zni);
+        float for_ = 0.5f * (zki + zni);
+        float foi = -0.5f * (zkr - znr);
+
+        float wr, wi;
+        if (k < m / 2) {
+            wr = ctx->splitTwiddle[2 * k];
+            wi = ctx->splitTwiddle[2 * k + 1];
+        } else {
+            wr = 0.0f;   // W_N^(N/4) = -i
+            wi = -1.0f;
+        }
+
+        float tr = for_ * wr - foi * wi;
+        float ti = for_ * wi + foi * wr;
+
+        data[2 * k] = fer + tr;
+        data[2 * k + 1] = fei + ti;
+        data[2 * nk] = fer - tr;
+        data[2 * nk + 1] = -(fei - ti);
+    }
+}
+
+void FFT_Magnitude(FFTContext* ctx, const float* input, float* output) {
+    if (!ctx || !input || !output || !ctx->size) return;
+
+    int n = ctx->size;
+    float* work = ctx->work;
+
+    const DspKernels* kernels = DspKernels_Get();
+
+    // 윈도우 적용 (사각 윈도우면 복사만)
+    if (ctx->windowType == FFT_WINDOW_RECT) {
+        memcpy(work, input, sizeof(float) * n);
+    } else {
+        kernels->applyWindow(input, ctx->window, work, n);
+    }
+
+    FFT_RealForward(ctx, work);
+
+    // work[0] = DC, work[1] = 나이퀴스트 (출력에는 DC만 사용)
+    float scale = 1.0f / ctx->windowSum;
+    output[0] = fabsf(work[0]) * scale;
+    kernels->magnitude(work + 2, output + 1, n / 2 - 1, scale);
+}
+
+const float* FFT_GetSpectrum(const FFTContext* ctx) {
+    if (!ctx) return NULL;
+    return ctx->work;
+}
+
+void FFT_HannMagnitude(const FFTContext* ctx, float* output) {
+    if (!ctx || !output || !ctx->size) return;
+
+    // Hann = 0.5 - 0.5cos -> 스펙트럼에서 X[k] / 2 - (X[k-1] + X[k+1]) / 4, 윈도우 합은 N / 2
+    const float* x = ctx->work;
+    int half = ctx->size / 2;
+    float scale = 1.0f / ctx->windowSum;
+
+    // DC: X[-1] = conj(X[1])
+    output[0] = fabsf(x[0] - x[2]) * scale;
+    for (int k = 1; k < half; k++) {
+        float prevRe = k == 1 ? x[0] : x[2 * k - 2];
+        float prevIm = k == 1 ? 0.0f : x[2 * k - 1];
+        float nextRe = k + 1 == half ? x[1] : x[2 * k + 2];
+        float nextIm = k + 1 == half ? 0.0f : x[2 * k + 3];
+        float re = x[2 * k] - 0.5f * (prevRe + nextRe);
+        float im = x[2 * k + 1] - 0.5f * (prevIm + nextIm);
+        output[k] = sqrtf(re * re + im * im) * scale;
+    }
+}
@@ -0,0 +1,60 @@
+/*
+ * fft.h - Real FFT Engine (platform-neutral)
+ */
+
+#ifndef FFT_H
+#define FFT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FFT_MIN_SIZE 512
+#define FFT_MAX_SIZE 8192
+
+// 윈도우 함수 종류
+typedef enum {
+    FFT_WINDOW_RECT = 0,    // 사각 윈도우 (기존 DFT와 동일한 결과)
+    FFT_WINDOW_HANN,
+    FFT_WINDOW_BLACKMAN
+} FFTWindowType;
+
+// FFT 컨텍스트 (크기별 테이블을 한 번만 계산해서 보관)
+typedef struct {
+    int size;               // 실수 입력 길이 N
+    int halfSize;           // 내부 복소 FFT 길이 N/2
+    int windowType;
+    float windowSum;        // 윈도우 합 (크기 정규화용, 사각 윈도우면 N)
+    float* window;          // [N] 윈도우 테이블
+    float* twiddle;         // [N] 단계별 복소 FFT 트위들 (re, im 교차, 단계마다 연속 배치)
+    float* splitTwiddle;    // [N/2] 실수 분리 단계 트위들 (re, im 교차)
+    unsigned short* bitrev; // [N/2] 비트 반전 인덱스
+    float* work;            // [N] 작업 버퍼
+} FFTContext;
+
+// 지원하는 크기인지 (512 ~ 8192, 2의 거듭제곱)
+int FFT_IsValidSize(int size);
+
+// 초기화 / 정리
+int FFT_Init(FFTContext* ctx, int size, int windowType);
+void FFT_Free(FFTContext* ctx);
+
+// 제자리 실수 FFT (data[N] -> 패킹된 스펙트럼)
+// data[0] = DC, data[1] = 나이퀴스트, data[2k], data[2k+1] = k번 빈의 실수부, 허수부
+void FFT_RealForward(const FFTContext* ctx, float* data);
+
+// 윈도우 적용 후 크기 스펙트럼 계산 (output[N/2], |X[k]| / 윈도우 합)
+void FFT_Magnitude(FFTContext* ctx, const float* input, float* output);
+
+// 마지막 FFT_Magnitude의 패킹된 복소 스펙트럼 (FFT_RealForward 형식, 다음 호출 전까지 유효)
+const float* FFT_GetSpectrum(const FFTContext* ctx);
+
+// 마지막 FFT_Magnitude의 스펙트럼에 Hann 윈도우를 주파수 영역에서 적용한 크기 (output[N/2])
+// 사각 윈도우 컨텍스트에서만 의미 있음: FFT를 한 번 더 하지 않고 누설이 적은 스펙트럼이 필요할 때
+void FFT_HannMagnitude(const FFTContext* ctx, float* output);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FFT_H
@@ -0,0 +1,225 @@
+/*
+ * frame_cache.cpp - Byte-budgeted LRU Frame Cache
+ * LRU는 이중 연결 목록 (찾을 때마다 맨 앞으로), 키는 체인 해시
+ * 버릴 때는 목록 끝(가장 오래됨)부터 훑어서 고정 안 된 숨긴 소유자 항목 -> 없으면 고정 안 된 아무 항목
+ */
+
+#include "frame_cache.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define FRAME_CACHE_MIN_BUCKETS 64
+
+static inline unsigned int HashKey(int owner, int kind, int index) {
+    unsigned int h = (unsigned int)index * 2654435761u;
+    h ^= ((unsigned int)owner * FRAME_CACHE_MAX_KINDS + (unsigned int)kind) * 40503u;
+    return h ^ (h >> 15);
+}
+
+static inline bool ValidKey(int owner, int kind) {
+    return owner >= 0 && owner < FRAME_CACHE_MAX_OWNERS && kind >= 0 && kind < FRAME_CACHE_MAX_KINDS;
+}
+
+static FrameCacheEntry** FindSlot(const FrameCache* c, int owner, int kind, int index) {
+    FrameCacheEntry** slot = &c->buckets[HashKey(owner, kind, index) & (c->bucketCount - 1)];
+    while (*slot && ((*slot)->owner != owner || (*slot)->kind != kind || (*slot)->index != index)) {
+        slot = &(*slot)->nextInBucket;
+    }
+    return slot;
+}
+
+static void Unlink(FrameCache* c, FrameCacheEntry* e) {
+    if (e->newer) e->newer->older = e->older; else c->newest = e->older;
+    if (e->older) e->older->newer = e->newer; else c->oldest = e->newer;
+    e->newer = e->older = NULL;
+}
+
+static void PushNewest(FrameCache* c, FrameCacheEntry* e) {
+    e->newer = NULL;
+    e->older = c->newest;
+    if (c->newest) c->newest->newer = e; else c->oldest = e;
+    c->newest = e;
+}
+
+static void FreeEntry(FrameCache* c, FrameCacheEntry* e) {
+    c->used -= e->bytes;
+    free(e->data);
+    free(e);
+}
+
+// 해시와 목록에서 빼기 (고정돼 있으면 Release에서 해제)
+static void Detach(FrameCache* c, FrameCacheEntry* e) {
+    FrameCacheEntry** slot = FindSlot(c, e->owner, e->kind, e->index);
+    *slot = e->nextInBucket;
+    Unlink(c, e);
+    c->entryCount--;
+    FrameCacheOwner* o = &c->owners[e->owner];
+    o->bytes[e->kind] -= e->bytes;
+    o->count[e->kind]--;
+    if (e->pins > 0) {
+        e->removed = 1;
+    } else {
+        FreeEntry(c, e);
+    }
+}
+
+// 항목이 늘면 버킷 2배 (평균 체인 길이 1 이하)
+static void Grow(FrameCache* c) {
+    if (c->entryCount < c->bucketCount) return;
+    int count = c->bucketCount * 2;
+    FrameCacheEntry** buckets = (FrameCacheEntry**)calloc(count, sizeof(FrameCacheEntry*));
+    if (!buckets) return;  // 그대로 (체인만 길어짐)
+    for (int b = 0; b < c->bucketCount; b++) {
+        FrameCacheEntry* e = c->buckets[b];
+        while (e) {
+            FrameCacheEntry* next = e->nextInBucket;
+            FrameCacheEntry** slot = &buckets[HashKey(e->owner, e->kind, e->index) & (count - 1)];
+            e->nextInBucket = *slot;
+            *slot = e;
+            e = next;
+        }
+    }
+    free(c->buckets);
+    c->buckets = buckets;
+    c->bucketCount = count;
+}
+
+// 버릴 항목: 고정 안 된 숨긴 소유자 항목 중 가장 오래된 것, 없으면 고정 안 된 가장 오래된 것
+static FrameCacheEntry* EvictionCandidate(const FrameCache* c) {
+    FrameCacheEntry* fallback = NULL;
+    for (FrameCacheEntry* e = c->oldest; e; e = e->newer) {
+        if (e->pins > 0) continue;
+        if (c->owners[e->owner].hidden) return e;
+        if (!fallback) fallback = e;
+    }
+    return fallback;
+}
+
+// used + incoming이 예산 안에 들어올 때까지 버림, 반환값 = 들어오는지
+static bool MakeRoom(FrameCache* c, size_t incoming) {
+    if (incoming > c->budget) return false;
+    while (c->used + incoming > c->budget) {
+        FrameCacheEntry* e = EvictionCandidate(c);
+        if (!e) return false;
+        FrameCacheOwner* o = &c->owners[e->owner];
+        c->stats.evictions[e->kind]++;
+        if (o->hidden) c->stats.hiddenEvictions++;
+        o->evictions++;
+        Detach(c, e);
+    }
+    return true;
+}
+
+extern "C" {
+
+int FrameCache_Init(FrameCache* c, size_t budget) {
+    if (!c) return 0;
+    memset(c, 0, sizeof(FrameCache));
+    c->buckets = (FrameCacheEntry**)calloc(FRAME_CACHE_MIN_BUCKETS, sizeof(FrameCacheEntry*));
+    if (!c->buckets) return 0;
+    c->bucketCount = FRAME_CACHE_MIN_BUCKETS;
+    c->budget = budget;
+    return 1;
+}
+
+void FrameCache_Free(FrameCache* c) {
+    if (!c) return;
+    FrameCacheEntry* e = c->newest;
+    while (e) {
+        FrameCacheEntry* next = e->older;
+        free(e->data);
+        free(e);
+        e = next;
+    }
+    free(c->buckets);
+    memset(c, 0, sizeof(FrameCache));
+}
+
+void FrameCache_SetBudget(FrameCache* c, size_t budget) {
+    if (!c || !c->buckets) return;
+    c->budget = budget;
+    MakeRoom(c, 0);
+}
+
+FrameCacheEntry* FrameCache_Acquire(FrameCache* c, int owner, int kind, int index) {
+    if (!c || !c->buckets || !ValidKey(owner, kind)) return NULL;
+    FrameCacheEntry* e = *FindSlot(c, owner, kind, index);
+    if (!e) {
+        c->stats.misses[kind]++;
+        return NULL;
+    }
+    c->stats.hits[kind]++;
+    Unlink(c, e);
+    PushNewest(c, e);
+    e->pins++;
+    return e;
+}
+
+FrameCacheEntry* FrameCache_Pin(FrameCache* c, int owner, int kind, int index) {
+    if (!c || !c->buckets || !ValidKey(owner, kind)) return NULL;
+    FrameCacheEntry* e = *FindSlot(c, owner, kind, index);
+    if (e) e->pins++;
+    return e;
+}
+
+int FrameCache_Contains(const FrameCache* c, int owner, int kind, int index) {
+    if (!c || !c->buckets || !ValidKey(owner, kind)) return 0;
+    return *FindSlot(c, owner, kind, index) != NULL;
+}
+
+void FrameCache_Release(FrameCache* c, FrameCacheEntry* e) {
+    if (!c || !e || e->pins <= 0) return;
+    e->pins--;
+    if (e->pins == 0 && e->removed) FreeEntry(c, e);
+}
+
+FrameCacheEntry* FrameCache_Insert(FrameCache* c, int owner, int kind, int index, void* data, size_t bytes) {
+    if (!c || !c->buckets || !data || !ValidKey(owner, kind)) return NULL;
+
+    FrameCacheEntry* old = *FindSlot(c, owner, kind, index);
+    if (old) {
+        if (old->pins > 0) return NULL;
+        Detach(c, old);
+    }
+
+    FrameCacheEntry* e = (FrameCacheEntry*)calloc(1, sizeof(FrameCacheEntry));
+    if (!e || !MakeRoom(c, bytes)) {
+        free(e);
+        return NULL;
+    }
+    e->data = data;
+    e->bytes = bytes;
+    e->owner = owner;
+    e->kind = kind;
+    e->index = index;
+    e->pins = 1;
+
+    FrameCacheEntry** slot = FindSlot(c, owner, kind, index);
+    *slot = e;
+    PushNewest(c, e);
+    c->used += bytes;
+    c->entryCount++;
+    c->owners[owner].bytes[kind] += bytes;
+    c->owners[owner].count[kind]++;
+    c->stats.inserts[kind]++;
+    Grow(c);
+    return e;
+}
+
+void FrameCache_Remove(FrameCache* c, int owner, int kind) {
+    if (!c || !c->buckets || owner < 0 || owner >= FRAME_CACHE_MAX_OWNERS) return;
+    FrameCacheEntry* e = c->oldest;
+    while (e) {
+        FrameCacheEntry* next = e->newer;
+        if (e->owner == owner && (kind < 0 || e->kind == kind)) Detach(c, e);
+        e = next;
+    }
+}
+
+void FrameCache_SetHidden(FrameCache* c, int owner, int hidden) {
+    if (!c || owner < 0 || owner >= FRAME_CACHE_MAX_OWNERS) return;
+    c->owners[owner].hidden = hidden != 0;
+}
+
+} // extern "C"
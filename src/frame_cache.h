@@ -0,0 +1,95 @@
+/*
+ * frame_cache.h - Byte-budgeted LRU Frame Cache (platform-neutral)
+ *
+ * 여러 소유자(GIF 창)가 함께 쓰는 프레임 버퍼 캐시: 키 = (소유자, 종류, 프레임 번호), 항목마다 따로 할당
+ * 전체 바이트가 예산을 넘으면 가장 오래 안 쓴 항목부터 버림 (숨긴 소유자의 항목이 있으면 그쪽 먼저)
+ * 쓰는 동안은 고정(pin)해서 버려지지 않게 함, 스레드 안전하지 않음 (여러 스레드면 호출한 쪽이 잠금)
+ */
+
+#ifndef FRAME_CACHE_H
+#define FRAME_CACHE_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FRAME_CACHE_MAX_OWNERS 16
+#define FRAME_CACHE_MAX_KINDS 4
+
+typedef struct FrameCacheEntry {
+    void* data;                     // 넣을 때 넘긴 버퍼 (malloc, 캐시가 free)
+    size_t bytes;
+    int owner;
+    int kind;
+    int index;
+    int pins;                       // 0보다 크면 버리지 않음
+    int removed;                    // 고정된 채로 지워짐: 마지막 Release에서 해제
+    struct FrameCacheEntry* newer;  // LRU 목록 (newest = 가장 최근에 씀)
+    struct FrameCacheEntry* older;
+    struct FrameCacheEntry* nextInBucket;
+} FrameCacheEntry;
+
+// 소유자별 사용량 (종류별)
+typedef struct {
+    size_t bytes[FRAME_CACHE_MAX_KINDS];
+    int count[FRAME_CACHE_MAX_KINDS];
+    unsigned long long evictions;   // 예산 때문에 버려진 항목 수 (전 종류)
+    int hidden;                     // 1 = 먼저 버림
+} FrameCacheOwner;
+
+// 종류별 누적 통계
+typedef struct {
+    unsigned long long hits[FRAME_CACHE_MAX_KINDS];
+    unsigned long long misses[FRAME_CACHE_MAX_KINDS];
+    unsigned long long inserts[FRAME_CACHE_MAX_KINDS];
+    unsigned long long evictions[FRAME_CACHE_MAX_KINDS];
+    unsigned long long hiddenEvictions;     // evictions 중 숨긴 소유자 항목
+} FrameCacheStats;
+
+typedef struct {
+    size_t budget;
+    size_t used;                    // 고정된 채로 지워져서 아직 해제 안 된 항목 포함
+    int entryCount;
+    FrameCacheEntry** buckets;      // 해시 (체인), 항목 수가 늘면 2배로
+    int bucketCount;                // 2의 거듭제곱
+    FrameCacheEntry* newest;
+    FrameCacheEntry* oldest;
+    FrameCacheOwner owners[FRAME_CACHE_MAX_OWNERS];
+    FrameCacheStats stats;
+} FrameCache;
+
+// 초기화 / 정리 (정리할 때는 고정된 항목도 모두 해제)
+int FrameCache_Init(FrameCache* c, size_t budget);
+void FrameCache_Free(FrameCache* c);
+
+// 예산 변경 (줄이면 바로 넘는 만큼 버림)
+void FrameCache_SetBudget(FrameCache* c, size_t budget);
+
+// 찾기: 있으면 최근으로 옮기고 고정해서 반환 (다 쓰면 Release), 없으면 NULL (적중 / 실패 통계에 셈)
+FrameCacheEntry* FrameCache_Acquire(FrameCache* c, int owner, int kind, int index);
+
+// 찾아서 고정만 (통계와 LRU 순서는 그대로: 배경 작업이 원본으로 읽을 때)
+FrameCacheEntry* FrameCache_Pin(FrameCache* c, int owner, int kind, int index);
+
+// 있는지만 확인 (부수 효과 없음)
+int FrameCache_Contains(const FrameCache* c, int owner, int kind, int index);
+
+void FrameCache_Release(FrameCache* c, FrameCacheEntry* entry);
+
+// 넣기: data(malloc한 bytes바이트)를 넘겨받고 고정한 항목 반환, 예산에 맞출 만큼 버릴 수 없으면 NULL (data는 그대로 호출한 쪽 소유)
+// 같은 키가 있으면 바꿈 (고정돼 있으면 NULL)
+FrameCacheEntry* FrameCache_Insert(FrameCache* c, int owner, int kind, int index, void* data, size_t bytes);
+
+// 소유자의 kind 항목 모두 지우기 (kind < 0 = 모든 종류), 통계의 버림에는 안 셈
+void FrameCache_Remove(FrameCache* c, int owner, int kind);
+
+// 숨긴 소유자 표시 (예산을 넘으면 이쪽 항목부터 버림)
+void FrameCache_SetHidden(FrameCache* c, int owner, int hidden);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FRAME_CACHE_H
@@ -0,0 +1,393 @@
+/*
+ * gif_decoder.cpp - Streaming GIF Decoder
+ * LZW 사전은 문자열을 따로 저장하지 않고 출력 안에 처음 나온 위치 + 길이로만 기억함
+ * 새 코드 = 앞 문자열 + 이번 문자열 첫 바이트 = 출력에서 앞 문자열 위치부터 한 바이트 더 (바로 뒤에 이어 나왔으므로)
+ * 코드 하나 출력 = 앞쪽 출력에서 복사 한 번 (접두사 사슬을 거꾸로 따라가지 않음)
+ */
+
+#include "gif_decoder.h"
+#include "dsp_kernels.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static inline int ReadLE16(const unsigned char* p) { return p[0] | (p[1] << 8); }
+
+// RGB 팔레트 -> 불투명 BGRA (count 뒤 항목은 검정)
+static void ReadPalette(unsigned int* palette, const unsigned char* rgb, int count) {
+    for (int i = 0; i < count; i++) {
+        palette[i] = 0xFF000000u | ((unsigned int)rgb[3 * i] << 16) | ((unsigned int)rgb[3 * i + 1] << 8) |
+                     rgb[3 * i + 2];
+    }
+    for (int i = count; i < 256; i++) palette[i] = 0xFF000000u;
+}
+
+// 데이터 하위 블록 건너뛰기, 반환값 = 종료 블록 다음 위치 (잘렸으면 0)
+static size_t SkipSubBlocks(const unsigned char* data, size_t size, size_t pos) {
+    while (pos < size) {
+        unsigned int length = data[pos++];
+        if (length == 0) return pos;
+        pos += length;
+    }
+    return 0;
+}
+
+static int AddFrame(GifDecoder* d, const GifFrameInfo* info, int* capacity) {
+    if (d->frameCount == *capacity) {
+        int grown = *capacity ? *capacity * 2 : 16;
+        GifFrameInfo* frames = (GifFrameInfo*)realloc(d->frames, sizeof(GifFrameInfo) * grown);
+        if (!frames) return 0;
+        d->frames = frames;
+        *capacity = grown;
+    }
+    d->frames[d->frameCount++] = *info;
+    return 1;
+}
+
+int GifDecoder_Open(GifDecoder* d, const unsigned char* data, size_t size) {
+    if (!d) return 0;
+    memset(d, 0, sizeof(GifDecoder));
+    if (!data || size < 13) return 0;
+    if (memcmp(data, "GIF87a", 6) != 0 && memcmp(data, "GIF89a", 6) != 0) return 0;
+
+    d->data = data;
+    d->size = size;
+    d->width = ReadLE16(data + 6);
+    d->height = ReadLE16(data + 8);
+    d->loopCount = -1;
+    if (d->width <= 0 || d->height <= 0 || d->width > GIF_MAX_SIZE || d->height > GIF_MAX_SIZE) return 0;
+
+    size_t pos = 13;
+    int flags = data[10];
+    if (flags & 0x80) {
+        int colors = 2 << (flags & 7);
+        if (pos + 3 * colors > size) return 0;
+        ReadPalette(d->globalPalette, data + pos, colors);
+        d->hasGlobalPalette = 1;
+        pos += 3 * colors;
+    } else {
+        ReadPalette(d->globalPalette, data, 0);
+    }
+
+    // 그래픽 제어 확장은 바로 다음 이미지에만 적용
+    GifFrameInfo control;
+    memset(&control, 0, sizeof(control));
+    control.transparent = -1;
+    int capacity = 0;
+
+    // 잘린 파일은 온전한 설명자까지만 (마지막 이미지 데이터가 잘렸으면 그리면서 complete = 0)
+    while (pos < size) {
+        int block = data[pos++];
+        if (block == 0x3B) break;
+
+        if (block == 0x21) {
+            if (pos >= size) break;
+            int label = data[pos++];
+            if (label == 0xF9 && pos + 5 <= size && data[pos] >= 4) {
+                int packed = data[pos + 1];
+                control.delay = ReadLE16(data + pos + 2);
+                control.disposal = (packed >> 2) & 7;
+                if (control.disposal > GIF_DISPOSE_PREVIOUS) control.disposal = GIF_DISPOSE_NONE;
+                control.transparent = (packed & 1) ? data[pos + 4] : -1;
+            } else if (label == 0xFF && pos + 12 <= size && data[pos] == 11 &&
+                       (memcmp(data + pos + 1, "NETSCAPE2.0", 11) == 0 ||
+                        memcmp(data + pos + 1, "ANIMEXTS1.0", 11) == 0)) {
+                size_t sub = pos + 12;
+                if (sub + 4 <= size && data[sub] >= 3 && data[sub + 1] == 1) {
+                    d->loopCount = ReadLE16(data + sub + 2);
+                }
+            }
+            pos = SkipSubBlocks(data, size, pos);
+            if (pos == 0) break;
+        } else if (block == 0x2C) {
+            if (pos + 10 > size) break;
+            GifFrameInfo info = control;
+            info.offset = pos - 1;
+            info.x = ReadLE16(data + pos);
+            info.y = ReadLE16(data + pos + 2);
+            info.width = ReadLE16(data + pos + 4);
+            info.height = ReadLE16(data + pos + 6);
+            int packed = data[pos + 8];
+            info.interlaced = (packed & 0x40) != 0;
+            pos += 9;
+            if (packed & 0x80) pos += 3 * (2 << (packed & 7));
+            pos++;      // LZW 최소 코드 크기
+            if (pos > size) break;
+
+            if (!AddFrame(d, &info, &capacity)) break;
+            memset(&control, 0, sizeof(control));
+            control.transparent = -1;
+
+            pos = SkipSubBlocks(data, size, pos);
+            if (pos == 0) break;
+        } else {
+            break;      // 알 수 없는 블록: 여기까지만
+        }
+    }
+
+    if (d->frameCount == 0) {
+        GifDecoder_Close(d);
+        return 0;
+    }
+    return 1;
+}
+
+void GifDecoder_Close(GifDecoder* d) {
+    if (!d) return;
+    free(d->frames);
+    free(d->saved);
+    free(d->indices);
+    memset(d, 0, sizeof(GifDecoder));
+}
+
+void GifDecoder_Rewind(GifDecoder* d) {
+    if (!d) return;
+    d->nextFrame = 0;
+    d->pendingDisposal = GIF_DISPOSE_NONE;
+}
+
+void GifDecoder_Seek(GifDecoder* d, int frame) {
+    if (!d) return;
+    d->nextFrame = frame < 0 ? 0 : (frame > d->frameCount ? d->frameCount : frame);
+    d->pendingDisposal = GIF_DISPOSE_NONE;
+}
+
+int GifDecoder_IsKeyFrame(const GifDecoder* d, int frame) {
+    if (!d || !d->frames || frame < 0 || frame >= d->frameCount) return 0;
+    if (frame == 0) return 1;
+    const GifFrameInfo* info = &d->frames[frame];
+    return info->x == 0 && info->y == 0 && info->width >= d->width && info->height >= d->height &&
+           info->transparent < 0 && info->disposal != GIF_DISPOSE_PREVIOUS;
+}
+
+// 이미지 데이터 하위 블록 -> 인덱스 (count개까지), 반환값 = 채운 인덱스 수
+static size_t DecodeLzw(GifDecoder* d, const unsigned char* p, const unsigned char* end, int minCodeSize,
+                        unsigned char* out, size_t count) {
+    if (minCodeSize < 1 || minCodeSize > 8) return 0;
+
+    const int clear = 1 << minCodeSize;
+    const int eoi = clear + 1;
+    int codeSize = minCodeSize + 1;
+    int codeMask = (1 << codeSize) - 1;
+    int next = clear + 2;
+    int havePrevious = 0;
+    size_t previousStart = 0, previousLength = 0;
+    size_t pos = 0;
+
+    unsigned int bitBuffer = 0;
+    int bitCount = 0;
+    unsigned int blockLeft = 0;
+
+    while (pos < count) {
+        // 코드 하나만큼 비트 채우기 (하위 블록 경계를 넘어감)
+        while (bitCount < codeSize) {
+            if (blockLeft == 0) {
+                if (p >= end) return pos;
+                blockLeft = *p++;
+                if (blockLeft == 0) return pos;     // 종료 블록
+            }
+            if (p >= end) return pos;
+            bitBuffer |= (unsigned int)*p++ << bitCount;
+            bitCount += 8;
+            blockLeft--;
+        }
+        int code = (int)(bitBuffer & codeMask);
+        bitBuffer >>= codeSize;
+        bitCount -= codeSize;
+
+        if (code == clear) {
+            codeSize = minCodeSize + 1;
+            codeMask = (1 << codeSize) - 1;
+            next = clear + 2;
+            havePrevious = 0;
+            continue;
+        }
+        if (code == eoi) break;
+
+        size_t length;
+        if (code < clear) {
+            out[pos] = (unsigned char)code;
+            length = 1;
+        } else if (!havePrevious) {
+            break;      // 지우기 직후에는 한 글자 코드만 올 수 있음
+        } else if (code < next) {
+            size_t start = d->codeStart[code];
+            length = d->codeLength[code];
+            if (length > count - pos) length = count - pos;
+            unsigned char* dst = out + pos;
+            const unsigned char* src = out + start;     // start + length <= pos (앞쪽 출력)
+            if (length >= 16) {
+                memcpy(dst, src, length);
+            } else {
+                for (size_t i = 0; i < length; i++) dst[i] = src[i];
+            }
+        } else if (code == next) {
+            // KwKwK: 앞 문자열 + 앞 문자열 첫 바이트
+            length = previousLength + 1;
+            size_t copy = previousLength < count - pos ? previousLength : count - pos;
+            memmove(out + pos, out + previousStart, copy);
+            if (copy == previousLength && pos + copy < count) out[pos + copy] = out[previousStart];
+            if (length > count - pos) length = count - pos;
+        } else {
+            break;      // 아직 없는 코드
+        }
+
+        if (havePrevious && next < GIF_LZW_MAX_CODES) {
+            d->codeStart[next] = (unsigned int)previousStart;
+            d->codeLength[next] = (unsigned short)(previousLength + 1);
+            next++;
+            if (next > codeMask && codeSize < 12) {
+                codeSize++;
+                codeMask = (1 << codeSize) - 1;
+            }
+        }
+        havePrevious = 1;
+        previousStart = pos;
+        previousLength = length;
+        pos += length;
+    }
+    return pos;
+}
+
+// 인터레이스 저장 순서 row -> 실제 행 (8n, 8n+4, 4n+2, 2n+1 순)
+static int InterlacedRow(int row, int height) {
+    int pass = (height + 7) / 8;
+    if (row < pass) return row * 8;
+    row -= pass;
+    pass = (height + 3) / 8;
+    if (row < pass) return 4 + row * 8;
+    row -= pass;
+    pass = (height + 1) / 4;
+    if (row < pass) return 2 + row * 4;
+    row -= pass;
+    return 1 + row * 2;
+}
+
+static void ClearRect(unsigned int* canvas, size_t stride, int x, int y, int width, int height) {
+    for (int row = 0; row < height; row++) {
+        unsigned int* dst = (unsigned int*)((unsigned char*)canvas + (size_t)(y + row) * stride) + x;
+        memset(dst, 0, sizeof(unsigned int) * width);
+    }
+}
+
+// 앞 프레임 disposal (첫 프레임이면 화면 전체를 투명으로)
+static void ApplyPendingDisposal(GifDecoder* d, unsigned int* canvas, size_t stride) {
+    if (d->nextFrame == 0) {
+        ClearRect(canvas, stride, 0, 0, d->width, d->height);
+    } else if (d->pendingDisposal == GIF_DISPOSE_BACKGROUND) {
+        ClearRect(canvas, stride, d->disposeX, d->disposeY, d->disposeWidth, d->disposeHeight);
+    } else if (d->pendingDisposal == GIF_DISPOSE_PREVIOUS) {
+        for (int row = 0; row < d->disposeHeight; row++) {
+            unsigned int* dst = (unsigned int*)((unsigned char*)canvas + (size_t)(d->disposeY + row) * stride) +
+                                d->disposeX;
+            memcpy(dst, d->saved + (size_t)row * d->disposeWidth, sizeof(unsigned int) * d->disposeWidth);
+        }
+    }
+    d->pendingDisposal = GIF_DISPOSE_NONE;
+}
+
+void GifDecoder_ApplyDisposal(GifDecoder* d, unsigned int* canvas, size_t stride) {
+    if (!d || !d->frames || !canvas || d->nextFrame >= d->frameCount) return;
+    ApplyPendingDisposal(d, canvas, stride);
+}
+
+int GifDecoder_NextFrame(GifDecoder* d, unsigned int* canvas, size_t stride, GifFrame* frame) {
+    if (!d || !d->frames || !canvas || d->nextFrame >= d->frameCount) return 0;
+
+    ApplyPendingDisposal(d, canvas, stride);
+
+    const GifFrameInfo* info = &d->frames[d->nextFrame];
+
+    // 논리 화면으로 자른 영역
+    int x0 = info->x < d->width ? info->x : d->width;
+    int y0 = info->y < d->height ? info->y : d->height;
+    int x1 = info->x + info->width < d->width ? info->x + info->width : d->width;
+    int y1 = info->y + info->height < d->height ? info->y + info->height : d->height;
+    int clipWidth = x1 - x0, clipHeight = y1 - y0;
+
+    // 그리기 전 영역 보관 (이 프레임을 보여준 뒤 되돌림, 메모리가 모자라면 그대로 둠)
+    int disposal = info->disposal;
+    if (clipWidth <= 0 || clipHeight <= 0) disposal = GIF_DISPOSE_NONE;
+    if (disposal == GIF_DISPOSE_PREVIOUS) {
+        size_t need = (size_t)clipWidth * clipHeight;
+        if (need > d->savedCapacity) {
+            unsigned int* saved = (unsigned int*)realloc(d->saved, sizeof(unsigned int) * need);
+            if (saved) {
+                d->saved = saved;
+                d->savedCapacity = need;
+            }
+        }
+        if (need <= d->savedCapacity) {
+            for (int row = 0; row < clipHeight; row++) {
+                const unsigned int* src = (const unsigned int*)((const unsigned char*)canvas +
+                                                                 (size_t)(y0 + row) * stride) + x0;
+                memcpy(d->saved + (size_t)row * clipWidth, src, sizeof(unsigned int) * clipWidth);
+            }
+        } else {
+            disposal = GIF_DISPOSE_NONE;
+        }
+    }
+
+    // 팔레트 + LZW
+    const unsigned char* p = d->data + info->offset + 10;
+    const unsigned char* end = d->data + d->size;
+    int packed = d->data[info->offset + 9];
+    if (packed & 0x80) {
+        ReadPalette(d->palette, p, 2 << (packed & 7));
+        p += 3 * (2 << (packed & 7));
+    } else {
+        memcpy(d->palette, d->globalPalette, sizeof(d->palette));
+    }
+
+    size_t count = (size_t)info->width * info->height;
+    size_t decoded = 0;
+    if (count > 0 && count > d->indicesCapacity) {
+        unsigned char* indices = (unsigned char*)realloc(d->indices, count);
+        if (indices) {
+            d->indices = indices;
+            d->indicesCapacity = count;
+        }
+    }
+    if (count > 0 && count <= d->indicesCapacity && p < end) {
+        int minCodeSize = *p++;
+        decoded = DecodeLzw(d, p, end, minCodeSize, d->indices, count);
+    }
+
+    // 합성 (투명 인덱스는 건너뜀, 디코딩된 픽셀까지만): 행마다 SIMD 팔레트 커널 한 번
+    const DspKernels* kernels = DspKernels_Get();
+    int fullRows = info->width > 0 ? (int)(decoded / info->width) : 0;
+    int lastColumns = info->width > 0 ? (int)(decoded % info->width) : 0;
+    int transparent = info->transparent;
+    for (int row = 0; row < info->height && row <= fullRows; row++) {
+        int columns = row < fullRows ? info->width : lastColumns;
+        int y = info->y + (info->interlaced ? InterlacedRow(row, info->height) : row);
+        if (y >= y1 || columns == 0) continue;
+
+        int visible = x1 - info->x < columns ? x1 - info->x : columns;
+        const unsigned char* src = d->indices + (size_t)row * info->width;
+        unsigned int* dst = (unsigned int*)((unsigned char*)canvas + (size_t)y * stride) + info->x;
+        if (transparent < 0) {
+            kernels->paletteExpand(src, d->palette, dst, visible);
+        } else {
+            kernels->paletteComposite(src, d->palette, dst, visible, transparent);
+        }
+    }
+
+    d->pendingDisposal = disposal;
+    d->disposeX = x0;
+    d->disposeY = y0;
+    d->disposeWidth = clipWidth > 0 ? clipWidth : 0;
+    d->disposeHeight = clipHeight > 0 ? clipHeight : 0;
+
+    if (frame) {
+        frame->index = d->nextFrame;
+        frame->x = x0;
+        frame->y = y0;
+        frame->width = d->disposeWidth;
+        frame->height = d->disposeHeight;
+        frame->delay = info->delay;
+        frame->complete = count > 0 && decoded == count;
+    }
+    d->nextFrame++;
+    return 1;
+}
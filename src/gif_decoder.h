@@ -0,0 +1,98 @@
+/*
+ * gif_decoder.h - Streaming GIF Decoder (platform-neutral)
+ *
+ * GIF87a / GIF89a: LZW, 전역 / 지역 팔레트, 인터레이스, disposal 0~3, 투명색, NETSCAPE2.0 반복 횟수
+ * 파일 전체를 메모리로 받아서 열 때 블록 구조만 훑어 프레임 목록(위치, 딜레이, 영역)을 만들고
+ * 프레임은 하나씩 호출한 쪽 캔버스(프리멀티플라이 BGRA, 논리 화면 크기)에 합성
+ * 캔버스는 이전 프레임 결과를 그대로 들고 다시 넘겨야 함 (disposal을 다음 프레임 앞에서 적용)
+ */
+
+#ifndef GIF_DECODER_H
+#define GIF_DECODER_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GIF_MAX_SIZE 16384          // 논리 화면 한 변 상한 (캔버스 크기 계산 넘침 방지)
+#define GIF_LZW_MAX_CODES 4096      // 12비트 코드
+
+// 프레임을 보여준 뒤 다음 프레임 전에 할 일
+#define GIF_DISPOSE_NONE 0          // 지정 안 함 (그대로 둠)
+#define GIF_DISPOSE_KEEP 1          // 그대로 둠
+#define GIF_DISPOSE_BACKGROUND 2    // 영역을 투명으로 (브라우저 / GDI+와 같게 배경색 대신 투명)
+#define GIF_DISPOSE_PREVIOUS 3      // 영역을 그리기 전 상태로
+
+// 프레임 목록 항목 (열 때 채움)
+typedef struct {
+    size_t offset;          // 이미지 설명자(0x2C) 위치
+    int x, y;               // 논리 화면 안 영역 (화면 밖은 잘라서 그림)
+    int width, height;
+    int delay;              // 1/100초 (그래픽 제어 확장이 없으면 0)
+    int disposal;           // GIF_DISPOSE_*
+    int transparent;        // 투명 인덱스 (-1 = 없음)
+    int interlaced;
+} GifFrameInfo;
+
+typedef struct {
+    const unsigned char* data;      // 파일 내용 (닫을 때까지 호출한 쪽이 유지)
+    size_t size;
+    int width;                      // 논리 화면 크기
+    int height;
+    int loopCount;                  // NETSCAPE2.0 반복 횟수 (0 = 무한, -1 = 확장 없음)
+    int frameCount;
+    GifFrameInfo* frames;           // [frameCount]
+    unsigned int globalPalette[256];    // 프리멀티플라이 BGRA (불투명, 없는 항목은 검정)
+    int hasGlobalPalette;
+
+    // 재생 상태
+    int nextFrame;                  // 다음에 합성할 프레임
+    int pendingDisposal;            // 앞 프레임 disposal (다음 호출 처음에 적용)
+    int disposeX, disposeY, disposeWidth, disposeHeight;    // 잘라낸 앞 프레임 영역
+    unsigned int* saved;            // GIF_DISPOSE_PREVIOUS용 그리기 전 영역
+    size_t savedCapacity;
+    unsigned char* indices;         // 프레임 영역 인덱스 (인터레이스면 저장된 행 순서)
+    size_t indicesCapacity;
+    unsigned int palette[256];      // 이번 프레임 팔레트
+
+    // LZW 사전: 코드 문자열 = indices 안에 처음 나온 위치부터 length바이트
+    unsigned int codeStart[GIF_LZW_MAX_CODES];
+    unsigned short codeLength[GIF_LZW_MAX_CODES];
+} GifDecoder;
+
+// 이번 호출에서 합성한 프레임
+typedef struct {
+    int index;
+    int x, y;               // 캔버스에서 바뀐 영역 (앞 프레임 disposal 영역은 포함 안 함)
+    int width, height;
+    int delay;              // 1/100초
+    int complete;           // 0 = 이미지 데이터가 잘렸거나 깨져서 앞부분만 그림
+} GifFrame;
+
+// 열기: 헤더와 블록 구조 확인, 프레임 목록 작성 (data는 복사하지 않음), 반환값 = 프레임이 하나 이상 있는지
+int GifDecoder_Open(GifDecoder* d, const unsigned char* data, size_t size);
+void GifDecoder_Close(GifDecoder* d);
+
+// 다음 프레임을 캔버스에 합성 (stride = 행 간격 바이트, 첫 프레임 앞에서는 캔버스 전체를 투명으로 지움)
+// 반환값 = 1 프레임 합성, 0 마지막 프레임 뒤 (Rewind로 처음부터)
+int GifDecoder_NextFrame(GifDecoder* d, unsigned int* canvas, size_t stride, GifFrame* frame);
+
+// 처음 프레임부터 다시
+void GifDecoder_Rewind(GifDecoder* d);
+
+// 앞 프레임 disposal만 지금 적용 (캔버스 = nextFrame을 그리기 직전 상태, 체크포인트 저장용)
+void GifDecoder_ApplyDisposal(GifDecoder* d, unsigned int* canvas, size_t stride);
+
+// 다음 프레임을 frame으로 (캔버스는 호출한 쪽이 frame 직전 상태로 맞춰 둬야 함: 저장한 체크포인트나 키프레임)
+void GifDecoder_Seek(GifDecoder* d, int frame);
+
+// 키프레임: 앞 캔버스와 상관없이 그려지는 프레임 (첫 프레임, 또는 투명색 없이 화면 전체를 덮고 PREVIOUS가 아님)
+int GifDecoder_IsKeyFrame(const GifDecoder* d, int frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GIF_DECODER_H
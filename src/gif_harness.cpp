@@ -0,0 +1,1041 @@
+/*
+ * gif_harness.cpp - GIF Decoder Conformance / Benchmark Harness (platform-neutral, 콘솔)
+ *
+ * --check: 직접 인코딩한 GIF 묶음(팔레트, 인터레이스, disposal, 투명색, 사전 가득 참, 잘린 파일 등)을
+ *          GifDecoder로 풀어서 GIF를 거치지 않은 기준 합성 결과와 프레임마다 비교 (SIMD 커널마다)
+ *          + 팔레트 커널(인덱스 -> BGRA, 투명 합성)을 무작위 입력에서 스칼라 구현과 비교
+ *          + 체크포인트 / 키프레임에서 이어 디코딩 (Seek), 프레임 캐시(LRU, 숨긴 소유자 먼저, 고정, 예산)
+ * --write-corpus DIR: 같은 묶음을 .gif 파일로 저장 (다른 디코더와 비교용)
+ * --bench FILE...: 파일별 디코딩 속도 (입력 MB/s, 프레임/s, 출력 메가픽셀/s)
+ * --bench-kernels FILE...: 파일의 실제 프레임 인덱스로 팔레트 커널별 ns/픽셀 + 커널별 디코딩 속도
+ * FILE.gif: 구조 정보 (크기, 반복, 프레임별 영역 / 딜레이 / disposal)
+ *
+ * 빌드: Linux  ./build-harness.sh
+ *       MSVC   cl /O2 /EHsc /std:c++17 src\gif_harness.cpp src\gif_decoder.cpp src\dsp_kernels.cpp src\frame_cache.cpp
+ *              /Fe:gif_harness.exe
+ */
+
+#include "gif_decoder.h"
+#include "dsp_kernels.h"
+#include "frame_cache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+#define CORPUS_MAX_FRAMES 8
+#define BENCH_MIN_SECONDS 1.0   // 파일마다 최소 이만큼 반복
+#define KERNEL_BENCH_SECONDS 0.3    // 커널 / 디코딩 측정 하나당
+#define MAX_KERNELS 8
+
+static double NowSec(void) {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static unsigned char* LoadFile(const char* path, size_t* size) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "error: cannot open %s\n", path);
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long length = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    unsigned char* data = (unsigned char*)malloc(length > 0 ? (size_t)length : 1);
+    *size = data ? fread(data, 1, (size_t)length, f) : 0;
+    fclose(f);
+    return data;
+}
+
+// ---------------------------------------------------------------------------
+// 인코더 (검증 묶음 생성용, 디코더와 코드를 나누지 않음)
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    unsigned char* data;
+    size_t size;
+    size_t capacity;
+} ByteBuffer;
+
+static void Put(ByteBuffer* b, const void* bytes, size_t count) {
+    if (b->size + count > b->capacity) {
+        size_t grown = b->capacity ? b->capacity * 2 : 4096;
+        while (grown < b->size + count) grown *= 2;
+        b->data = (unsigned char*)realloc(b->data, grown);
+        b->capacity = grown;
+    }
+    memcpy(b->data + b->size, bytes, count);
+    b->size += count;
+}
+
+static void PutByte(ByteBuffer* b, int value) {
+    unsigned char c = (unsigned char)value;
+    Put(b, &c, 1);
+}
+
+static void PutLE16(ByteBuffer* b, int value) {
+    PutByte(b, value & 0xFF);
+    PutByte(b, (value >> 8) & 0xFF);
+}
+
+// 사전이 가득 찼을 때
+#define CLEAR_WHEN_FULL 0       // 지우기 코드 (일반 인코더)
+#define CLEAR_NEVER 1           // 12비트 그대로 계속 (지연된 지우기: 디코더는 새 항목 없이 읽어야 함)
+#define CLEAR_OFTEN 2           // 사전이 차기 전에도 자주 지움
+
+// LZW 비트열 -> blockSize바이트 하위 블록
+typedef struct {
+    ByteBuffer* out;
+    int blockSize;
+    unsigned char block[255];
+    int blockLength;
+    unsigned int bits;
+    int bitCount;
+} BitWriter;
+
+static void FlushBlock(BitWriter* w) {
+    if (w->blockLength == 0) return;
+    PutByte(w->out, w->blockLength);
+    Put(w->out, w->block, w->blockLength);
+    w->blockLength = 0;
+}
+
+static void PutCode(BitWriter* w, int code, int size) {
+    w->bits |= (unsigned int)code << w->bitCount;
+    w->bitCount += size;
+    while (w->bitCount >= 8) {
+        w->block[w->blockLength++] = (unsigned char)w->bits;
+        w->bits >>= 8;
+        w->bitCount -= 8;
+        if (w->blockLength == w->blockSize) FlushBlock(w);
+    }
+}
+
+// 인코더는 코드를 낸 뒤 바로 사전에 넣고, 디코더는 다음 코드를 읽을 때 넣으므로 항상 한 항목 앞섬
+// -> 다음 코드 번호가 2^크기를 넘을 때 (디코더가 2^크기에 닿을 때) 코드 크기를 늘림
+static void EncodeLzw(ByteBuffer* out, const unsigned char* indices, size_t count, int minCodeSize,
+                      int blockSize, int clearMode) {
+    static short table[GIF_LZW_MAX_CODES][256];     // (접두사 코드, 바이트) -> 코드
+    const int clear = 1 << minCodeSize;
+    const int eoi = clear + 1;
+
+    BitWriter w;
+    memset(&w, 0, sizeof(w));
+    w.out = out;
+    w.blockSize = blockSize;
+
+    PutByte(out, minCodeSize);
+    int codeSize = minCodeSize + 1;
+    int next = clear + 2;
+    memset(table, 0xFF, sizeof(table));
+    PutCode(&w, clear, codeSize);
+
+    int prefix = count > 0 ? indices[0] : -1;
+    for (size_t i = 1; i < count; i++) {
+        int c = indices[i];
+        if (table[prefix][c] >= 0) {
+            prefix = table[prefix][c];
+            continue;
+        }
+        PutCode(&w, prefix, codeSize);
+
+        if (next < GIF_LZW_MAX_CODES) {
+            table[prefix][c] = (short)next++;
+            if (next > (1 << codeSize) && codeSize < 12) codeSize++;
+        }
+        if ((next == GIF_LZW_MAX_CODES && clearMode == CLEAR_WHEN_FULL) ||
+            (next - clear - 2 >= 300 && clearMode == CLEAR_OFTEN)) {
+            PutCode(&w, clear, codeSize);
+            codeSize = minCodeSize + 1;
+            next = clear + 2;
+            memset(table, 0xFF, sizeof(table));
+        }
+        prefix = c;
+    }
+    if (prefix >= 0) {
+        PutCode(&w, prefix, codeSize);
+        // 디코더가 마지막 코드를 읽으며 넣을 항목 때문에 코드 크기가 늘 수 있음
+        if (next < GIF_LZW_MAX_CODES && next == (1 << codeSize) && codeSize < 12) codeSize++;
+    }
+    PutCode(&w, eoi, codeSize);
+    if (w.bitCount > 0) PutCode(&w, 0, 8 - w.bitCount);
+    FlushBlock(&w);
+    PutByte(out, 0);
+}
+
+// ---------------------------------------------------------------------------
+// 검증 묶음
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    int x, y, width, height;
+    int disposal;
+    int transparent;        // -1 = 없음
+    int delay;
+    int interlaced;
+    int localColors;        // 0 = 전역 팔레트
+    unsigned int localPalette[256];
+    unsigned char* pixels;  // [width * height] 표시 순서 인덱스
+} CorpusFrame;
+
+typedef struct {
+    const char* name;
+    int width, height;
+    int globalColors;       // 0 = 전역 팔레트 없음
+    unsigned int globalPalette[256];
+    int loopCount;          // -1 = NETSCAPE 확장 없음
+    int blockSize;          // 하위 블록 길이 (1~255)
+    int clearMode;
+    size_t truncate;        // 0이 아니면 파일을 이 길이로 자름
+    int frameCount;
+    CorpusFrame frames[CORPUS_MAX_FRAMES];
+} CorpusCase;
+
+static unsigned int g_seed = 1;
+
+static unsigned int Random(void) {
+    g_seed = g_seed * 1664525u + 1013904223u;
+    return g_seed >> 8;
+}
+
+static void RandomPalette(unsigned int* palette, int colors) {
+    for (int i = 0; i < colors; i++) palette[i] = 0xFF000000u | (Random() & 0xFFFFFF);
+}
+
+// 무늬: 0 = 잡음 (사전이 빨리 참), 1 = 긴 같은 값 (KwKwK), 2 = 대각 그라데이션, 3 = 체크
+static void FillPattern(unsigned char* pixels, int width, int height, int colors, int pattern) {
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int v;
+            switch (pattern) {
+                case 0: v = Random() % colors; break;
+                case 1: v = ((x + y * width) / 37) % colors; break;
+                case 2: v = (x + y) % colors; break;
+                default: v = ((x / 3 + y / 3) & 1) ? colors - 1 : 0; break;
+            }
+            pixels[y * width + x] = (unsigned char)v;
+        }
+    }
+}
+
+static CorpusFrame* AddCorpusFrame(CorpusCase* c, int x, int y, int width, int height, int pattern) {
+    CorpusFrame* f = &c->frames[c->frameCount++];
+    memset(f, 0, sizeof(CorpusFrame));
+    f->x = x;
+    f->y = y;
+    f->width = width;
+    f->height = height;
+    f->transparent = -1;
+    f->delay = 4 + c->frameCount;
+    f->pixels = (unsigned char*)malloc((size_t)width * height + 1);
+    FillPattern(f->pixels, width, height, c->globalColors ? c->globalColors : 2, pattern);
+    return f;
+}
+
+static void NewCase(CorpusCase* c, const char* name, int width, int height, int colors) {
+    memset(c, 0, sizeof(CorpusCase));
+    c->name = name;
+    c->width = width;
+    c->height = height;
+    c->globalColors = colors;
+    c->loopCount = -1;
+    c->blockSize = 255;
+    RandomPalette(c->globalPalette, colors);
+}
+
+static void SetLocalPalette(CorpusFrame* f, int colors, int pattern) {
+    f->localColors = colors;
+    RandomPalette(f->localPalette, colors);
+    FillPattern(f->pixels, f->width, f->height, colors, pattern);
+}
+
+#define CORPUS_CASES 15
+
+static void BuildCase(int index, CorpusCase* c) {
+    g_seed = 1000u + index;
+    CorpusFrame* f;
+    switch (index) {
+        case 0:
+            NewCase(c, "full-table-clear", 160, 120, 256);
+            AddCorpusFrame(c, 0, 0, 160, 120, 0);
+            break;
+        case 1:
+            NewCase(c, "deferred-clear", 160, 120, 256);
+            c->clearMode = CLEAR_NEVER;
+            AddCorpusFrame(c, 0, 0, 160, 120, 0);
+            break;
+        case 2:
+            NewCase(c, "frequent-clear", 97, 61, 64);
+            c->clearMode = CLEAR_OFTEN;
+            AddCorpusFrame(c, 0, 0, 97, 61, 2);
+            break;
+        case 3:
+            NewCase(c, "two-colors-runs", 333, 17, 2);
+            AddCorpusFrame(c, 0, 0, 333, 17, 1);
+            AddCorpusFrame(c, 0, 0, 333, 17, 3);
+            break;
+        case 4:
+            NewCase(c, "one-byte-blocks", 50, 40, 16);
+            c->blockSize = 1;
+            AddCorpusFrame(c, 0, 0, 50, 40, 0);
+            break;
+        case 5:
+            NewCase(c, "local-palettes", 40, 30, 0);
+            f = AddCorpusFrame(c, 0, 0, 40, 30, 2);
+            SetLocalPalette(f, 4, 2);
+            f = AddCorpusFrame(c, 5, 5, 20, 10, 0);
+            SetLocalPalette(f, 16, 0);
+            f = AddCorpusFrame(c, 10, 3, 25, 25, 1);
+            SetLocalPalette(f, 256, 0);
+            break;
+        case 6:
+            NewCase(c, "local-over-global", 32, 32, 8);
+            AddCorpusFrame(c, 0, 0, 32, 32, 2);
+            f = AddCorpusFrame(c, 8, 8, 16, 16, 0);
+            SetLocalPalette(f, 32, 0);
+            AddCorpusFrame(c, 4, 4, 8, 8, 0);
+            break;
+        case 7: {
+            // 인터레이스 행 순서가 갈리는 높이들
+            static const int heights[] = { 1, 2, 3, 5, 9, 13, 17, 30 };
+            NewCase(c, "interlaced", 24, 30, 32);
+            for (int i = 0; i < CORPUS_MAX_FRAMES; i++) {
+                f = AddCorpusFrame(c, i, 0, 24 - i, heights[i], i & 1 ? 0 : 2);
+                f->interlaced = 1;
+            }
+            break;
+        }
+        case 8:
+            NewCase(c, "transparent-keep", 48, 36, 16);
+            c->loopCount = 0;
+            AddCorpusFrame(c, 0, 0, 48, 36, 2);
+            for (int i = 0; i < 3; i++) {
+                f = AddCorpusFrame(c, 4 + i * 8, 3 + i * 5, 20, 14, 0);
+                f->transparent = 3 + i;
+                f->disposal = i == 1 ? GIF_DISPOSE_NONE : GIF_DISPOSE_KEEP;
+            }
+            break;
+        case 9:
+            NewCase(c, "transparent-first", 30, 20, 4);
+            f = AddCorpusFrame(c, 0, 0, 30, 20, 3);
+            f->transparent = 0;
+            f = AddCorpusFrame(c, 5, 5, 10, 10, 0);
+            f->transparent = 1;
+            break;
+        case 10:
+            NewCase(c, "dispose-background", 40, 40, 16);
+            AddCorpusFrame(c, 0, 0, 40, 40, 2);
+            f = AddCorpusFrame(c, 10, 10, 15, 15, 0);
+            f->disposal = GIF_DISPOSE_BACKGROUND;
+            f = AddCorpusFrame(c, 20, 20, 15, 15, 0);
+            f->transparent = 2;
+            f->disposal = GIF_DISPOSE_BACKGROUND;
+            AddCorpusFrame(c, 0, 30, 40, 10, 1);
+            break;
+        case 11:
+            NewCase(c, "dispose-previous", 40, 40, 16);
+            f = AddCorpusFrame(c, 0, 0, 40, 40, 2);
+            f->disposal = GIF_DISPOSE_KEEP;
+            f = AddCorpusFrame(c, 5, 5, 20, 20, 0);
+            f->disposal = GIF_DISPOSE_PREVIOUS;
+            f = AddCorpusFrame(c, 15, 15, 20, 20, 0);      // 앞 프레임과 겹침, 연속 되돌리기
+            f->disposal = GIF_DISPOSE_PREVIOUS;
+            f->transparent = 5;
+            f = AddCorpusFrame(c, 0, 0, 10, 40, 1);
+            f->disposal = GIF_DISPOSE_BACKGROUND;
+            AddCorpusFrame(c, 2, 2, 4, 4, 0);
+            break;
+        case 12:
+            NewCase(c, "offscreen-rect", 32, 24, 16);
+            AddCorpusFrame(c, 0, 0, 32, 24, 2);
+            f = AddCorpusFrame(c, 25, 18, 20, 15, 0);
+            f->disposal = GIF_DISPOSE_PREVIOUS;
+            f = AddCorpusFrame(c, 40, 2, 5, 5, 0);         // 완전히 화면 밖
+            f->disposal = GIF_DISPOSE_BACKGROUND;
+            AddCorpusFrame(c, 20, 10, 30, 30, 1);
+            break;
+        case 13:
+            NewCase(c, "loop-count", 8, 8, 4);
+            c->loopCount = 3;
+            AddCorpusFrame(c, 0, 0, 8, 8, 0);
+            AddCorpusFrame(c, 0, 0, 8, 8, 2);
+            break;
+        default: {
+            NewCase(c, "truncated", 64, 64, 256);
+            AddCorpusFrame(c, 0, 0, 64, 64, 2);
+            AddCorpusFrame(c, 0, 0, 64, 64, 0);
+            c->truncate = 1;    // 두 번째 프레임 데이터 중간 (WriteCase에서 계산)
+            break;
+        }
+    }
+}
+
+static void FreeCase(CorpusCase* c) {
+    for (int i = 0; i < c->frameCount; i++) free(c->frames[i].pixels);
+}
+
+static int PaletteBits(int colors) {
+    int bits = 1;
+    while ((1 << bits) < colors) bits++;
+    return bits;
+}
+
+// 인터레이스 저장 순서 (8n, 8n+4, 4n+2, 2n+1)
+static void InterlaceRows(const CorpusFrame* f, unsigned char* out) {
+    static const int start[4] = { 0, 4, 2, 1 }, step[4] = { 8, 8, 4, 2 };
+    int row = 0;
+    for (int pass = 0; pass < 4; pass++) {
+        for (int y = start[pass]; y < f->height; y += step[pass]) {
+            memcpy(out + (size_t)row++ * f->width, f->pixels + (size_t)y * f->width, f->width);
+        }
+    }
+}
+
+static void PutPalette(ByteBuffer* b, const unsigned int* palette, int colors) {
+    int bits = PaletteBits(colors);
+    for (int i = 0; i < (1 << bits); i++) {
+        unsigned int v = i < colors ? palette[i] : 0;
+        PutByte(b, (v >> 16) & 0xFF);
+        PutByte(b, (v >> 8) & 0xFF);
+        PutByte(b, v & 0xFF);
+    }
+}
+
+static void WriteCase(const CorpusCase* c, ByteBuffer* out) {
+    Put(out, "GIF89a", 6);
+    PutLE16(out, c->width);
+    PutLE16(out, c->height);
+    if (c->globalColors) {
+        int bits = PaletteBits(c->globalColors);
+        PutByte(out, 0x80 | ((bits - 1) << 4) | (bits - 1));
+    } else {
+        PutByte(out, 0x70);
+    }
+    PutByte(out, 0);
+    PutByte(out, 0);
+    if (c->globalColors) PutPalette(out, c->globalPalette, c->globalColors);
+
+    if (c->loopCount >= 0) {
+        PutByte(out, 0x21);
+        PutByte(out, 0xFF);
+        PutByte(out, 11);
+        Put(out, "NETSCAPE2.0", 11);
+        PutByte(out, 3);
+        PutByte(out, 1);
+        PutLE16(out, c->loopCount);
+        PutByte(out, 0);
+    }
+
+    size_t lastFrameData = 0;
+    for (int i = 0; i < c->frameCount; i++) {
+        const CorpusFrame* f = &c->frames[i];
+        PutByte(out, 0x21);
+        PutByte(out, 0xF9);
+        PutByte(out, 4);
+        PutByte(out, (f->disposal << 2) | (f->transparent >= 0 ? 1 : 0));
+        PutLE16(out, f->delay);
+        PutByte(out, f->transparent >= 0 ? f->transparent : 0);
+        PutByte(out, 0);
+
+        PutByte(out, 0x2C);
+        PutLE16(out, f->x);
+        PutLE16(out, f->y);
+        PutLE16(out, f->width);
+        PutLE16(out, f->height);
+        int colors = f->localColors ? f->localColors : c->globalColors;
+        int packed = f->interlaced ? 0x40 : 0;
+        if (f->localColors) packed |= 0x80 | (PaletteBits(f->localColors) - 1);
+        PutByte(out, packed);
+        if (f->localColors) PutPalette(out, f->localPalette, f->localColors);
+
+        size_t count = (size_t)f->width * f->height;
+        unsigned char* stored = f->pixels;
+        if (f->interlaced) {
+            stored = (unsigned char*)malloc(count + 1);
+            InterlaceRows(f, stored);
+        }
+        int minCodeSize = PaletteBits(colors) < 2 ? 2 : PaletteBits(colors);
+        lastFrameData = out->size;
+        EncodeLzw(out, stored, count, minCodeSize, c->blockSize, c->clearMode);
+        if (stored != f->pixels) free(stored);
+    }
+    PutByte(out, 0x3B);
+
+    if (c->truncate) out->size = lastFrameData + (out->size - lastFrameData) / 2;
+}
+
+// 기준 합성: 표시 순서 픽셀에서 바로 (인터레이스 / LZW 없이)
+static void ReferenceFrame(const CorpusCase* c, int index, unsigned int* canvas, unsigned int* saved) {
+    int width = c->width, height = c->height;
+    size_t pixels = (size_t)width * height;
+
+    if (index == 0) {
+        memset(canvas, 0, sizeof(unsigned int) * pixels);
+    } else {
+        const CorpusFrame* p = &c->frames[index - 1];
+        if (p->disposal == GIF_DISPOSE_PREVIOUS) {
+            memcpy(canvas, saved, sizeof(unsigned int) * pixels);
+        } else if (p->disposal == GIF_DISPOSE_BACKGROUND) {
+            for (int y = p->y; y < p->y + p->height && y < height; y++) {
+                for (int x = p->x; x < p->x + p->width && x < width; x++) canvas[y * width + x] = 0;
+            }
+        }
+    }
+
+    const CorpusFrame* f = &c->frames[index];
+    if (f->disposal == GIF_DISPOSE_PREVIOUS) memcpy(saved, canvas, sizeof(unsigned int) * pixels);
+
+    const unsigned int* palette = f->localColors ? f->localPalette : c->globalPalette;
+    int colors = f->localColors ? f->localColors : c->globalColors;
+    for (int y = 0; y < f->height; y++) {
+        for (int x = 0; x < f->width; x++) {
+            int v = f->pixels[y * f->width + x];
+            if (v == f->transparent || f->x + x >= width || f->y + y >= height) continue;
+            canvas[(f->y + y) * width + f->x + x] = v < colors ? palette[v] : 0xFF000000u;
+        }
+    }
+}
+
+// 팔레트 커널: 무작위 인덱스 (잡음 / 16색 미만 / 같은 값 구간 / 투명 구간) x 길이 x 시작 위치를 스칼라와 비교
+static int CheckPaletteKernels(const DspKernels* k) {
+    const DspKernels* ref = DspKernels_GetScalar();
+    g_seed = 77;
+    static const int transparents[] = { -1, 0, 7, 255 };
+    static unsigned char indices[1100];
+    static unsigned int palette[256], expected[1100], actual[1100];
+    RandomPalette(palette, 256);
+
+    for (int pattern = 0; pattern < 4; pattern++) {
+        for (int t = 0; t < 4; t++) {
+            int transparent = transparents[t];
+            for (int i = 0; i < (int)sizeof(indices);) {
+                int run = pattern >= 2 ? 1 + (int)(Random() % 70) : 1;
+                int value = pattern == 1 ? (int)(Random() % 16) : (int)(Random() % 256);
+                if (pattern == 3 && transparent >= 0 && Random() % 3 != 0) value = transparent;
+                for (; run > 0 && i < (int)sizeof(indices); run--) indices[i++] = (unsigned char)value;
+            }
+
+            for (int count = 0; count <= 1024; count += count < 80 ? 1 : 61) {
+                for (int offset = 0; offset < 4; offset++) {
+                    for (int i = 0; i < count; i++) expected[i] = actual[i] = Random();
+                    const char* kind = "composite";
+                    if (transparent < 0 && offset == 0) {
+                        kind = "expand";
+                        ref->paletteExpand(indices + offset, palette, expected, count);
+                        k->paletteExpand(indices + offset, palette, actual, count);
+                    } else {
+                        ref->paletteComposite(indices + offset, palette, expected, count, transparent);
+                        k->paletteComposite(indices + offset, palette, actual, count, transparent);
+                    }
+                    if (memcmp(expected, actual, sizeof(unsigned int) * count) != 0) {
+                        printf("%-20s %s: %s pattern %d, transparent %d, count %d, offset %d differs\n",
+                               "palette kernels", k->name, kind, pattern, transparent, count, offset);
+                        return 0;
+                    }
+                }
+            }
+        }
+    }
+    return 1;
+}
+
+// 중간부터 디코딩: 프레임 k 직전 캔버스(ApplyDisposal 결과)를 쓰레기 캔버스에 넣고 Seek(k)한 뒤 끝까지 기준과 비교
+// 키프레임은 저장한 캔버스 없이 쓰레기 캔버스에서 바로 (앞 캔버스와 상관없어야 함)
+static void CheckSeek(const CorpusCase* c, GifDecoder* d, char* problem, size_t problemSize) {
+    size_t pixels = (size_t)c->width * c->height;
+    size_t stride = sizeof(unsigned int) * c->width;
+    unsigned int* before = (unsigned int*)malloc(sizeof(unsigned int) * pixels * c->frameCount);
+    unsigned int* expected = (unsigned int*)malloc(sizeof(unsigned int) * pixels * c->frameCount);
+    unsigned int* canvas = (unsigned int*)malloc(sizeof(unsigned int) * pixels);
+    unsigned int* saved = (unsigned int*)malloc(sizeof(unsigned int) * pixels);
+
+    GifDecoder_Rewind(d);
+    for (int n = 0; n < c->frameCount; n++) {
+        GifDecoder_ApplyDisposal(d, canvas, stride);
+        memcpy(before + pixels * n, canvas, sizeof(unsigned int) * pixels);
+        GifDecoder_NextFrame(d, canvas, stride, NULL);
+        ReferenceFrame(c, n, expected + pixels * n, saved);
+        if (n + 1 < c->frameCount) memcpy(expected + pixels * (n + 1), expected + pixels * n, sizeof(unsigned int) * pixels);
+    }
+
+    for (int from = 0; from < 2 * c->frameCount && !problem[0]; from++) {
+        int k = from / 2;
+        int keyFrame = from % 2;
+        if (keyFrame && !GifDecoder_IsKeyFrame(d, k)) continue;
+        for (size_t p = 0; p < pixels; p++) canvas[p] = 0xDEADBEEFu;
+        if (!keyFrame) memcpy(canvas, before + pixels * k, sizeof(unsigned int) * pixels);
+        GifDecoder_Seek(d, k);
+        for (int n = k; n < c->frameCount && !problem[0]; n++) {
+            GifFrame frame;
+            if (!GifDecoder_NextFrame(d, canvas, stride, &frame)) {
+                snprintf(problem, problemSize, "seek %d: frame %d missing", k, n);
+            } else if (frame.complete && memcmp(canvas, expected + pixels * n, sizeof(unsigned int) * pixels) != 0) {
+                snprintf(problem, problemSize, "%s %d: frame %d differs", keyFrame ? "key frame" : "checkpoint", k, n);
+            }
+        }
+    }
+
+    free(before);
+    free(expected);
+    free(canvas);
+    free(saved);
+}
+
+static void* CacheBlock(size_t bytes) {
+    void* data = malloc(bytes);
+    memset(data, 0, bytes);
+    return data;
+}
+
+// 넣고 바로 놓기 (반환값 = 들어갔는지)
+static int CachePut(FrameCache* c, int owner, int kind, int index, size_t bytes) {
+    void* data = CacheBlock(bytes);
+    FrameCacheEntry* e = FrameCache_Insert(c, owner, kind, index, data, bytes);
+    if (!e) {
+        free(data);
+        return 0;
+    }
+    FrameCache_Release(c, e);
+    return 1;
+}
+
+// 프레임 캐시: LRU 순서, 숨긴 소유자 먼저, 고정된 항목은 안 버림, 예산 줄이기, 해시 늘리기
+static int CheckFrameCache(void) {
+    FrameCache c;
+    const char* problem = NULL;
+    FrameCache_Init(&c, 1000);
+
+    for (int i = 0; i < 4; i++) CachePut(&c, 0, 0, i, 200);
+    FrameCacheEntry* e = FrameCache_Acquire(&c, 0, 0, 0);   // 0이 가장 최근 -> 1이 가장 오래됨
+    FrameCache_Release(&c, e);
+    if (!e || FrameCache_Acquire(&c, 0, 0, 9) || c.stats.hits[0] != 1 || c.stats.misses[0] != 1) {
+        problem = "hit / miss";
+    }
+    CachePut(&c, 0, 0, 4, 200);     // 1000: 딱 맞음
+    CachePut(&c, 0, 0, 5, 200);     // 1 버림
+    if (!problem && (FrameCache_Contains(&c, 0, 0, 1) || !FrameCache_Contains(&c, 0, 0, 0) ||
+                     c.used != 1000 || c.stats.evictions[0] != 1 || c.owners[0].evictions != 1)) {
+        problem = "LRU eviction";
+    }
+
+    // 숨긴 소유자 항목은 가장 최근 것이라도 먼저
+    FrameCache_SetBudget(&c, 1100);
+    CachePut(&c, 1, 0, 0, 100);
+    FrameCache_SetHidden(&c, 1, 1);
+    CachePut(&c, 0, 0, 6, 100);
+    if (!problem && (FrameCache_Contains(&c, 1, 0, 0) || !FrameCache_Contains(&c, 0, 0, 2) ||
+                     c.stats.hiddenEvictions != 1 || c.owners[1].count[0] != 0)) {
+        problem = "hidden owner first";
+    }
+
+    // 고정된 항목은 예산을 줄여도, 지워도 놓을 때까지 유지
+    e = FrameCache_Acquire(&c, 0, 0, 3);
+    FrameCache_SetBudget(&c, 0);
+    if (!problem && (c.entryCount != 1 || c.used != 200 || !FrameCache_Contains(&c, 0, 0, 3))) {
+        problem = "pinned entry evicted";
+    }
+    FrameCache_Remove(&c, 0, -1);
+    if (!problem && (c.entryCount != 0 || c.used != 200 || FrameCache_Contains(&c, 0, 0, 3))) {
+        problem = "remove while pinned";
+    }
+    FrameCache_Release(&c, e);
+    if (!problem && c.used != 0) problem = "release after remove";
+
+    // 예산보다 큰 항목은 거절, 많이 넣으면 해시가 늘어나도 모두 찾음
+    FrameCache_SetBudget(&c, 100000);
+    if (!problem && CachePut(&c, 0, 1, 0, 100001)) problem = "oversized insert";
+    for (int i = 0; i < 500; i++) CachePut(&c, i % 3, 1 + i % 2, i, 100);
+    for (int i = 0; i < 500 && !problem; i++) {
+        if (!FrameCache_Contains(&c, i % 3, 1 + i % 2, i) || FrameCache_Contains(&c, i % 3, 2 - i % 2, i)) {
+            problem = "hash lookup";
+        }
+    }
+    if (!problem && (c.entryCount != 500 || c.bucketCount < 500)) problem = "hash growth";
+
+    FrameCache_Free(&c);
+    printf("%-20s %s%s\n", "frame cache", problem ? "FAIL: " : "ok", problem ? problem : "");
+    return problem == NULL;
+}
+
+static int CheckCorpus(void) {
+    int failures = 0;
+    const DspKernels* kernels[MAX_KERNELS];
+    int kernelCount = DspKernels_List(kernels, MAX_KERNELS);
+
+    for (int k = 1; k < kernelCount; k++) {
+        int ok = CheckPaletteKernels(kernels[k]);
+        if (!ok) failures++;
+        printf("%-20s %-6s %s\n", "palette kernels", kernels[k]->name, ok ? "ok" : "FAIL");
+    }
+
+    printf("case                 bytes  frames  loop  result\n");
+
+    for (int i = 0; i < CORPUS_CASES; i++) {
+        CorpusCase c;
+        BuildCase(i, &c);
+        ByteBuffer file = { NULL, 0, 0 };
+        WriteCase(&c, &file);
+
+        size_t pixels = (size_t)c.width * c.height;
+        unsigned int* canvas = (unsigned int*)malloc(sizeof(unsigned int) * pixels);
+        unsigned int* expected = (unsigned int*)malloc(sizeof(unsigned int) * pixels);
+        unsigned int* saved = (unsigned int*)malloc(sizeof(unsigned int) * pixels);
+
+        char problem[160] = "";
+        GifDecoder d;
+        if (!GifDecoder_Open(&d, file.data, file.size)) {
+            snprintf(problem, sizeof(problem), "open failed");
+        } else if (d.width != c.width || d.height != c.height || d.frameCount != c.frameCount) {
+            snprintf(problem, sizeof(problem), "header %dx%d, %d frames", d.width, d.height, d.frameCount);
+        } else if (d.loopCount != c.loopCount) {
+            snprintf(problem, sizeof(problem), "loop count %d", d.loopCount);
+        }
+
+        // 커널마다 두 바퀴 (Rewind 뒤에도 같아야 함)
+        for (int pass = 0; pass < 2 * kernelCount && !problem[0]; pass++) {
+            DspKernels_Select(kernels[pass / 2]->name);
+            GifDecoder_Rewind(&d);
+            for (int n = 0; n < c.frameCount && !problem[0]; n++) {
+                GifFrame frame;
+                if (!GifDecoder_NextFrame(&d, canvas, sizeof(unsigned int) * c.width, &frame)) {
+                    snprintf(problem, sizeof(problem), "frame %d missing", n);
+                    break;
+                }
+                ReferenceFrame(&c, n, expected, saved);
+
+                int truncated = c.truncate && n == c.frameCount - 1;
+                if (frame.complete == truncated || frame.delay != c.frames[n].delay) {
+                    snprintf(problem, sizeof(problem), "frame %d complete %d, delay %d", n, frame.complete,
+                             frame.delay);
+                } else if (!truncated) {
+                    for (size_t p = 0; p < pixels; p++) {
+                        if (canvas[p] != expected[p]) {
+                            snprintf(problem, sizeof(problem), "frame %d pixel (%d,%d) %08x, expected %08x", n,
+                                     (int)(p % c.width), (int)(p / c.width), canvas[p], expected[p]);
+                            break;
+                        }
+                    }
+                }
+            }
+            GifFrame extra;
+            if (!problem[0] && GifDecoder_NextFrame(&d, canvas, sizeof(unsigned int) * c.width, &extra)) {
+                snprintf(problem, sizeof(problem), "frame after the last");
+            }
+        }
+
+        if (!problem[0]) {
+            DspKernels_Select(NULL);
+            CheckSeek(&c, &d, problem, sizeof(problem));
+        }
+
+        if (problem[0]) failures++;
+        printf("%-20s %6zu  %6d  %4d  %s%s", c.name, file.size, c.frameCount, c.loopCount,
+               problem[0] ? "FAIL: " : "ok", problem);
+        if (problem[0]) printf(" (%s kernel)", DspKernels_Get()->name);
+        printf("\n");
+        DspKernels_Select(NULL);
+
+        GifDecoder_Close(&d);
+        free(canvas);
+        free(expected);
+        free(saved);
+        free(file.data);
+        FreeCase(&c);
+    }
+
+    // 깨진 입력은 열기에서 거절
+    static const unsigned char broken[][16] = {
+        { 'G', 'I', 'F', '8', '9', 'a', 0, 0, 1, 0, 0, 0, 0, 0x3B },    // 너비 0
+        { 'G', 'I', 'F', '8', '9', 'a', 1, 0, 1, 0, 0, 0, 0, 0x3B },    // 프레임 없음
+        { 'P', 'N', 'G', '8', '9', 'a', 1, 0, 1, 0, 0, 0, 0, 0x3B },
+    };
+    for (int i = 0; i < (int)(sizeof(broken) / sizeof(broken[0])); i++) {
+        GifDecoder d;
+        int opened = GifDecoder_Open(&d, broken[i], 14);
+        GifDecoder_Close(&d);
+        if (opened) failures++;
+        printf("%-20s %6d  %6s  %4s  %s\n", i == 0 ? "zero-width" : i == 1 ? "no-frames" : "bad-signature",
+               14, "-", "-", opened ? "FAIL: opened" : "ok");
+    }
+
+    if (!CheckFrameCache()) failures++;
+
+    printf("%s\n", failures ? "gif check FAILED" : "gif check passed");
+    return failures ? 1 : 0;
+}
+
+static int WriteCorpus(const char* dir) {
+    for (int i = 0; i < CORPUS_CASES; i++) {
+        CorpusCase c;
+        BuildCase(i, &c);
+        ByteBuffer file = { NULL, 0, 0 };
+        WriteCase(&c, &file);
+
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%02d-%s.gif", dir, i, c.name);
+        FILE* f = fopen(path, "wb");
+        if (!f || fwrite(file.data, 1, file.size, f) != file.size) {
+            fprintf(stderr, "error: cannot write %s\n", path);
+            if (f) fclose(f);
+            return 1;
+        }
+        fclose(f);
+        printf("%s\n", path);
+        free(file.data);
+        FreeCase(&c);
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// 정보 / 벤치마크
+// ---------------------------------------------------------------------------
+
+static int ShowInfo(const char* path) {
+    size_t size = 0;
+    unsigned char* data = LoadFile(path, &size);
+    if (!data) return 1;
+
+    GifDecoder d;
+    if (!GifDecoder_Open(&d, data, size)) {
+        fprintf(stderr, "error: %s is not a readable GIF\n", path);
+        free(data);
+        return 1;
+    }
+
+    static const char* disposals[] = { "none", "keep", "background", "previous" };
+    printf("%s: %dx%d, %d frames, loop %d, %s palette, %zu bytes\n", path, d.width, d.height, d.frameCount,
+           d.loopCount, d.hasGlobalPalette ? "global" : "no global", size);
+    printf("frame  x     y     width height delay  disposal    transparent interlaced\n");
+    for (int i = 0; i < d.frameCount; i++) {
+        const GifFrameInfo* f = &d.frames[i];
+        printf("%5d  %-5d %-5d %-5d %-6d %-6d %-11s %-11d %d\n", i, f->x, f->y, f->width, f->height, f->delay,
+               disposals[f->disposal], f->transparent, f->interlaced);
+    }
+
+    GifDecoder_Close(&d);
+    free(data);
+    return 0;
+}
+
+static int Bench(int count, char** paths) {
+    int failures = 0;
+    printf("file                            size KB  frames  canvas      open us   MB/s  frames/s  Mpix/s\n");
+
+    for (int i = 0; i < count; i++) {
+        size_t size = 0;
+        unsigned char* data = LoadFile(paths[i], &size);
+        if (!data) {
+            failures++;
+            continue;
+        }
+
+        GifDecoder d;
+        double start = NowSec();
+        int opened = GifDecoder_Open(&d, data, size);
+        double openSec = NowSec() - start;
+        unsigned int* canvas = opened ? (unsigned int*)malloc(sizeof(unsigned int) * d.width * d.height) : NULL;
+        if (!canvas) {
+            fprintf(stderr, "error: cannot decode %s\n", paths[i]);
+            GifDecoder_Close(&d);
+            free(data);
+            failures++;
+            continue;
+        }
+
+        // 전체 프레임 한 바퀴를 BENCH_MIN_SECONDS 이상 반복
+        int passes = 0, incomplete = 0;
+        start = NowSec();
+        double elapsed = 0.0;
+        do {
+            GifDecoder_Rewind(&d);
+            GifFrame frame;
+            while (GifDecoder_NextFrame(&d, canvas, sizeof(unsigned int) * d.width, &frame)) {
+                if (!frame.complete && passes == 0) incomplete++;
+            }
+            passes++;
+            elapsed = NowSec() - start;
+        } while (elapsed < BENCH_MIN_SECONDS);
+
+        const char* name = strrchr(paths[i], '/');
+        name = name ? name + 1 : paths[i];
+        double frames = (double)passes * d.frameCount;
+        printf("%-30.30s %8.1f  %6d  %5dx%-5d %7.0f %6.1f %9.1f %7.1f%s\n", name, size / 1024.0, d.frameCount,
+               d.width, d.height, openSec * 1e6, size * (double)passes / elapsed / 1e6, frames / elapsed,
+               frames * d.width * d.height / elapsed / 1e6, incomplete ? "  (incomplete frames)" : "");
+
+        free(canvas);
+        GifDecoder_Close(&d);
+        free(data);
+    }
+    return failures ? 1 : 0;
+}
+
+// 실제 파일 프레임의 인덱스 행 (팔레트 커널 벤치마크용)
+typedef struct {
+    unsigned char* indices;     // [rows * columns]
+    unsigned int palette[256];
+    int transparent;
+    int x, y;                   // 캔버스 안 위치 (잘라낸 뒤)
+    int columns, rows;
+} KernelFrame;
+
+// fn을 KERNEL_BENCH_SECONDS 이상 반복, 반환값 = 한 번 평균 초
+template <typename Fn>
+static double TimeLoop(Fn fn) {
+    fn();   // 캐시 / 분기 예측 데우기
+    int runs = 0;
+    double start = NowSec(), elapsed = 0.0;
+    do {
+        fn();
+        runs++;
+        elapsed = NowSec() - start;
+    } while (elapsed < KERNEL_BENCH_SECONDS);
+    return elapsed / runs;
+}
+
+static int BenchKernels(int count, char** paths) {
+    int failures = 0;
+    const DspKernels* kernels[MAX_KERNELS];
+    int kernelCount = DspKernels_List(kernels, MAX_KERNELS);
+
+    for (int f = 0; f < count; f++) {
+        size_t size = 0;
+        unsigned char* data = LoadFile(paths[f], &size);
+        GifDecoder d;
+        if (!data || !GifDecoder_Open(&d, data, size)) {
+            if (data) fprintf(stderr, "error: %s is not a readable GIF\n", paths[f]);
+            free(data);
+            failures++;
+            continue;
+        }
+
+        // 스칼라로 한 바퀴 디코딩하면서 프레임마다 인덱스 / 팔레트 복사 (행 순서는 저장 순서 그대로)
+        size_t canvasPixels = (size_t)d.width * d.height;
+        unsigned int* canvas = (unsigned int*)malloc(sizeof(unsigned int) * canvasPixels);
+        unsigned int* expected = (unsigned int*)malloc(sizeof(unsigned int) * canvasPixels);
+        KernelFrame* frames = (KernelFrame*)calloc(d.frameCount, sizeof(KernelFrame));
+        int frameCount = 0;
+        double pixels = 0.0, transparentPixels = 0.0;
+        DspKernels_Select("scalar");
+        GifFrame frame;
+        while (canvas && expected && frames && GifDecoder_NextFrame(&d, canvas, sizeof(unsigned int) * d.width, &frame)) {
+            const GifFrameInfo* info = &d.frames[frame.index];
+            if (!frame.complete || frame.width <= 0 || frame.height <= 0) continue;
+            KernelFrame* k = &frames[frameCount];
+            k->columns = frame.width;
+            k->rows = frame.height;
+            k->x = frame.x;
+            k->y = frame.y;
+            k->transparent = info->transparent;
+            memcpy(k->palette, d.palette, sizeof(k->palette));
+            k->indices = (unsigned char*)malloc((size_t)k->columns * k->rows);
+            if (!k->indices) break;
+            for (int row = 0; row < k->rows; row++) {
+                const unsigned char* src = d.indices + (size_t)row * info->width;
+                memcpy(k->indices + (size_t)row * k->columns, src, k->columns);
+                for (int i = 0; i < k->columns; i++) transparentPixels += src[i] == info->transparent;
+            }
+            pixels += (double)k->columns * k->rows;
+            frameCount++;
+        }
+        DspKernels_Select(NULL);
+
+        // 모든 프레임을 캔버스에 차례로 합성 (expand = 투명 무시하고 덮어쓰기)
+        auto run = [&](const DspKernels* k, int composite) {
+            for (int n = 0; n < frameCount; n++) {
+                const KernelFrame* kf = &frames[n];
+                for (int row = 0; row < kf->rows; row++) {
+                    const unsigned char* src = kf->indices + (size_t)row * kf->columns;
+                    unsigned int* dst = canvas + (size_t)(kf->y + row) * d.width + kf->x;
+                    if (composite) {
+                        k->paletteComposite(src, kf->palette, dst, kf->columns, kf->transparent);
+                    } else {
+                        k->paletteExpand(src, kf->palette, dst, kf->columns);
+                    }
+                }
+            }
+        };
+
+        const char* name = strrchr(paths[f], '/');
+        name = name ? name + 1 : paths[f];
+        printf("%s: %dx%d, %d frames, %.1f Mpixel of indices per pass, %.0f%% transparent\n", name, d.width,
+               d.height, frameCount, pixels / 1e6, pixels > 0.0 ? 100.0 * transparentPixels / pixels : 0.0);
+        printf("kernel   expand ns/px  composite ns/px  speedup  decode frames/s  speedup  result\n");
+
+        double scalarComposite = 0.0, scalarDecode = 0.0;
+        for (int k = 0; k < kernelCount && frameCount > 0; k++) {
+            // 결과 확인: 같은 시작 캔버스에서 합성 한 바퀴 -> 스칼라 결과와 같아야 함
+            const char* result = "ok";
+            for (size_t i = 0; i < canvasPixels; i++) canvas[i] = (unsigned int)(i * 2654435761u);
+            run(kernels[k], 1);
+            if (k == 0) {
+                memcpy(expected, canvas, sizeof(unsigned int) * canvasPixels);
+            } else if (memcmp(expected, canvas, sizeof(unsigned int) * canvasPixels) != 0) {
+                result = "FAIL: differs from scalar";
+                failures++;
+            }
+
+            double expandSec = TimeLoop([&] { run(kernels[k], 0); });
+            double compositeSec = TimeLoop([&] { run(kernels[k], 1); });
+
+            // 디코딩 전체 (LZW 포함) 한 바퀴
+            DspKernels_Select(kernels[k]->name);
+            double decodeSec = TimeLoop([&] {
+                GifDecoder_Rewind(&d);
+                GifFrame decoded;
+                while (GifDecoder_NextFrame(&d, canvas, sizeof(unsigned int) * d.width, &decoded)) {}
+            });
+            DspKernels_Select(NULL);
+
+            if (k == 0) {
+                scalarComposite = compositeSec;
+                scalarDecode = decodeSec;
+            }
+            printf("%-8s %12.3f  %15.3f  %6.2fx  %15.1f  %6.2fx  %s\n", kernels[k]->name, expandSec * 1e9 / pixels,
+                   compositeSec * 1e9 / pixels, scalarComposite / compositeSec, d.frameCount / decodeSec,
+                   scalarDecode / decodeSec, result);
+        }
+        if (f + 1 < count) printf("\n");
+
+        for (int n = 0; n < frameCount; n++) free(frames[n].indices);
+        free(frames);
+        free(expected);
+        free(canvas);
+        GifDecoder_Close(&d);
+        free(data);
+    }
+    return failures ? 1 : 0;
+}
+
+// ---------------------------------------------------------------------------
+// 실행
+// ---------------------------------------------------------------------------
+
+static void Usage(void) {
+    fprintf(stderr,
+        "usage: gif_harness FILE.gif           frame table (rect, delay, disposal, transparency)\n"
+        "       gif_harness --check            decode the generated corpus and compare every frame\n"
+        "                                      against a reference compositor\n"
+        "       gif_harness --write-corpus DIR write the generated corpus as .gif files\n"
+        "       gif_harness --bench FILE...    decode throughput (input MB/s, frames/s, output Mpixel/s)\n"
+        "       gif_harness --bench-kernels FILE...\n"
+        "                                      palette expand / composite ns per pixel for every SIMD kernel\n"
+        "                                      on the file's own frames, plus decode frames/s per kernel\n");
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        Usage();
+        return 2;
+    }
+    if (strcmp(argv[1], "--check") == 0) return CheckCorpus();
+    if (strcmp(argv[1], "--write-corpus") == 0 && argc == 3) return WriteCorpus(argv[2]);
+    if (strcmp(argv[1], "--bench") == 0 && argc > 2) return Bench(argc - 2, argv + 2);
+    if (strcmp(argv[1], "--bench-kernels") == 0 && argc > 2) return BenchKernels(argc - 2, argv + 2);
+    if (argv[1][0] != '-' && argc == 2) return ShowInfo(argv[1]);
+    Usage();
+    return 2;
+}
@@ -1,30 +1,67 @@
 /*
- * gif_player.cpp - GIF Animation Player using GDI+
+ * gif_player.cpp - GIF Animation Player (GifDecoder로 디코딩, GDI+로 확대/축소)
  * Each GIF is displayed in its own transparent, draggable window
  */
 
 #include "gif_player.h"
+#include "gif_decoder.h"
+#include "frame_cache.h"
 
 #include <windows.h>
 #include <gdiplus.h>
 #include <stdio.h>
+#include <math.h>
 #include <new>  // std::nothrow
 
 #pragma comment(lib, "gdiplus.lib")
 
 using namespace Gdiplus;
 
+#define GIF_CACHE_MAX_SIZE 800  // 미리 디코딩할 프레임의 긴 변 상한 (표시 크기 상한과 같음, 더 크면 줄여서 보관)
+#define GIF_SCALE_SETTLE_MS 150 // 창 크기 캐시: 마지막 크기 변경 후 이만큼 조용하면 다시 만들기 시작 (드래그 중 반복 방지)
+#define WM_GIF_SCALED (WM_APP + 1)  // 배경 스레드 -> GIF 창: 창 크기 프레임 완성
+#define GIF_CACHE_DEFAULT_MB 256    // 프레임 캐시 예산 기본값 (모든 GIF 합계)
+#define GIF_CHECKPOINT_INTERVAL 8   // 프레임을 잃은 GIF: 이 간격마다 원본 크기 캔버스 보관 (다시 디코딩 시작점)
+
+// 프레임 캐시 종류 (소유자 = GIF 인덱스, 번호 = 프레임)
+#define GIF_CACHE_FRAME 0       // 캐시 크기 프레임 (cacheWidth x cacheHeight)
+#define GIF_CACHE_SCALED 1      // 창 크기 프레임 (scaleTargetWidth x scaleTargetHeight)
+#define GIF_CACHE_CHECKPOINT 2  // 원본 크기 캔버스: 그 프레임을 그리기 직전 상태
+
+#if MAX_GIFS > FRAME_CACHE_MAX_OWNERS
+#error "MAX_GIFS must not exceed FRAME_CACHE_MAX_OWNERS"
+#endif
+
 // GIF 창 정보 구조체
 typedef struct {
-    Image* pImage;
+    GifDecoder* decoder;    // 캐시에 없는 프레임을 다시 디코딩 (GIF를 닫을 때까지 유지)
+    BYTE* fileData;         // decoder가 읽는 파일 내용 (파일은 읽자마자 닫음)
+    unsigned int* canvas;   // 원본 크기 합성 버퍼 (decoder가 마지막으로 낸 프레임, 모든 프레임이 캐시에 있으면 NULL)
+    int srcWidth;           // 원본 크기 (비율 계산용)
+    int srcHeight;
+    int cacheWidth;         // 캐시 프레임 크기 (긴 변 GIF_CACHE_MAX_SIZE 이하)
+    int cacheHeight;
+    size_t frameBytes;      // 캐시 프레임 하나 크기
+    HDC hdcSurface;         // 창 크기 DIB (UpdateLayeredWindow 원본, 크기가 바뀔 때만 다시 만듦)
+    HBITMAP hSurface;
+    HBITMAP hOldSurface;
+    void* surfaceBits;
+    int surfaceWidth;
+    int surfaceHeight;
+    // 아래는 g_cacheLock으로 보호 (배경 스레드와 공유)
+    int scaleTargetWidth;   // 창 크기 프레임 크기 (0 = 요청 없음)
+    int scaleTargetHeight;
+    LONG scaleGeneration;   // 요청이 바뀔 때마다 +1
+    LONG scaleDone;         // 배경 스레드가 마지막으로 처리한 요청
     UINT frameCount;
     UINT currentFrame;
-    GUID dimensionID;
     int width;
     int height;
     HWND hwnd;
     bool isPlaying;
     UINT* frameDelays;      // 각 프레임별 딜레이 (ms)
+    UINT* frameStarts;      // [frameCount + 1] 프레임 시작 시각 누적 (ms), 마지막 = 루프 길이
+    int beatsPerLoop;       // 박자 모드 자동 루프 길이 (박자)
     DWORD lastFrameTime;    // 마지막 프레임 전환 시간
     float speedMultiplier;  // 속도 배율 (1.0 = 원본)
 } GifWindow;
@@ -39,6 +76,14 @@ static wchar_t g_assetsPath[MAX_PATH];
 static HINSTANCE g_hInstance = NULL;
 static bool g_isPlaying = false;
 static float g_globalSpeedMultiplier = 1.0f;  // 전역 속도 배율
+static int g_playbackMode = GIF_PLAYBACK_CLOCK;  // 재생 방식
+static int g_beatsPerLoop = 0;          // 루프당 박자 수 (0 = 자동)
+static float g_fixedTempo = 0.0f;       // 고정 템포 (0 = 감지된 템포)
+static double g_beatPosition = 0.0;     // 감지된 박자 위치 (박자 단위)
+static bool g_beatValid = false;
+static double g_trackPosition = 0.0;    // 곡 재생 위치 (초)
+static bool g_trackValid = false;
+static LARGE_INTEGER g_tempoOrigin;     // 고정 템포 기준 시각
 static bool g_clickThroughMode = false;  // 클릭 투과 모드
 
 const wchar_t GIF_CLASS_NAME[] = L"GifWindowClass";
@@ -50,6 +95,16 @@ static HANDLE g_watchThread = NULL;
 static HANDLE g_watchStopEvent = NULL;
 static bool g_watchRunning = false;
 
+// 창 크기 프레임 캐시 배경 스레드 (처음 필요할 때 시작)
+static HANDLE g_scaleThread = NULL;
+static HANDLE g_scaleEvent = NULL;
+static volatile bool g_scaleRunning = false;
+
+// 모든 GIF가 함께 쓰는 프레임 캐시 (예산을 넘으면 가장 오래 안 쓴 프레임부터, 숨긴 GIF 먼저 버림)
+static FrameCache g_cache;
+static CRITICAL_SECTION g_cacheLock;    // g_cache와 GifWindow의 scale* 보호
+static int g_cacheBudgetMB = GIF_CACHE_DEFAULT_MB;
+
 // 이미 로드된 GIF 파일 목록 (중복 방지)
 static wchar_t g_loadedFiles[MAX_GIFS][MAX_PATH];
 static int g_loadedFileCount = 0;
@@ -108,14 +163,14 @@ static LRESULT CALLBACK GifWindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARA
         case WM_SIZING: {
             // 원본 비율 유지하면서 리사이즈
             int index = GetGifIndexFromHwnd(hwnd);
-            if (index >= 0 && g_gifs[index].pImage) {
+            if (index >= 0 && g_gifs[index].srcWidth > 0) {
                 RECT* pRect = (RECT*)lParam;
                 int width = pRect->right - pRect->left;
                 int height = pRect->bottom - pRect->top;
                 
                 // 원본 비율
-                int origWidth = g_gifs[index].pImage->GetWidth();
-                int origHeight = g_gifs[index].pImage->GetHeight();
+                int origWidth = g_gifs[index].srcWidth;
+                int origHeight = g_gifs[index].srcHeight;
                 float ratio = (float)origHeight / origWidth;
                 
                 int newWidth, newHeight;
@@ -178,8 +233,11 @@ static LRESULT CALLBACK GifWindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARA
                 int newHeight = rc.bottom - rc.top;
                 
                 if (newWidth > 10 && newHeight > 10) {
-                    g_gifs[index].width = newWidth;
-                    g_gifs[index].height = newHeight;
+                    GifWindow* gif = &g_gifs[index];
+                    gif->width = newWidth;
+                    gif->height = newHeight;
+                    
+                    // 예전 크기 캐시는 UpdateGifWindow가 새 크기를 요청하면서 버림 (완성 전까지는 빠른 확대/축소)
                     UpdateGifWindow(index);
                 }
             }
@@ -190,13 +248,13 @@ static LRESULT CALLBACK GifWindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARA
             // Shift + 마우스 휠로 크기 조절
             if (GetKeyState(VK_SHIFT) & 0x8000) {
                 int index = GetGifIndexFromHwnd(hwnd);
-                if (index >= 0 && g_gifs[index].pImage) {
+                if (index >= 0 && g_gifs[index].srcWidth > 0) {
                     int delta = GET_WHEEL_DELTA_WPARAM(wParam);
                     int step = 10;  // 한 번에 변경되는 크기
                     
                     // 원본 이미지 크기
-                    int origWidth = g_gifs[index].pImage->GetWidth();
-                    int origHeight = g_gifs[index].pImage->GetHeight();
+                    int origWidth = g_gifs[index].srcWidth;
+                    int origHeight = g_gifs[index].srcHeight;
                     float ratio = (float)origHeight / origWidth;
                     
                     // 현재 너비 기준으로 크기 조절
@@ -266,6 +324,24 @@ static LRESULT CALLBACK GifWindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARA
             }
             return 0;
             
+        case WM_GIF_SCALED: {
+            // 창 크기 프레임이 캐시에 들어옴: 지금 프레임을 고품질로 다시 그림
+            int index = GetGifIndexFromHwnd(hwnd);
+            if (index >= 0) UpdateGifWindow(index);
+            return 0;
+        }
+        
+        case WM_SHOWWINDOW: {
+            // 숨긴 GIF의 프레임은 예산을 넘을 때 먼저 버림 (다시 보이면 모자란 프레임만 다시 디코딩)
+            int index = GetGifIndexFromHwnd(hwnd);
+            if (index >= 0 && g_initialized) {
+                EnterCriticalSection(&g_cacheLock);
+                FrameCache_SetHidden(&g_cache, index, wParam == FALSE);
+                LeaveCriticalSection(&g_cacheLock);
+            }
+            break;
+        }
+        
         case WM_DESTROY:
             return 0;
     }
@@ -273,15 +349,27 @@ static LRESULT CALLBACK GifWindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARA
     return DefWindowProc(hwnd, uMsg, wParam, lParam);
 }
 
-// 레이어드 윈도우 업데이트 (투명 배경 GIF)
-static void UpdateGifWindow(int index) {
-    GifWindow* gif = &g_gifs[index];
-    if (!gif->hwnd || !gif->pImage) return;
-    
-    HDC hdcScreen = GetDC(NULL);
-    HDC hdcMem = CreateCompatibleDC(hdcScreen);
+static void FreeSurface(GifWindow* gif) {
+    if (gif->hdcSurface) {
+        if (gif->hOldSurface) SelectObject(gif->hdcSurface, gif->hOldSurface);
+        DeleteDC(gif->hdcSurface);
+    }
+    if (gif->hSurface) DeleteObject(gif->hSurface);
+    gif->hdcSurface = NULL;
+    gif->hSurface = NULL;
+    gif->hOldSurface = NULL;
+    gif->surfaceBits = NULL;
+    gif->surfaceWidth = 0;
+    gif->surfaceHeight = 0;
+}
+
+// 창 크기 32비트 DIB 준비 (크기가 같으면 그대로 재사용)
+static bool EnsureSurface(GifWindow* gif) {
+    if (gif->hSurface && gif->surfaceWidth == gif->width && gif->surfaceHeight == gif->height) {
+        return true;
+    }
+    FreeSurface(gif);
     
-    // 32비트 비트맵 생성 (알파 채널 포함)
     BITMAPINFO bmi = {0};
     bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
     bmi.bmiHeader.biWidth = gif->width;
@@ -290,26 +378,354 @@ static void UpdateGifWindow(int index) {
     bmi.bmiHeader.biBitCount = 32;
     bmi.bmiHeader.biCompression = BI_RGB;
     
-    void* pBits = NULL;
-    HBITMAP hBitmap = CreateDIBSection(hdcScreen, &bmi, DIB_RGB_COLORS, &pBits, NULL, 0);
-    HBITMAP hOldBitmap = (HBITMAP)SelectObject(hdcMem, hBitmap);
+    HDC hdcScreen = GetDC(NULL);
+    gif->hdcSurface = CreateCompatibleDC(hdcScreen);
+    gif->hSurface = CreateDIBSection(hdcScreen, &bmi, DIB_RGB_COLORS, &gif->surfaceBits, NULL, 0);
+    ReleaseDC(NULL, hdcScreen);
+    if (!gif->hdcSurface || !gif->hSurface) {
+        FreeSurface(gif);
+        return false;
+    }
+    gif->hOldSurface = (HBITMAP)SelectObject(gif->hdcSurface, gif->hSurface);
+    gif->surfaceWidth = gif->width;
+    gif->surfaceHeight = gif->height;
+    return true;
+}
+
+// 프리멀티플라이 BGRA 한 장을 원하는 크기로 (캔버스 -> 캐시, 원본 캐시 -> 창 크기 캐시, 완성 전 임시 표시)
+static Status ScaleFrame(BYTE* frame, int frameWidth, int frameHeight, BYTE* dst, int width, int height,
+                         InterpolationMode mode) {
+    Bitmap cached(frameWidth, frameHeight, frameWidth * 4, PixelFormat32bppPARGB, frame);
+    Bitmap target(width, height, width * 4, PixelFormat32bppPARGB, dst);
+    Graphics graphics(&target);
+    graphics.SetInterpolationMode(mode);
+    graphics.SetPixelOffsetMode(PixelOffsetModeHalf);
+    graphics.SetCompositingMode(CompositingModeSourceCopy);  // 덮어쓰기 (Clear 불필요)
+    return graphics.DrawImage(&cached, 0, 0, width, height);
+}
+
+// 배경 스레드: 요청이 바뀌었는지 (처리 중인 요청을 버릴지)
+static bool ScaleRequestChanged(GifWindow* gif, LONG generation) {
+    EnterCriticalSection(&g_cacheLock);
+    bool changed = gif->scaleGeneration != generation;
+    LeaveCriticalSection(&g_cacheLock);
+    return changed || !g_scaleRunning;
+}
+
+// 보이는 GIF의 프레임을 버리지 않고 bytes가 캐시에 들어가는지 (숨긴 GIF 프레임은 버려도 됨), g_cacheLock 안에서 호출
+// 미리 채우기(로드, 창 크기 캐시)는 이 안에서만 넣고, 화면에 필요한 프레임만 예산을 넘길 때 버림
+static bool FitsBudget(size_t bytes) {
+    size_t hidden = 0;
+    for (int owner = 0; owner < FRAME_CACHE_MAX_OWNERS; owner++) {
+        if (!g_cache.owners[owner].hidden) continue;
+        for (int kind = 0; kind < FRAME_CACHE_MAX_KINDS; kind++) hidden += g_cache.owners[owner].bytes[kind];
+    }
+    return g_cache.used + bytes <= g_cache.budget + hidden;
+}
+
+static void ReleaseEntry(FrameCacheEntry* entry) {
+    EnterCriticalSection(&g_cacheLock);
+    FrameCache_Release(&g_cache, entry);
+    LeaveCriticalSection(&g_cacheLock);
+}
+
+// 배경 스레드: GIF 하나의 창 크기 프레임을 캐시에 채우기 (요청이 없거나 이미 처리했으면 그냥 돌아감)
+// 원본은 캐시에 있는 프레임만 씀 (빠진 프레임은 UI 스레드가 디코딩한 뒤 다음 요청에서), 예산이 모자라면 멈춤
+static void BuildScaledFrames(GifWindow* gif, int index) {
+    EnterCriticalSection(&g_cacheLock);
+    LONG generation = gif->scaleGeneration;
+    int width = gif->scaleTargetWidth;
+    int height = gif->scaleTargetHeight;
+    bool pending = generation != gif->scaleDone;
+    LeaveCriticalSection(&g_cacheLock);
+    if (!pending) return;
+    
+    size_t bytes = (size_t)width * height * 4;
+    bool inserted = false;
+    for (UINT i = 0; width > 0 && height > 0 && i < gif->frameCount; i++) {
+        if (ScaleRequestChanged(gif, generation)) break;
+        
+        // 원본 프레임은 고정해 두고 잠금 밖에서 확대/축소 (그동안 버려지지 않음)
+        FrameCacheEntry* src = NULL;
+        EnterCriticalSection(&g_cacheLock);
+        bool fits = FitsBudget(bytes);
+        if (fits && !FrameCache_Contains(&g_cache, index, GIF_CACHE_SCALED, i)) {
+            src = FrameCache_Pin(&g_cache, index, GIF_CACHE_FRAME, i);
+        }
+        LeaveCriticalSection(&g_cacheLock);
+        if (!fits) break;
+        if (!src) continue;
+        
+        BYTE* dst = (BYTE*)malloc(bytes);
+        bool ok = dst && ScaleFrame((BYTE*)src->data, gif->cacheWidth, gif->cacheHeight, dst, width, height,
+                                    InterpolationModeHighQualityBicubic) == Ok;
+        
+        // 요청이 그대로일 때만 넣음
+        FrameCacheEntry* entry = NULL;
+        EnterCriticalSection(&g_cacheLock);
+        FrameCache_Release(&g_cache, src);
+        if (ok && gif->scaleGeneration == generation) {
+            entry = FrameCache_Insert(&g_cache, index, GIF_CACHE_SCALED, (int)i, dst, bytes);
+            if (entry) FrameCache_Release(&g_cache, entry);
+        }
+        LeaveCriticalSection(&g_cacheLock);
+        if (entry) {
+            inserted = true;
+        } else {
+            free(dst);
+            if (!ok) break;
+        }
+    }
     
-    // GDI+로 GIF 그리기 (최적화: 중간 품질)
-    Graphics graphics(hdcMem);
-    graphics.SetInterpolationMode(InterpolationModeBilinear);      // CPU 최적화
-    graphics.SetCompositingMode(CompositingModeSourceOver);
-    graphics.SetCompositingQuality(CompositingQualityDefault);     // CPU 최적화
+    EnterCriticalSection(&g_cacheLock);
+    if (gif->scaleGeneration == generation) gif->scaleDone = generation;
+    LeaveCriticalSection(&g_cacheLock);
     
-    // 투명 배경
-    graphics.Clear(Color(0, 0, 0, 0));
+    if (inserted) PostMessageW(gif->hwnd, WM_GIF_SCALED, 0, 0);
+}
+
+static DWORD WINAPI ScaleThread(LPVOID lpParam) {
+    while (g_scaleRunning) {
+        WaitForSingleObject(g_scaleEvent, INFINITE);
+        
+        // 드래그로 크기를 바꾸는 중에는 요청이 잦아들 때까지 기다림
+        while (g_scaleRunning && WaitForSingleObject(g_scaleEvent, GIF_SCALE_SETTLE_MS) == WAIT_OBJECT_0) {}
+        
+        for (int i = 0; i < MAX_GIFS && g_scaleRunning; i++) {
+            BuildScaledFrames(&g_gifs[i], i);
+        }
+    }
+    return 0;
+}
+
+// UI 스레드: 지금 창 크기의 캐시 요청, 반환값 = 배경에서 만드는 중인지
+// 크기가 바뀌면 예전 크기 프레임은 버림, 같은 크기에서 빠진 프레임(버려졌거나 원본이 없었음)은 루프 처음에 한 번 다시 요청
+static bool RequestScaledFrames(GifWindow* gif, int index) {
+    bool needed = gif->width != gif->cacheWidth || gif->height != gif->cacheHeight;
+    bool signal = false;
+    
+    EnterCriticalSection(&g_cacheLock);
+    if (needed && (gif->scaleTargetWidth != gif->width || gif->scaleTargetHeight != gif->height)) {
+        gif->scaleTargetWidth = gif->width;
+        gif->scaleTargetHeight = gif->height;
+        gif->scaleGeneration++;
+        FrameCache_Remove(&g_cache, index, GIF_CACHE_SCALED);
+        signal = true;
+    } else if (needed && gif->currentFrame == 0 && gif->scaleDone == gif->scaleGeneration &&
+               g_cache.owners[index].count[GIF_CACHE_SCALED] < (int)gif->frameCount) {
+        gif->scaleGeneration++;
+        signal = true;
+    } else if (!needed && gif->scaleTargetWidth != 0) {
+        // 원본 캐시 크기로 돌아옴: 진행 중인 요청 취소
+        gif->scaleTargetWidth = 0;
+        gif->scaleTargetHeight = 0;
+        gif->scaleGeneration++;
+        FrameCache_Remove(&g_cache, index, GIF_CACHE_SCALED);
+    }
+    bool building = gif->scaleDone != gif->scaleGeneration;
+    LeaveCriticalSection(&g_cacheLock);
+    
+    if (!signal) return building;
+    if (!g_scaleThread) {
+        g_scaleEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+        g_scaleRunning = true;
+        g_scaleThread = CreateThread(NULL, 0, ScaleThread, NULL, 0, NULL);
+    }
+    SetEvent(g_scaleEvent);
+    return building;
+}
+
+static void StopScaleThread(void) {
+    if (!g_scaleThread) return;
+    
+    g_scaleRunning = false;
+    SetEvent(g_scaleEvent);
+    WaitForSingleObject(g_scaleThread, INFINITE);  // 캐시 프레임을 읽는 중일 수 있으므로 끝까지 기다림
+    CloseHandle(g_scaleThread);
+    CloseHandle(g_scaleEvent);
+    g_scaleThread = NULL;
+    g_scaleEvent = NULL;
+}
+
+// 원본 크기 캔버스 준비 (새로 만들면 내용이 없으므로 디코더도 처음으로)
+static bool EnsureCanvas(GifWindow* gif) {
+    if (gif->canvas) return true;
+    gif->canvas = (unsigned int*)malloc((size_t)gif->srcWidth * gif->srcHeight * 4);
+    GifDecoder_Rewind(gif->decoder);
+    return gif->canvas != NULL;
+}
+
+// 모든 프레임이 캐시에 있을 때: 캔버스는 버림 (다음에 빠진 프레임이 생기면 다시 만듦)
+static void FreeCanvas(GifWindow* gif) {
+    free(gif->canvas);
+    gif->canvas = NULL;
+    GifDecoder_Rewind(gif->decoder);
+}
+
+static bool AllFramesCached(const GifWindow* gif, int index) {
+    EnterCriticalSection(&g_cacheLock);
+    bool all = g_cache.owners[index].count[GIF_CACHE_FRAME] >= (int)gif->frameCount;
+    LeaveCriticalSection(&g_cacheLock);
+    return all;
+}
+
+// 디코딩하면서 체크포인트를 남길지: 이 GIF가 예산 때문에 프레임을 잃은 적이 있고 캔버스가 예산에 비해 작을 때만
+static bool CheckpointsWanted(const GifWindow* gif, int index) {
+    size_t canvasBytes = (size_t)gif->srcWidth * gif->srcHeight * 4;
+    EnterCriticalSection(&g_cacheLock);
+    bool wanted = g_cache.owners[index].evictions > 0 && canvasBytes <= g_cache.budget / 8;
+    LeaveCriticalSection(&g_cacheLock);
+    return wanted;
+}
+
+// 캔버스를 frame을 그리기 직전 상태로 만들어 체크포인트로 보관 (이미 있으면 그대로)
+static void SaveCheckpoint(GifWindow* gif, int index, UINT frame) {
+    size_t bytes = (size_t)gif->srcWidth * gif->srcHeight * 4;
+    EnterCriticalSection(&g_cacheLock);
+    bool exists = FrameCache_Contains(&g_cache, index, GIF_CACHE_CHECKPOINT, (int)frame) != 0;
+    LeaveCriticalSection(&g_cacheLock);
+    if (exists) return;
+    
+    unsigned int* copy = (unsigned int*)malloc(bytes);
+    if (!copy) return;
+    GifDecoder_ApplyDisposal(gif->decoder, gif->canvas, (size_t)gif->srcWidth * 4);
+    memcpy(copy, gif->canvas, bytes);
+    
+    EnterCriticalSection(&g_cacheLock);
+    FrameCacheEntry* entry = FrameCache_Insert(&g_cache, index, GIF_CACHE_CHECKPOINT, (int)frame, copy, bytes);
+    if (entry) FrameCache_Release(&g_cache, entry);
+    LeaveCriticalSection(&g_cacheLock);
+    if (!entry) free(copy);
+}
+
+// 원본 크기 캔버스를 frame까지 합성
+// 시작점: 지금 위치에서 이어서, 또는 그보다 가까운 frame 이하의 키프레임 / 보관한 체크포인트 (처음부터 다시 디코딩하지 않음)
+static bool SeekCanvas(GifWindow* gif, int index, UINT frame) {
+    GifDecoder* decoder = gif->decoder;
+    size_t stride = (size_t)gif->srcWidth * 4;
+    UINT next = (UINT)decoder->nextFrame;
+    if (next == frame + 1) return true;
+    
+    // 이어서 디코딩하는 것보다 가까운 시작점 (지나간 프레임이면 0까지 찾음, 첫 프레임은 항상 키프레임)
+    UINT lowest = (next <= frame) ? next + 1 : 0;
+    for (UINT k = frame + 1; k-- > lowest;) {
+        if (GifDecoder_IsKeyFrame(decoder, (int)k)) {
+            if (k > 0) memset(gif->canvas, 0, stride * gif->srcHeight);  // 덮어쓰지만 데이터가 잘렸을 때 대비
+            GifDecoder_Seek(decoder, (int)k);
+            break;
+        }
+        EnterCriticalSection(&g_cacheLock);
+        FrameCacheEntry* checkpoint = NULL;
+        if (FrameCache_Contains(&g_cache, index, GIF_CACHE_CHECKPOINT, (int)k)) {
+            checkpoint = FrameCache_Acquire(&g_cache, index, GIF_CACHE_CHECKPOINT, (int)k);
+        }
+        LeaveCriticalSection(&g_cacheLock);
+        if (checkpoint) {
+            memcpy(gif->canvas, checkpoint->data, checkpoint->bytes);
+            ReleaseEntry(checkpoint);
+            GifDecoder_Seek(decoder, (int)k);
+            break;
+        }
+    }
     
-    // 현재 프레임 선택
-    gif->pImage->SelectActiveFrame(&gif->dimensionID, gif->currentFrame);
+    bool saveCheckpoints = CheckpointsWanted(gif, index);
+    while ((UINT)decoder->nextFrame <= frame) {
+        int k = decoder->nextFrame;
+        if (saveCheckpoints && k > 0 && k % GIF_CHECKPOINT_INTERVAL == 0 && !GifDecoder_IsKeyFrame(decoder, k)) {
+            SaveCheckpoint(gif, index, (UINT)k);
+        }
+        if (!GifDecoder_NextFrame(decoder, gif->canvas, stride, NULL)) return false;
+    }
+    return true;
+}
+
+// 프레임 하나를 디코딩해서 캐시 크기로 캐시에 넣음 (원본이 크면 고품질로 한 번 줄임), 반환값 = 고정된 항목
+// evict가 false면 보이는 GIF의 프레임을 버려야 할 때 넣지 않음 (미리 채우기)
+static FrameCacheEntry* DecodeFrame(GifWindow* gif, int index, UINT frame, bool evict) {
+    if (!EnsureCanvas(gif) || !SeekCanvas(gif, index, frame)) return NULL;
+    
+    BYTE* data = (BYTE*)malloc(gif->frameBytes);
+    if (!data) return NULL;
+    if (gif->cacheWidth != gif->srcWidth || gif->cacheHeight != gif->srcHeight) {
+        if (ScaleFrame((BYTE*)gif->canvas, gif->srcWidth, gif->srcHeight, data, gif->cacheWidth, gif->cacheHeight,
+                       InterpolationModeHighQualityBicubic) != Ok) {
+            free(data);
+            return NULL;
+        }
+    } else {
+        memcpy(data, gif->canvas, gif->frameBytes);
+    }
     
-    // GIF 그리기
-    graphics.DrawImage(gif->pImage, 0, 0, gif->width, gif->height);
+    FrameCacheEntry* entry = NULL;
+    EnterCriticalSection(&g_cacheLock);
+    if (evict || FitsBudget(gif->frameBytes)) {
+        entry = FrameCache_Insert(&g_cache, index, GIF_CACHE_FRAME, (int)frame, data, gif->frameBytes);
+    }
+    LeaveCriticalSection(&g_cacheLock);
+    if (!entry) free(data);
+    return entry;
+}
+
+// 캐시 크기 프레임 가져오기 (없으면 디코딩해서 넣음, 예산에 못 넣으면 NULL -> 캔버스에 이미 합성돼 있음)
+static FrameCacheEntry* AcquireFrame(GifWindow* gif, int index, UINT frame) {
+    EnterCriticalSection(&g_cacheLock);
+    FrameCacheEntry* entry = FrameCache_Acquire(&g_cache, index, GIF_CACHE_FRAME, (int)frame);
+    LeaveCriticalSection(&g_cacheLock);
+    return entry ? entry : DecodeFrame(gif, index, frame, true);
+}
+
+// 로드할 때 예산 안에서 앞 프레임부터 미리 디코딩 (모두 들어가면 캔버스는 버림)
+static void PrefillFrames(GifWindow* gif, int index) {
+    for (UINT i = 0; i < gif->frameCount; i++) {
+        FrameCacheEntry* entry = DecodeFrame(gif, index, i, false);
+        if (!entry) break;
+        ReleaseEntry(entry);
+    }
+    if (AllFramesCached(gif, index)) FreeCanvas(gif);
+}
+
+// 레이어드 윈도우 업데이트 (투명 배경 GIF)
+// 창 크기 프레임 -> 캐시 크기 프레임 순으로 캐시에서 찾음 (캐시 크기면 복사, 아니면 확대/축소), 없으면 디코딩해서 넣음
+// 창 크기 프레임은 배경에서 만드는 동안 최근접, 예산이 모자라 못 만들면 쌍선형으로 그때그때 확대/축소
+static void UpdateGifWindow(int index) {
+    GifWindow* gif = &g_gifs[index];
+    if (!gif->hwnd || !gif->decoder) return;
+    if (!EnsureSurface(gif)) return;
+    
+    UINT frame = gif->currentFrame;
+    bool atCacheSize = gif->width == gif->cacheWidth && gif->height == gif->cacheHeight;
+    FrameCacheEntry* scaled = NULL;
+    if (!atCacheSize) {
+        EnterCriticalSection(&g_cacheLock);
+        if (gif->scaleTargetWidth == gif->width && gif->scaleTargetHeight == gif->height) {
+            scaled = FrameCache_Acquire(&g_cache, index, GIF_CACHE_SCALED, (int)frame);
+        }
+        LeaveCriticalSection(&g_cacheLock);
+    }
+    bool building = RequestScaledFrames(gif, index);
+    FrameCacheEntry* entry = scaled ? NULL : AcquireFrame(gif, index, frame);
+    
+    GdiFlush();  // DIB에 직접 쓰기 전에 밀린 GDI 작업 끝내기
+    if (scaled) {
+        memcpy(gif->surfaceBits, scaled->data, scaled->bytes);
+        ReleaseEntry(scaled);
+    } else if (entry) {
+        if (atCacheSize) {
+            memcpy(gif->surfaceBits, entry->data, gif->frameBytes);
+        } else {
+            ScaleFrame((BYTE*)entry->data, gif->cacheWidth, gif->cacheHeight, (BYTE*)gif->surfaceBits,
+                       gif->width, gif->height,
+                       building ? InterpolationModeNearestNeighbor : InterpolationModeBilinear);
+        }
+        ReleaseEntry(entry);
+    } else if (gif->canvas && SeekCanvas(gif, index, frame)) {
+        ScaleFrame((BYTE*)gif->canvas, gif->srcWidth, gif->srcHeight, (BYTE*)gif->surfaceBits,
+                   gif->width, gif->height, InterpolationModeBilinear);  // CPU 최적화
+    } else {
+        return;
+    }
     
-    // 레이어드 윈도우 업데이트
+    // 레이어드 윈도우 업데이트 (위치는 그대로)
     POINT ptSrc = {0, 0};
     SIZE sizeWnd = {gif->width, gif->height};
     BLENDFUNCTION blend = {0};
@@ -317,19 +733,7 @@ static void UpdateGifWindow(int index) {
     blend.SourceConstantAlpha = 255;
     blend.AlphaFormat = AC_SRC_ALPHA;
     
-    POINT ptPos;
-    RECT rc;
-    GetWindowRect(gif->hwnd, &rc);
-    ptPos.x = rc.left;
-    ptPos.y = rc.top;
-    
-    UpdateLayeredWindow(gif->hwnd, hdcScreen, &ptPos, &sizeWnd, hdcMem, &ptSrc, 0, &blend, ULW_ALPHA);
-    
-    // 정리
-    SelectObject(hdcMem, hOldBitmap);
-    DeleteObject(hBitmap);
-    DeleteDC(hdcMem);
-    ReleaseDC(NULL, hdcScreen);
+    UpdateLayeredWindow(gif->hwnd, NULL, NULL, &sizeWnd, gif->hdcSurface, &ptSrc, 0, &blend, ULW_ALPHA);
 }
 
 // 실행 파일 경로 기준으로 assets 폴더 경로 구하기
@@ -368,18 +772,39 @@ static HWND CreateGifWindow(int x, int y, int width, int height, int index) {
 static bool LoadGif(const wchar_t* filePath, int x, int y, int width, int height) {
     if (g_gifCount >= MAX_GIFS) return false;
     
-    Image* pImage = Image::FromFile(filePath);
-    if (pImage == NULL || pImage->GetLastStatus() != Ok) {
-        if (pImage) delete pImage;
+    // 파일 전체를 읽고 바로 닫음 (재생 중에 파일을 잠그지 않음)
+    FILE* fp = _wfopen(filePath, L"rb");
+    if (!fp) return false;
+    fseek(fp, 0, SEEK_END);
+    long fileSize = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    BYTE* fileData = (fileSize > 0) ? (BYTE*)malloc(fileSize) : NULL;
+    size_t readSize = fileData ? fread(fileData, 1, fileSize, fp) : 0;
+    fclose(fp);
+    
+    GifDecoder* decoder = new (std::nothrow) GifDecoder;
+    if (!decoder || !GifDecoder_Open(decoder, fileData, readSize)) {
+        delete decoder;
+        free(fileData);
         return false;
     }
     
     GifWindow* gif = &g_gifs[g_gifCount];
-    gif->pImage = pImage;
+    gif->decoder = decoder;
+    gif->fileData = fileData;
+    gif->canvas = NULL;
+    gif->hdcSurface = NULL;
+    gif->hSurface = NULL;
+    gif->hOldSurface = NULL;
+    gif->surfaceBits = NULL;
+    gif->surfaceWidth = 0;
+    gif->surfaceHeight = 0;
     
     // width/height가 0이면 원본 크기 사용, 최대 800px 제한
-    int origW = pImage->GetWidth();
-    int origH = pImage->GetHeight();
+    int origW = decoder->width;
+    int origH = decoder->height;
+    gif->srcWidth = origW;
+    gif->srcHeight = origH;
     
     if (width > 0) {
         gif->width = width;
@@ -404,52 +829,74 @@ static bool LoadGif(const wchar_t* filePath, int x, int y, int width, int height
     gif->frameDelays = NULL;
     gif->lastFrameTime = GetTickCount();
     gif->speedMultiplier = 1.0f;
-    gif->frameCount = 1;  // 기본값
-    memset(&gif->dimensionID, 0, sizeof(gif->dimensionID));  // 초기화
-    
-    // 프레임 수 가져오기
-    UINT dimensionCount = pImage->GetFrameDimensionsCount();
-    if (dimensionCount > 0) {
-        GUID* dimensionIDs = new GUID[dimensionCount];
-        if (dimensionIDs) {
-            pImage->GetFrameDimensionsList(dimensionIDs, dimensionCount);
-            gif->dimensionID = dimensionIDs[0];
-            gif->frameCount = pImage->GetFrameCount(&gif->dimensionID);
-            delete[] dimensionIDs;
+    gif->frameCount = decoder->frameCount;
+    
+    // 프레임 딜레이 (GIF 딜레이는 1/100초 단위, ms로 변환, 0이면 기본값 100ms)
+    gif->frameDelays = new (std::nothrow) UINT[gif->frameCount];
+    if (gif->frameDelays) {
+        for (UINT i = 0; i < gif->frameCount; i++) {
+            gif->frameDelays[i] = decoder->frames[i].delay * 10;
+            if (gif->frameDelays[i] == 0) gif->frameDelays[i] = 100;
         }
     }
     
-    if (gif->frameCount == 0) gif->frameCount = 1;
-    
-    // 프레임 딜레이 정보 읽기 (PropertyTagFrameDelay = 0x5100)
-    UINT propSize = pImage->GetPropertyItemSize(PropertyTagFrameDelay);
-    if (propSize > 0) {
-        PropertyItem* propItem = (PropertyItem*)malloc(propSize);
-        if (propItem) {
-            if (pImage->GetPropertyItem(PropertyTagFrameDelay, propSize, propItem) == Ok) {
-                gif->frameDelays = new (std::nothrow) UINT[gif->frameCount];
-                if (gif->frameDelays) {
-                    UINT* delays = (UINT*)propItem->value;
-                    for (UINT i = 0; i < gif->frameCount; i++) {
-                        // GIF 딜레이는 1/100초 단위, ms로 변환
-                        gif->frameDelays[i] = delays[i] * 10;
-                        // 0이면 기본값 100ms 사용
-                        if (gif->frameDelays[i] == 0) gif->frameDelays[i] = 100;
-                    }
-                }
+    // 프레임 시작 시각 누적 테이블 (시각 -> 프레임은 이진 탐색)
+    gif->frameStarts = NULL;
+    gif->beatsPerLoop = 1;
+    if (gif->frameDelays) {
+        gif->frameStarts = new (std::nothrow) UINT[gif->frameCount + 1];
+        if (gif->frameStarts) {
+            gif->frameStarts[0] = 0;
+            for (UINT i = 0; i < gif->frameCount; i++) {
+                gif->frameStarts[i + 1] = gif->frameStarts[i] + gif->frameDelays[i];
             }
-            free(propItem);
+            
+            // 자동 루프 길이: 120 BPM 기준 원래 길이에 가장 가까운 2의 거듭제곱 박자
+            double beats = gif->frameStarts[gif->frameCount] / 500.0;
+            int exponent = (int)floor(log2(beats) + 0.5);
+            if (exponent < 0) exponent = 0;
+            if (exponent > 4) exponent = 4;
+            gif->beatsPerLoop = 1 << exponent;
         }
     }
     
-    // 딜레이 정보가 없으면 기본값 사용
-    if (gif->frameDelays == NULL) {
-        gif->frameDelays = new (std::nothrow) UINT[gif->frameCount];
-        if (gif->frameDelays) {
-            for (UINT i = 0; i < gif->frameCount; i++) {
-                gif->frameDelays[i] = 100;  // 기본 100ms
-            }
-        }
+    // 캐시 프레임 크기 (원본이 GIF_CACHE_MAX_SIZE보다 크면 비율대로 줄임)
+    int longest = (origW > origH) ? origW : origH;
+    gif->cacheWidth = origW;
+    gif->cacheHeight = origH;
+    if (longest > GIF_CACHE_MAX_SIZE) {
+        gif->cacheWidth = (int)((long long)origW * GIF_CACHE_MAX_SIZE / longest);
+        gif->cacheHeight = (int)((long long)origH * GIF_CACHE_MAX_SIZE / longest);
+        if (gif->cacheWidth < 1) gif->cacheWidth = 1;
+        if (gif->cacheHeight < 1) gif->cacheHeight = 1;
+    }
+    gif->frameBytes = (size_t)gif->cacheWidth * gif->cacheHeight * 4;
+    
+    // 이 자리를 쓰던 GIF의 요청은 버림 (창 크기 캐시는 새로 요청)
+    EnterCriticalSection(&g_cacheLock);
+    FrameCache_Remove(&g_cache, g_gifCount, -1);
+    FrameCache_SetHidden(&g_cache, g_gifCount, 0);
+    gif->scaleTargetWidth = 0;
+    gif->scaleTargetHeight = 0;
+    gif->scaleDone = gif->scaleGeneration;
+    LeaveCriticalSection(&g_cacheLock);
+    
+    // 예산 안에서 프레임 미리 디코딩 (디코딩하는 캔버스가 없으면 GIF를 쓸 수 없음)
+    PrefillFrames(gif, g_gifCount);
+    if (!gif->canvas && !AllFramesCached(gif, g_gifCount) && !EnsureCanvas(gif)) {
+        EnterCriticalSection(&g_cacheLock);
+        FrameCache_Remove(&g_cache, g_gifCount, -1);
+        LeaveCriticalSection(&g_cacheLock);
+        GifDecoder_Close(decoder);
+        delete decoder;
+        free(fileData);
+        delete[] gif->frameDelays;
+        delete[] gif->frameStarts;
+        gif->decoder = NULL;
+        gif->fileData = NULL;
+        gif->frameDelays = NULL;
+        gif->frameStarts = NULL;
+        return false;
     }
     
     // 창 생성 (gif->width/height는 원본 크기로 이미 설정됨)
@@ -556,6 +1003,13 @@ int GifPlayer_Init(void) {
         return 0;
     }
     
+    InitializeCriticalSection(&g_cacheLock);
+    if (!FrameCache_Init(&g_cache, (size_t)g_cacheBudgetMB * 1024 * 1024)) {
+        DeleteCriticalSection(&g_cacheLock);
+        GdiplusShutdown(g_gdiplusToken);
+        g_gdiplusToken = 0;
+        return 0;
+    }
     g_initialized = true;
     g_gifCount = 0;
     
@@ -569,19 +1023,34 @@ int GifPlayer_Init(void) {
 }
 
 void GifPlayer_Cleanup(void) {
+    if (g_initialized) StopScaleThread();
+    
     for (int i = 0; i < g_gifCount; i++) {
         if (g_gifs[i].hwnd) {
             DestroyWindow(g_gifs[i].hwnd);
             g_gifs[i].hwnd = NULL;
         }
-        if (g_gifs[i].pImage) {
-            delete g_gifs[i].pImage;
-            g_gifs[i].pImage = NULL;
+        if (g_gifs[i].decoder) {
+            GifDecoder_Close(g_gifs[i].decoder);
+            delete g_gifs[i].decoder;
+            g_gifs[i].decoder = NULL;
         }
+        free(g_gifs[i].fileData);
+        free(g_gifs[i].canvas);
+        g_gifs[i].fileData = NULL;
+        g_gifs[i].canvas = NULL;
+        g_gifs[i].scaleTargetWidth = 0;
+        g_gifs[i].scaleTargetHeight = 0;
+        g_gifs[i].scaleDone = g_gifs[i].scaleGeneration;
+        FreeSurface(&g_gifs[i]);
         if (g_gifs[i].frameDelays) {
             delete[] g_gifs[i].frameDelays;
             g_gifs[i].frameDelays = NULL;
         }
+        if (g_gifs[i].frameStarts) {
+            delete[] g_gifs[i].frameStarts;
+            g_gifs[i].frameStarts = NULL;
+        }
     }
     g_gifCount = 0;
     
@@ -591,15 +1060,102 @@ void GifPlayer_Cleanup(void) {
     }
     
     UnregisterClassW(GIF_CLASS_NAME, g_hInstance);
+    if (g_initialized) {
+        FrameCache_Free(&g_cache);  // 배경 스레드는 이미 멈춤
+        DeleteCriticalSection(&g_cacheLock);
+    }
     g_initialized = false;
 }
 
+// 루프 안 시각(ms)에 해당하는 프레임 (frameStarts 이진 탐색)
+static UINT FrameAtTime(const GifWindow* gif, UINT time) {
+    UINT lo = 0, hi = gif->frameCount - 1;
+    while (lo < hi) {
+        UINT mid = (lo + hi + 1) / 2;
+        if (gif->frameStarts[mid] <= time) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return lo;
+}
+
+// 현재 박자 위치 (고정 템포면 시계 기준, 아니면 감지된 값)
+static bool GetBeatPosition(double* beats) {
+    if (g_fixedTempo > 0.0f) {
+        LARGE_INTEGER now, freq;
+        QueryPerformanceCounter(&now);
+        QueryPerformanceFrequency(&freq);
+        double seconds = (double)(now.QuadPart - g_tempoOrigin.QuadPart) / freq.QuadPart;
+        *beats = seconds * g_fixedTempo / 60.0;
+        return true;
+    }
+    if (g_beatValid) {
+        *beats = g_beatPosition;
+        return true;
+    }
+    return false;
+}
+
+// 프레임을 직접 계산할 수 있는 GIF인지 (보이는 애니메이션 + 시각 테이블)
+static bool CanSyncFrames(const GifWindow* gif) {
+    return gif->decoder && gif->frameCount > 1 && gif->frameStarts &&
+           gif->hwnd && IsWindowVisible(gif->hwnd);
+}
+
+// 루프 안 위치(0.0 ~ 1.0)에 해당하는 프레임 표시 (바뀔 때만 다시 그림)
+static void ShowLoopPosition(int index, double loopPos) {
+    GifWindow* gif = &g_gifs[index];
+    
+    loopPos -= floor(loopPos);
+    UINT loopLength = gif->frameStarts[gif->frameCount];
+    UINT frame = FrameAtTime(gif, (UINT)(loopPos * loopLength));
+    if (frame != gif->currentFrame) {
+        gif->currentFrame = frame;
+        UpdateGifWindow(index);
+    }
+}
+
+// 박자 모드: 각 GIF의 루프를 N 박자에 맞춰 프레임 선택 (누적 상태 없음)
+static void SyncFramesToBeat(double beats) {
+    for (int i = 0; i < g_gifCount; i++) {
+        GifWindow* gif = &g_gifs[i];
+        if (!CanSyncFrames(gif)) continue;
+        
+        int loopBeats = (g_beatsPerLoop > 0) ? g_beatsPerLoop : gif->beatsPerLoop;
+        ShowLoopPosition(i, beats / loopBeats);
+    }
+}
+
+// 위치 모드: 곡 재생 위치 x 속도 배율을 루프 길이로 나눈 나머지 (누적 상태 없음)
+static void SyncFramesToPosition(double seconds) {
+    for (int i = 0; i < g_gifCount; i++) {
+        GifWindow* gif = &g_gifs[i];
+        if (!CanSyncFrames(gif)) continue;
+        
+        double elapsedMs = seconds * 1000.0 * gif->speedMultiplier * g_globalSpeedMultiplier;
+        ShowLoopPosition(i, elapsedMs / gif->frameStarts[gif->frameCount]);
+    }
+}
+
 void GifPlayer_NextFrame(void) {
     DWORD currentTime = GetTickCount();
     
+    // 박자 / 위치 모드 (정보가 없으면 기존 방식으로)
+    double beats;
+    if (g_playbackMode == GIF_PLAYBACK_BEAT && GetBeatPosition(&beats)) {
+        SyncFramesToBeat(beats);
+        return;
+    }
+    if (g_playbackMode == GIF_PLAYBACK_POSITION && g_trackValid) {
+        SyncFramesToPosition(g_trackPosition);
+        return;
+    }
+    
     for (int i = 0; i < g_gifCount; i++) {
         GifWindow* gif = &g_gifs[i];
-        if (gif->pImage && gif->frameCount > 1 && gif->hwnd && IsWindowVisible(gif->hwnd)) {
+        if (gif->decoder && gif->frameCount > 1 && gif->frameDelays && gif->hwnd && IsWindowVisible(gif->hwnd)) {
             // 현재 프레임의 딜레이 시간 계산 (속도 배율 적용)
             UINT delay = (UINT)(gif->frameDelays[gif->currentFrame] / (gif->speedMultiplier * g_globalSpeedMultiplier));
             if (delay < 10) delay = 10;  // 최소 10ms
@@ -607,7 +1163,6 @@ void GifPlayer_NextFrame(void) {
             // 딜레이 시간이 지났으면 다음 프레임으로
             if (currentTime - gif->lastFrameTime >= delay) {
                 gif->currentFrame = (gif->currentFrame + 1) % gif->frameCount;
-                gif->pImage->SelectActiveFrame(&gif->dimensionID, gif->currentFrame);
                 gif->lastFrameTime = currentTime;
                 UpdateGifWindow(i);
             }
@@ -694,6 +1249,52 @@ float GifPlayer_GetSpeedMultiplier(void) {
     return g_globalSpeedMultiplier;
 }
 
+void GifPlayer_SetPlaybackMode(int mode) {
+    if (mode < GIF_PLAYBACK_CLOCK || mode > GIF_PLAYBACK_POSITION) mode = GIF_PLAYBACK_CLOCK;
+    g_playbackMode = mode;
+    
+    // 기존 방식으로 돌아갈 때 밀린 시간만큼 한꺼번에 넘어가지 않게
+    DWORD now = GetTickCount();
+    for (int i = 0; i < g_gifCount; i++) {
+        g_gifs[i].lastFrameTime = now;
+    }
+}
+
+int GifPlayer_GetPlaybackMode(void) {
+    return g_playbackMode;
+}
+
+void GifPlayer_SetBeatsPerLoop(int beats) {
+    if (beats < 0) beats = 0;
+    if (beats > 16) beats = 16;
+    g_beatsPerLoop = beats;
+}
+
+int GifPlayer_GetBeatsPerLoop(void) {
+    return g_beatsPerLoop;
+}
+
+void GifPlayer_SetTempo(float bpm) {
+    if (bpm < 0.0f) bpm = 0.0f;
+    if (bpm > 300.0f) bpm = 300.0f;
+    g_fixedTempo = bpm;
+    QueryPerformanceCounter(&g_tempoOrigin);
+}
+
+float GifPlayer_GetTempo(void) {
+    return g_fixedTempo;
+}
+
+void GifPlayer_SetBeatPosition(double beats, int valid) {
+    g_beatPosition = beats;
+    g_beatValid = (valid != 0);
+}
+
+void GifPlayer_SetTrackPosition(double seconds, int valid) {
+    g_trackPosition = seconds;
+    g_trackValid = (valid != 0);
+}
+
 int GifPlayer_GetPosition(int index, int* x, int* y, int* size) {
     if (index < 0 || index >= g_gifCount || !g_gifs[index].hwnd) {
         return 0;
@@ -721,10 +1322,9 @@ int GifPlayer_SetPosition(int index, int x, int y, int size) {
     // size가 0이거나 음수면 크기 변경 안 함 (원본 크기 유지)
     if (size > 0) {
         // 원본 비율 유지하면서 크기 조절
-        Image* pImage = g_gifs[index].pImage;
-        if (pImage) {
-            int origWidth = pImage->GetWidth();
-            int origHeight = pImage->GetHeight();
+        if (g_gifs[index].srcWidth > 0) {
+            int origWidth = g_gifs[index].srcWidth;
+            int origHeight = g_gifs[index].srcHeight;
             
             // 비율 계산 (긴 쪽 기준)
             float ratio = (float)origHeight / origWidth;
@@ -748,6 +1348,80 @@ int GifPlayer_SetPosition(int index, int x, int y, int size) {
     return 1;
 }
 
+int GifPlayer_GetMemoryInfo(int index, GifMemoryInfo* info) {
+    if (!info) return 0;
+    memset(info, 0, sizeof(GifMemoryInfo));
+    if (!g_initialized || index < 0 || index >= g_gifCount) return 0;
+    
+    const GifWindow* gif = &g_gifs[index];
+    info->frameCount = (int)gif->frameCount;
+    info->cacheWidth = gif->cacheWidth;
+    info->cacheHeight = gif->cacheHeight;
+    info->surfaceBytes = (unsigned long long)gif->surfaceWidth * gif->surfaceHeight * 4;
+    
+    // 디코더 (예산 밖: 파일 내용 + 디코딩 버퍼 + 원본 크기 캔버스)
+    if (gif->decoder) {
+        const GifDecoder* d = gif->decoder;
+        info->decoderBytes = sizeof(GifDecoder) + d->size + (unsigned long long)d->frameCount * sizeof(GifFrameInfo) +
+                             d->savedCapacity * sizeof(unsigned int) + d->indicesCapacity;
+    }
+    if (gif->canvas) info->decoderBytes += (unsigned long long)gif->srcWidth * gif->srcHeight * 4;
+    
+    EnterCriticalSection(&g_cacheLock);
+    const FrameCacheOwner* owner = &g_cache.owners[index];
+    info->cachedFrames = owner->count[GIF_CACHE_FRAME];
+    info->frameBytes = owner->bytes[GIF_CACHE_FRAME];
+    if (owner->count[GIF_CACHE_SCALED] > 0) {
+        info->scaledWidth = gif->scaleTargetWidth;
+        info->scaledHeight = gif->scaleTargetHeight;
+    }
+    info->scaledFrames = owner->count[GIF_CACHE_SCALED];
+    info->scaledBytes = owner->bytes[GIF_CACHE_SCALED];
+    info->checkpointBytes = owner->bytes[GIF_CACHE_CHECKPOINT];
+    info->evictions = owner->evictions;
+    info->hidden = owner->hidden;
+    LeaveCriticalSection(&g_cacheLock);
+    return 1;
+}
+
+void GifPlayer_SetCacheBudget(int megabytes) {
+    if (megabytes < GIF_CACHE_MIN_MB) megabytes = GIF_CACHE_MIN_MB;
+    if (megabytes > GIF_CACHE_MAX_MB) megabytes = GIF_CACHE_MAX_MB;
+    g_cacheBudgetMB = megabytes;
+    if (!g_initialized) return;  // Init에서 적용
+    
+    // 줄이면 바로 넘는 만큼 버림 (늘린 만큼은 다음에 디코딩하는 프레임부터 채움)
+    EnterCriticalSection(&g_cacheLock);
+    FrameCache_SetBudget(&g_cache, (size_t)megabytes * 1024 * 1024);
+    LeaveCriticalSection(&g_cacheLock);
+}
+
+int GifPlayer_GetCacheBudget(void) {
+    return g_cacheBudgetMB;
+}
+
+int GifPlayer_GetCacheStats(GifCacheStats* stats) {
+    if (!stats) return 0;
+    memset(stats, 0, sizeof(GifCacheStats));
+    stats->budgetBytes = (unsigned long long)g_cacheBudgetMB * 1024 * 1024;
+    if (!g_initialized) return 0;
+    
+    EnterCriticalSection(&g_cacheLock);
+    const FrameCacheStats* s = &g_cache.stats;
+    stats->budgetBytes = g_cache.budget;
+    stats->usedBytes = g_cache.used;
+    stats->entries = g_cache.entryCount;
+    stats->frameHits = s->hits[GIF_CACHE_FRAME];
+    stats->frameMisses = s->misses[GIF_CACHE_FRAME];
+    stats->scaledHits = s->hits[GIF_CACHE_SCALED];
+    stats->scaledMisses = s->misses[GIF_CACHE_SCALED];
+    stats->checkpointHits = s->hits[GIF_CACHE_CHECKPOINT];
+    for (int kind = 0; kind < FRAME_CACHE_MAX_KINDS; kind++) stats->evictions += s->evictions[kind];
+    stats->hiddenEvictions = s->hiddenEvictions;
+    LeaveCriticalSection(&g_cacheLock);
+    return 1;
+}
+
 // 현재 GIF의 저장된 zOrder 값 가져오기
 int GifPlayer_GetZOrder(int index) {
     if (index < 0 || index >= g_gifCount) {
@@ -56,12 +56,80 @@ void GifPlayer_SetClickThrough(int enable);
 void GifPlayer_SetSpeedMultiplier(float multiplier);
 float GifPlayer_GetSpeedMultiplier(void);
 
+// 재생 방식
+typedef enum {
+    GIF_PLAYBACK_CLOCK = 0,     // 프레임 딜레이 x 속도 배율 (기본)
+    GIF_PLAYBACK_BEAT,          // 루프 한 번 = N 박자 (박자 위치에서 프레임을 바로 계산)
+    GIF_PLAYBACK_POSITION       // 곡 재생 위치에서 프레임을 바로 계산 (탐색/일시정지에도 일정)
+} GifPlaybackMode;
+
+void GifPlayer_SetPlaybackMode(int mode);
+int GifPlayer_GetPlaybackMode(void);
+
+// 박자 모드: 루프당 박자 수 (0 = GIF마다 자동, 원래 길이에 가까운 2의 거듭제곱)
+void GifPlayer_SetBeatsPerLoop(int beats);
+int GifPlayer_GetBeatsPerLoop(void);
+
+// 박자 모드: 고정 템포 (0 = 감지된 템포 사용)
+void GifPlayer_SetTempo(float bpm);
+float GifPlayer_GetTempo(void);
+
+// 박자 모드: 감지된 박자 위치 전달 (NextFrame 전에 호출, valid가 0이면 기존 방식으로 재생)
+void GifPlayer_SetBeatPosition(double beats, int valid);
+
+// 위치 모드: 곡 재생 위치 전달 (NextFrame 전에 호출, valid가 0이면 기존 방식으로 재생)
+void GifPlayer_SetTrackPosition(double seconds, int valid);
+
 // GIF 위치/크기 가져오기
 int GifPlayer_GetPosition(int index, int* x, int* y, int* size);
 
 // GIF 위치/크기 설정
 int GifPlayer_SetPosition(int index, int x, int y, int size);
 
+// GIF 메모리 사용량 (공용 프레임 캐시에 있는 몫 + 캐시 밖 디코더 / 창 크기 버퍼)
+typedef struct {
+    int frameCount;
+    int cacheWidth;                 // 캐시 프레임 크기 (긴 변은 800px 이하로 줄여서 보관)
+    int cacheHeight;
+    int cachedFrames;               // 캐시에 있는 프레임 수 (나머지는 필요할 때 다시 디코딩)
+    unsigned long long frameBytes;  // 캐시 프레임 (프리멀티플라이 BGRA)
+    int scaledWidth;                // 창 크기 프레임 (0 = 없음, 창이 캐시 크기와 같거나 배경에서 만드는 중)
+    int scaledHeight;
+    int scaledFrames;
+    unsigned long long scaledBytes;
+    unsigned long long checkpointBytes;     // 다시 디코딩 시작점으로 보관한 원본 크기 캔버스
+    unsigned long long decoderBytes;    // 캐시 예산 밖: 파일 내용 + 디코더 버퍼 + 원본 크기 캔버스
+    unsigned long long surfaceBytes;    // 캐시 예산 밖: UpdateLayeredWindow용 창 크기 DIB
+    unsigned long long evictions;   // 예산 때문에 버려진 항목 수
+    int hidden;                     // 1 = 창을 숨겨서 먼저 버려짐
+} GifMemoryInfo;
+
+// 반환값 = 유효한 인덱스인지
+int GifPlayer_GetMemoryInfo(int index, GifMemoryInfo* info);
+
+// 프레임 캐시 예산 (모든 GIF 합계, MB), Init 전에 설정 가능, 줄이면 바로 넘는 만큼 버림
+#define GIF_CACHE_MIN_MB 16
+#define GIF_CACHE_MAX_MB 4096
+void GifPlayer_SetCacheBudget(int megabytes);
+int GifPlayer_GetCacheBudget(void);
+
+// 프레임 캐시 통계 (실행 후 누적)
+typedef struct {
+    unsigned long long budgetBytes;
+    unsigned long long usedBytes;
+    int entries;
+    unsigned long long frameHits;       // 캐시 크기 프레임
+    unsigned long long frameMisses;     // -> 다시 디코딩
+    unsigned long long scaledHits;      // 창 크기 프레임
+    unsigned long long scaledMisses;    // -> 캐시 크기 프레임으로 그때그때 확대/축소
+    unsigned long long checkpointHits;  // 다시 디코딩을 체크포인트에서 시작
+    unsigned long long evictions;
+    unsigned long long hiddenEvictions; // evictions 중 숨긴 GIF
+} GifCacheStats;
+
+// 반환값 = 초기화됐는지 (아니면 예산만 채움)
+int GifPlayer_GetCacheStats(GifCacheStats* stats);
+
 // GIF Z-order 가져오기/설정 (순서 저장/복원용)
 int GifPlayer_GetZOrder(int index);
 void GifPlayer_ApplyZOrder(int* zOrderArray, int count);
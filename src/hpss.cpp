@@ -0,0 +1,204 @@
+/*
+ * hpss.cpp - Streaming Harmonic / Percussive Separation
+ * 슬라이딩 중앙값: 힙 위치 0 = 중앙값, 양수 = 최소 힙 (중앙값 이상), 음수 = 최대 힙 (중앙값 이하)
+ * 위치 i의 부모는 i / 2 (0 방향으로 자름), 창은 항상 가득 찬 상태로 시작 (0으로 채움)
+ * 가장 오래된 값을 새 값으로 바꾼 뒤 그 자리에서 위 / 아래로만 옮기므로 O(log k)
+ */
+
+#include "hpss.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// 창 하나 (heap은 가운데를 가리킴: heap[-half] ~ heap[half])
+typedef struct {
+    float* value;
+    signed char* pos;
+    unsigned char* heap;
+    int half;
+} MedianWindow;
+
+static inline int Less(const MedianWindow* m, int i, int j) {
+    return m->value[m->heap[i]] < m->value[m->heap[j]];
+}
+
+static inline void Exchange(MedianWindow* m, int i, int j) {
+    unsigned char t = m->heap[i];
+    m->heap[i] = m->heap[j];
+    m->heap[j] = t;
+    m->pos[m->heap[i]] = (signed char)i;
+    m->pos[m->heap[j]] = (signed char)j;
+}
+
+// 최소 힙 (i > 0): 부모보다 작으면 올림 (부모가 0이면 중앙값과 비교), 반환값 = 최종 위치
+static inline int SiftUpMin(MedianWindow* m, int i) {
+    while (i > 0 && Less(m, i, i / 2)) {
+        Exchange(m, i, i / 2);
+        i /= 2;
+    }
+    return i;
+}
+
+static inline int SiftUpMax(MedianWindow* m, int i) {
+    while (i < 0 && Less(m, i / 2, i)) {
+        Exchange(m, i, i / 2);
+        i /= 2;
+    }
+    return i;
+}
+
+static inline void SiftDownMin(MedianWindow* m, int i) {
+    for (;;) {
+        int c = 2 * i;
+        if (c > m->half) break;
+        if (c + 1 <= m->half && Less(m, c + 1, c)) c++;
+        if (!Less(m, c, i)) break;
+        Exchange(m, c, i);
+        i = c;
+    }
+}
+
+static inline void SiftDownMax(MedianWindow* m, int i) {
+    for (;;) {
+        int c = 2 * i;
+        if (c < -m->half) break;
+        if (c - 1 >= -m->half && Less(m, c, c - 1)) c--;
+        if (!Less(m, i, c)) break;
+        Exchange(m, c, i);
+        i = c;
+    }
+}
+
+// 자리 slot의 값을 v로 바꾸고 힙 복구, 반환값 = 새 중앙값
+static inline float Replace(MedianWindow* m, int slot, float v) {
+    int i = m->pos[slot];
+    m->value[slot] = v;
+
+    if (i > 0) {
+        int to = SiftUpMin(m, i);
+        if (to != 0) {
+            if (to == i) SiftDownMin(m, i);
+            return m->value[m->heap[0]];
+        }
+    } else if (i < 0) {
+        int to = SiftUpMax(m, i);
+        if (to != 0) {
+            if (to == i) SiftDownMax(m, i);
+            return m->value[m->heap[0]];
+        }
+    }
+
+    // 중앙값 자리가 바뀜: 양쪽 뿌리와 비교 (둘 중 한쪽만 어긋날 수 있음)
+    if (m->half > 0) {
+        if (Less(m, 1, 0)) {
+            Exchange(m, 0, 1);
+            SiftDownMin(m, 1);
+        } else if (Less(m, 0, -1)) {
+            Exchange(m, 0, -1);
+            SiftDownMax(m, -1);
+        }
+    }
+    return m->value[m->heap[0]];
+}
+
+// 0으로 가득 찬 창 (자리 0 = 중앙값, 홀수 자리 = 최대 힙, 짝수 자리 = 최소 힙)
+static void ResetWindow(MedianWindow* m) {
+    int size = 2 * m->half + 1;
+    for (int s = 0; s < size; s++) {
+        int i = (s & 1) ? -(s + 1) / 2 : s / 2;
+        m->value[s] = 0.0f;
+        m->pos[s] = (signed char)i;
+        m->heap[i] = (unsigned char)s;
+    }
+}
+
+static inline void BinWindow(Hpss* h, int bin, MedianWindow* m) {
+    size_t offset = (size_t)bin * h->frames;
+    m->value = h->history + offset;
+    m->pos = h->pos + offset;
+    m->heap = h->heap + offset + h->frames / 2;
+    m->half = h->frames / 2;
+}
+
+int Hpss_Init(Hpss* h, int numBins, int frames, int bins) {
+    if (!h || numBins <= 0 || numBins > HPSS_MAX_BINS) return 0;
+
+    memset(h, 0, sizeof(Hpss));
+    frames |= 1;
+    bins |= 1;
+    if (frames > HPSS_MAX_KERNEL) frames = HPSS_MAX_KERNEL;
+    if (bins > HPSS_MAX_KERNEL) bins = HPSS_MAX_KERNEL;
+
+    size_t count = (size_t)numBins * frames;
+    h->history = (float*)malloc(sizeof(float) * count);
+    h->pos = (signed char*)malloc(count);
+    h->heap = (unsigned char*)malloc(count);
+    if (!h->history || !h->pos || !h->heap) {
+        Hpss_Free(h);
+        return 0;
+    }
+
+    h->numBins = numBins;
+    h->frames = frames;
+    h->bins = bins;
+    h->slot = 0;
+    for (int k = 0; k < numBins; k++) {
+        MedianWindow m;
+        BinWindow(h, k, &m);
+        ResetWindow(&m);
+    }
+    return 1;
+}
+
+void Hpss_Free(Hpss* h) {
+    if (!h) return;
+    free(h->history);
+    free(h->pos);
+    free(h->heap);
+    memset(h, 0, sizeof(Hpss));
+}
+
+void Hpss_Process(Hpss* h, const float* magnitudes, float* percussive, HpssEnergy* energy) {
+    if (!h || !h->history || !magnitudes) return;
+
+    // 주파수 방향 창: 빈 c의 중앙값은 c + half까지 넣은 뒤 (양끝은 0으로 채운 셈)
+    MedianWindow column = { h->column, h->columnPos, h->columnHeap + h->bins / 2, h->bins / 2 };
+    ResetWindow(&column);
+
+    int half = column.half;
+    int numBins = h->numBins;
+    int slot = h->slot;
+    int columnSlot = 0;
+    float harmonicSum = 0.0f, percussiveSum = 0.0f;
+
+    for (int k = 0; k < numBins + half; k++) {
+        float vertical = Replace(&column, columnSlot, k < numBins ? magnitudes[k] : 0.0f);
+        if (++columnSlot == h->bins) columnSlot = 0;
+
+        int c = k - half;
+        if (c < 0) continue;
+
+        // 시간 방향: 빈 c의 가장 오래된 값을 이번 값으로
+        MedianWindow m;
+        BinWindow(h, c, &m);
+        float x = magnitudes[c];
+        float horizontal = Replace(&m, slot, x);
+
+        // 이진 마스크 + 여유: 타악 중앙값이 화성 중앙값의 HPSS_MARGIN배를 넘는 빈만 타악
+        // (소프트 마스크는 지속음 빈에도 프레임마다 흔들리는 잔여를 남겨서 onset 플럭스가 늘어남)
+        float power = x * x;
+        if (vertical > HPSS_MARGIN * horizontal) {
+            percussiveSum += power;
+            if (percussive) percussive[c] = x;
+        } else {
+            harmonicSum += power;
+            if (percussive) percussive[c] = 0.0f;
+        }
+    }
+
+    h->slot = (slot + 1 == h->frames) ? 0 : slot + 1;
+    if (energy) {
+        energy->harmonic = harmonicSum;
+        energy->percussive = percussiveSum;
+    }
+}
@@ -0,0 +1,57 @@
+/*
+ * hpss.h - Streaming Harmonic / Percussive Separation (platform-neutral)
+ *
+ * 메디안 필터 HPSS: 빈마다 시간 방향 중앙값 = 화성 성분 (지속음), 프레임 안 주파수 방향 중앙값 = 타악 성분
+ * 타악 중앙값이 화성 중앙값보다 충분히 큰 빈만 타악 성분, 나머지(잔여 포함)는 화성 성분
+ * 시간 방향은 지난 프레임만 보는 인과 창이라 타악 성분에 추가 지연 없음 (화성 쪽만 창의 절반만큼 늦게 따라감)
+ * 슬라이딩 중앙값은 최대 / 최소 힙을 중앙값에서 맞붙인 구조: 값 하나 교체 = O(log k)
+ */
+
+#ifndef HPSS_H
+#define HPSS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HPSS_MAX_BINS 4096              // FFT_MAX_SIZE / 2
+#define HPSS_MAX_KERNEL 63              // 창 길이 상한 (힙 위치를 char에 담음)
+#define HPSS_HARMONIC_FRAMES 17         // 시간 방향 창 (홉 512 / 48kHz에서 약 180ms)
+#define HPSS_PERCUSSIVE_BINS 17         // 주파수 방향 창 (2048점 / 48kHz에서 약 400Hz)
+#define HPSS_MARGIN 2.0f                // 타악으로 볼 최소 비율 (타악 중앙값 / 화성 중앙값)
+
+// 프레임별 성분 에너지 (마스크로 나눈 파워 합)
+typedef struct {
+    float harmonic;
+    float percussive;
+} HpssEnergy;
+
+typedef struct {
+    int numBins;
+    int frames;                         // 시간 방향 창 길이 (홀수)
+    int bins;                           // 주파수 방향 창 길이 (홀수)
+    int slot;                           // 시간 창에서 이번에 바꿀 자리 (모든 빈 공통)
+
+    // 빈마다 시간 방향 창 [numBins][frames]
+    float* history;                     // 창 안의 값 (자리 순서)
+    signed char* pos;                   // 자리 -> 힙 위치 (-frames/2 ~ frames/2, 0 = 중앙값)
+    unsigned char* heap;                // 힙 위치 + frames/2 -> 자리
+
+    // 주파수 방향 창 (프레임마다 처음부터)
+    float column[HPSS_MAX_KERNEL];
+    signed char columnPos[HPSS_MAX_KERNEL];
+    unsigned char columnHeap[HPSS_MAX_KERNEL];
+} Hpss;
+
+// 초기화 (FFT 크기가 바뀔 때, 창 길이는 홀수로 올림) / 정리
+int Hpss_Init(Hpss* h, int numBins, int frames, int bins);
+void Hpss_Free(Hpss* h);
+
+// 크기 스펙트럼 (numBins개) -> 타악 성분 크기 스펙트럼 (percussive, NULL 가능) + 성분 에너지
+void Hpss_Process(Hpss* h, const float* magnitudes, float* percussive, HpssEnergy* energy);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HPSS_H
@@ -5,9 +5,11 @@
 #include <windows.h>
 #include <shellapi.h>
 #include <dwmapi.h>
+#include <stdio.h>
 #include "media_info.h"
 #include "gif_player.h"
 #include "settings.h"
+#include "audio_capture.h"
 
 // DWM CLOAK 속성 (Windows 10+)
 #ifndef DWMWA_CLOAK
@@ -41,6 +43,19 @@
 #define ID_MENU_AUTOSTART 1020
 #define ID_MENU_CLICKTHROUGH 1021
 #define ID_MENU_AUTOMODE 1022
+#define ID_MENU_SYNC_CLOCK 1030
+#define ID_MENU_SYNC_BEAT 1031
+#define ID_MENU_SYNC_POSITION 1032
+#define ID_MENU_BEATS_AUTO 1035
+#define ID_MENU_BEATS_1 1036
+#define ID_MENU_BEATS_2 1037
+#define ID_MENU_BEATS_4 1038
+#define ID_MENU_BEATS_8 1039
+#define ID_MENU_CACHE_64 1040
+#define ID_MENU_CACHE_128 1041
+#define ID_MENU_CACHE_256 1042
+#define ID_MENU_CACHE_512 1043
+#define ID_MENU_CACHE_1024 1044
 
 // 트레이 아이콘 관련
 #define WM_TRAYICON (WM_USER + 1)
@@ -125,6 +140,25 @@ AppSettings g_settings = {0};
 static int g_lastWidgetX = -1;
 static int g_lastWidgetY = -1;
 
+// 오디오 캡처 (박자 모드에서 감지된 템포를 쓸 때만 실행)
+static int g_audioCaptureActive = 0;
+
+void UpdateAudioCapture(void) {
+    int needed = (GifPlayer_GetPlaybackMode() == GIF_PLAYBACK_BEAT && GifPlayer_GetTempo() <= 0.0f);
+    
+    if (needed && !g_audioCaptureActive) {
+        AudioCapture_SetPlaying(g_mediaInfo.isPlaying);
+        if (AudioCapture_Init()) {
+            g_audioCaptureActive = 1;
+        } else {
+            AudioCapture_Cleanup();  // 실패해도 GIF는 기존 방식으로 재생됨
+        }
+    } else if (!needed && g_audioCaptureActive) {
+        AudioCapture_Cleanup();
+        g_audioCaptureActive = 0;
+    }
+}
+
 // 설정 저장 함수
 void SaveCurrentSettings(void) {
     // 위젯 위치
@@ -144,6 +178,14 @@ void SaveCurrentSettings(void) {
     // 속도
     g_settings.gifSpeedMultiplier = GifPlayer_GetSpeedMultiplier();
     
+    // 재생 방식
+    g_settings.gifPlaybackMode = GifPlayer_GetPlaybackMode();
+    g_settings.gifBeatsPerLoop = GifPlayer_GetBeatsPerLoop();
+    g_settings.gifTempo = GifPlayer_GetTempo();
+    
+    // 프레임 캐시 예산
+    g_settings.gifCacheBudgetMB = GifPlayer_GetCacheBudget();
+    
     // 자동 실행
     g_settings.autoStart = Settings_IsAutoStartEnabled();
     
@@ -156,6 +198,78 @@ int IsInSettingsButton(int x, int y) {
             y >= SETTINGS_BTN_Y && y <= SETTINGS_BTN_Y + SETTINGS_BTN_SIZE);
 }
 
+// GIF 동기화 서브메뉴 추가 (설정/트레이 메뉴 공용)
+void AppendSyncMenu(HMENU hMenu) {
+    HMENU hSyncMenu = CreatePopupMenu();
+    int mode = GifPlayer_GetPlaybackMode();
+    int beats = GifPlayer_GetBeatsPerLoop();
+    
+    AppendMenuW(hSyncMenu, MF_STRING | (mode == GIF_PLAYBACK_CLOCK ? MF_CHECKED : 0), ID_MENU_SYNC_CLOCK, L"Free-running (GIF Speed)");
+    AppendMenuW(hSyncMenu, MF_STRING | (mode == GIF_PLAYBACK_BEAT ? MF_CHECKED : 0), ID_MENU_SYNC_BEAT, L"Beat-synced");
+    AppendMenuW(hSyncMenu, MF_STRING | (mode == GIF_PLAYBACK_POSITION ? MF_CHECKED : 0), ID_MENU_SYNC_POSITION, L"Follow Track Position");
+    AppendMenuW(hSyncMenu, MF_SEPARATOR, 0, NULL);
+    AppendMenuW(hSyncMenu, MF_STRING | (beats == 0 ? MF_CHECKED : 0), ID_MENU_BEATS_AUTO, L"Loop Length: Auto");
+    AppendMenuW(hSyncMenu, MF_STRING | (beats == 1 ? MF_CHECKED : 0), ID_MENU_BEATS_1, L"Loop Length: 1 Beat");
+    AppendMenuW(hSyncMenu, MF_STRING | (beats == 2 ? MF_CHECKED : 0), ID_MENU_BEATS_2, L"Loop Length: 2 Beats");
+    AppendMenuW(hSyncMenu, MF_STRING | (beats == 4 ? MF_CHECKED : 0), ID_MENU_BEATS_4, L"Loop Length: 4 Beats");
+    AppendMenuW(hSyncMenu, MF_STRING | (beats == 8 ? MF_CHECKED : 0), ID_MENU_BEATS_8, L"Loop Length: 8 Beats");
+    
+    AppendMenuW(hMenu, MF_POPUP, (UINT_PTR)hSyncMenu, L"GIF Sync");
+}
+
+// GIF 메모리 사용량 서브메뉴 (GIF별 / 캐시 통계는 표시만, 예산은 선택)
+void AppendMemoryMenu(HMENU hMenu) {
+    HMENU hMemoryMenu = CreatePopupMenu();
+    unsigned long long outside = 0;
+    wchar_t text[160];
+    
+    for (int i = 0; i < GifPlayer_GetCount(); i++) {
+        GifMemoryInfo info;
+        if (!GifPlayer_GetMemoryInfo(i, &info)) continue;
+        
+        unsigned long long cached = info.frameBytes + info.scaledBytes + info.checkpointBytes;
+        outside += info.decoderBytes + info.surfaceBytes;
+        if (info.scaledFrames > 0) {
+            swprintf(text, 160, L"GIF %d%s: %d/%d frames at %dx%d + %d at %dx%d, %.1f MB", i + 1,
+                     info.hidden ? L" (hidden)" : L"", info.cachedFrames, info.frameCount, info.cacheWidth,
+                     info.cacheHeight, info.scaledFrames, info.scaledWidth, info.scaledHeight,
+                     cached / (1024.0 * 1024.0));
+        } else {
+            swprintf(text, 160, L"GIF %d%s: %d/%d frames at %dx%d, %.1f MB", i + 1, info.hidden ? L" (hidden)" : L"",
+                     info.cachedFrames, info.frameCount, info.cacheWidth, info.cacheHeight,
+                     cached / (1024.0 * 1024.0));
+        }
+        AppendMenuW(hMemoryMenu, MF_STRING | MF_GRAYED, 0, text);
+    }
+    if (GetMenuItemCount(hMemoryMenu) > 0) AppendMenuW(hMemoryMenu, MF_SEPARATOR, 0, NULL);
+    
+    // 공용 캐시 (적중 / 실패 / 버림은 실행 후 누적)
+    GifCacheStats stats;
+    GifPlayer_GetCacheStats(&stats);
+    swprintf(text, 160, L"Frame Cache: %.1f / %.0f MB, %d entries", stats.usedBytes / (1024.0 * 1024.0),
+             stats.budgetBytes / (1024.0 * 1024.0), stats.entries);
+    AppendMenuW(hMemoryMenu, MF_STRING | MF_GRAYED, 0, text);
+    swprintf(text, 160, L"Frames: %llu hits, %llu misses (re-decoded, %llu from checkpoints)", stats.frameHits,
+             stats.frameMisses, stats.checkpointHits);
+    AppendMenuW(hMemoryMenu, MF_STRING | MF_GRAYED, 0, text);
+    swprintf(text, 160, L"Window-size frames: %llu hits, %llu misses", stats.scaledHits, stats.scaledMisses);
+    AppendMenuW(hMemoryMenu, MF_STRING | MF_GRAYED, 0, text);
+    swprintf(text, 160, L"Evictions: %llu (%llu from hidden GIFs)", stats.evictions, stats.hiddenEvictions);
+    AppendMenuW(hMemoryMenu, MF_STRING | MF_GRAYED, 0, text);
+    swprintf(text, 160, L"Outside Cache: %.1f MB (decoders, window buffers)", outside / (1024.0 * 1024.0));
+    AppendMenuW(hMemoryMenu, MF_STRING | MF_GRAYED, 0, text);
+    AppendMenuW(hMemoryMenu, MF_SEPARATOR, 0, NULL);
+    
+    int budget = GifPlayer_GetCacheBudget();
+    AppendMenuW(hMemoryMenu, MF_STRING | (budget == 64 ? MF_CHECKED : 0), ID_MENU_CACHE_64, L"Cache Budget: 64 MB");
+    AppendMenuW(hMemoryMenu, MF_STRING | (budget == 128 ? MF_CHECKED : 0), ID_MENU_CACHE_128, L"Cache Budget: 128 MB");
+    AppendMenuW(hMemoryMenu, MF_STRING | (budget == 256 ? MF_CHECKED : 0), ID_MENU_CACHE_256, L"Cache Budget: 256 MB");
+    AppendMenuW(hMemoryMenu, MF_STRING | (budget == 512 ? MF_CHECKED : 0), ID_MENU_CACHE_512, L"Cache Budget: 512 MB");
+    AppendMenuW(hMemoryMenu, MF_STRING | (budget == 1024 ? MF_CHECKED : 0), ID_MENU_CACHE_1024, L"Cache Budget: 1 GB");
+    
+    AppendMenuW(hMenu, MF_POPUP, (UINT_PTR)hMemoryMenu, L"GIF Memory");
+}
+
 // 설정 메뉴 표시
 void ShowSettingsMenu(HWND hwnd) {
     POINT pt;
@@ -177,6 +291,8 @@ void ShowSettingsMenu(HWND hwnd) {
     AppendMenuW(hMenu, MF_STRING, ID_MENU_HIDE_GIFS, L"Hide All GIFs");
     AppendMenuW(hMenu, MF_SEPARATOR, 0, NULL);
     AppendMenuW(hMenu, MF_POPUP, (UINT_PTR)hSpeedMenu, L"GIF Speed");
+    AppendSyncMenu(hMenu);
+    AppendMemoryMenu(hMenu);
     AppendMenuW(hMenu, MF_SEPARATOR, 0, NULL);
     
     // 자동 실행 옵션
@@ -310,6 +426,7 @@ void ShowTrayMenu(HWND hwnd) {
     AppendMenuW(hSpeedMenu, MF_STRING | (currentSpeed == 2.0f ? MF_CHECKED : 0), ID_MENU_SPEED_VFAST, L"2.0x (Very Fast)");
     AppendMenuW(hSpeedMenu, MF_STRING | (currentSpeed == 4.0f ? MF_CHECKED : 0), ID_MENU_SPEED_ULTRA, L"4.0x (Ultra)");
     AppendMenuW(hMenu, MF_POPUP, (UINT_PTR)hSpeedMenu, L"GIF Speed");
+    AppendSyncMenu(hMenu);
     AppendMenuW(hMenu, MF_SEPARATOR, 0, NULL);
     
     // 설정 옵션
@@ -330,6 +447,9 @@ void ShowTrayMenu(HWND hwnd) {
 // 마지막 곡 제목 (변경 감지용)
 static wchar_t g_lastTitle[256] = {0};
 
+// 마지막 미디어 정보 갱신 시각 (재생 위치 보간용)
+static DWORD g_mediaUpdateTime = 0;
+
 // 윈도우 프로시저
 LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
     switch (uMsg) {
@@ -349,6 +469,12 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                 
                 // 미디어 정보 업데이트
                 MediaInfo_Update(&g_mediaInfo);
+                g_mediaUpdateTime = GetTickCount();
+                
+                // 일시정지 중에는 스펙트럼 분석 생략 (오래 이어지면 캡처도 정지)
+                if (g_audioCaptureActive) {
+                    AudioCapture_SetPlaying(g_mediaInfo.isPlaying);
+                }
                 
                 // 곡이 변경되면 앨범 아트 비트맵 갱신
                 if (wcscmp(prevTitle, g_mediaInfo.title) != 0) {
@@ -361,8 +487,27 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                 }
             }
             else if (wParam == GIF_TIMER_ID) {
+                // 위치 모드: 프레임이 재생 위치로 정해지므로 일시정지 중 탐색도 바로 반영
+                if (GifPlayer_GetPlaybackMode() == GIF_PLAYBACK_POSITION) {
+                    double position = g_mediaInfo.positionSeconds;
+                    if (g_mediaInfo.isPlaying) {
+                        // 미디어 정보 갱신(200ms) 사이는 경과 시간으로 보간
+                        position += (GetTickCount() - g_mediaUpdateTime) / 1000.0;
+                    }
+                    GifPlayer_SetTrackPosition(position, g_mediaInfo.hasMedia);
+                    if (g_mediaInfo.hasMedia || g_mediaInfo.isPlaying) {
+                        GifPlayer_NextFrame();
+                    }
+                }
                 // 음악 재생 중일 때만 GIF 프레임 전환
-                if (g_mediaInfo.isPlaying) {
+                else if (g_mediaInfo.isPlaying) {
+                    // 박자 모드: 감지된 박자 위치 전달
+                    if (g_audioCaptureActive) {
+                        double beats = 0.0;
+                        float bpm = 0.0f;
+                        int valid = AudioCapture_GetBeatPosition(&beats, &bpm) && bpm > 0.0f;
+                        GifPlayer_SetBeatPosition(beats, valid);
+                    }
                     GifPlayer_NextFrame();
                 }
             }
@@ -485,6 +630,49 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                     GifPlayer_SetSpeedMultiplier(4.0f);
                     SaveCurrentSettings();
                     break;
+                case ID_MENU_SYNC_CLOCK:
+                    GifPlayer_SetPlaybackMode(GIF_PLAYBACK_CLOCK);
+                    UpdateAudioCapture();
+                    SaveCurrentSettings();
+                    break;
+                case ID_MENU_SYNC_BEAT:
+                    GifPlayer_SetPlaybackMode(GIF_PLAYBACK_BEAT);
+                    UpdateAudioCapture();
+                    SaveCurrentSettings();
+                    break;
+                case ID_MENU_SYNC_POSITION:
+                    GifPlayer_SetPlaybackMode(GIF_PLAYBACK_POSITION);
+                    UpdateAudioCapture();
+                    SaveCurrentSettings();
+                    break;
+                case ID_MENU_BEATS_AUTO:
+                    GifPlayer_SetBeatsPerLoop(0);
+                    SaveCurrentSettings();
+                    break;
+                case ID_MENU_BEATS_1:
+                    GifPlayer_SetBeatsPerLoop(1);
+                    SaveCurrentSettings();
+                    break;
+                case ID_MENU_BEATS_2:
+                    GifPlayer_SetBeatsPerLoop(2);
+                    SaveCurrentSettings();
+                    break;
+                case ID_MENU_BEATS_4:
+                    GifPlayer_SetBeatsPerLoop(4);
+                    SaveCurrentSettings();
+                    break;
+                case ID_MENU_BEATS_8:
+                    GifPlayer_SetBeatsPerLoop(8);
+                    SaveCurrentSettings();
+                    break;
+                case ID_MENU_CACHE_64:
+                case ID_MENU_CACHE_128:
+                case ID_MENU_CACHE_256:
+                case ID_MENU_CACHE_512:
+                case ID_MENU_CACHE_1024:
+                    GifPlayer_SetCacheBudget(64 << (LOWORD(wParam) - ID_MENU_CACHE_64));
+                    SaveCurrentSettings();
+                    break;
                 case ID_MENU_AUTOSTART: {
                     int currentState = Settings_IsAutoStartEnabled();
                     Settings_SetAutoStart(!currentState);
@@ -656,7 +844,8 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance,
         return 1;
     }
     
-    // GIF 플레이어 초기화 (assets/config.txt에서 설정 로드)
+    // GIF 플레이어 초기화 (assets/config.txt에서 설정 로드, 프레임 캐시 예산은 미리 디코딩 전에)
+    GifPlayer_SetCacheBudget(g_settings.gifCacheBudgetMB);
     GifPlayer_Init();
     
     // 저장된 GIF 속도 적용
@@ -664,6 +853,22 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance,
         GifPlayer_SetSpeedMultiplier(g_settings.gifSpeedMultiplier);
     }
     
+    // 저장된 재생 방식 적용 (박자 모드면 오디오 캡처 시작)
+    GifPlayer_SetTempo(g_settings.gifTempo);
+    GifPlayer_SetBeatsPerLoop(g_settings.gifBeatsPerLoop);
+    GifPlayer_SetPlaybackMode(g_settings.gifPlaybackMode);
+    AudioCapture_SetGateThreshold(g_settings.audioGateDb);
+    AudioCapture_SetIdleTimeout(g_settings.audioIdleTimeout);
+    AudioCapture_SetAutoGain(g_settings.audioAutoGain, g_settings.audioAutoGainWindow);
+    if (g_settings.audioDualResolution) {
+        // 저역은 따로 고해상도로 계산하므로 메인 FFT는 절반 크기로 (2048 한 번보다 가벼움)
+        AudioCapture_SetFFTSize(1024);
+        AudioCapture_SetDualResolution(1);
+    }
+    AudioCapture_EnableHpss(g_settings.audioHpss);
+    AudioCapture_SetOutputLatency(g_settings.audioOutputLatency);
+    UpdateAudioCapture();
+    
     // 저장된 GIF 위치 적용 (size가 0이면 위치만 적용, 크기는 원본 유지)
     for (int i = 0; i < g_settings.gifCount && i < MAX_GIFS; i++) {
         if (g_settings.gifs[i].x >= 0 && g_settings.gifs[i].y >= 0) {
@@ -791,6 +996,7 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance,
     if (g_hAlbumArt) DeleteObject(g_hAlbumArt);
     MediaInfo_FreeAlbumArt(&g_mediaInfo);
     GifPlayer_Cleanup();
+    if (g_audioCaptureActive) AudioCapture_Cleanup();
     MediaInfo_Cleanup();
     
     return 0;
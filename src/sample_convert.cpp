@@ -0,0 +1,204 @@
+/*
+ * sample_convert.cpp - PCM / Float Sample Conversion + Downmix
+ * 정수 -> float 변환과 채널 평균은 SIMD 커널 사용, 24비트 packed / 8비트 / double은 스칼라
+ */
+
+#include "sample_convert.h"
+#include "dsp_kernels.h"
+
+#include <string.h>
+
+int SampleFormat_FromWave(int formatTag, int bitsPerSample, int subFormat) {
+    if (formatTag == SAMPLE_WAVE_FORMAT_EXTENSIBLE) {
+        formatTag = subFormat;
+    }
+
+    if (formatTag == SAMPLE_WAVE_FORMAT_PCM) {
+        switch (bitsPerSample) {
+            case 8:  return SAMPLE_FORMAT_U8;
+            case 16: return SAMPLE_FORMAT_S16;
+            case 24: return SAMPLE_FORMAT_S24;
+            case 32: return SAMPLE_FORMAT_S32;
+        }
+    } else if (formatTag == SAMPLE_WAVE_FORMAT_IEEE_FLOAT) {
+        switch (bitsPerSample) {
+            case 32: return SAMPLE_FORMAT_F32;
+            case 64: return SAMPLE_FORMAT_F64;
+        }
+    }
+    return SAMPLE_FORMAT_UNKNOWN;
+}
+
+int SampleFormat_BytesPerSample(int format) {
+    switch (format) {
+        case SAMPLE_FORMAT_U8:  return 1;
+        case SAMPLE_FORMAT_S16: return 2;
+        case SAMPLE_FORMAT_S24: return 3;
+        case SAMPLE_FORMAT_S32: return 4;
+        case SAMPLE_FORMAT_F32: return 4;
+        case SAMPLE_FORMAT_F64: return 8;
+        default:                return 0;
+    }
+}
+
+const char* SampleFormat_Name(int format) {
+    switch (format) {
+        case SAMPLE_FORMAT_U8:  return "u8";
+        case SAMPLE_FORMAT_S16: return "s16";
+        case SAMPLE_FORMAT_S24: return "s24";
+        case SAMPLE_FORMAT_S32: return "s32";
+        case SAMPLE_FORMAT_F32: return "f32";
+        case SAMPLE_FORMAT_F64: return "f64";
+        default:                return "unknown";
+    }
+}
+
+// 인터리브 float -> 모노
+static void Mix(const SampleConverter* cv, const float* in, float* mono, int frames) {
+    if (!cv->weighted) {
+        DspKernels_Get()->downmix(in, mono, frames, cv->channels);
+        return;
+    }
+
+    int channels = cv->channels;
+    for (int i = 0; i < frames; i++) {
+        float sum = 0.0f;
+        for (int ch = 0; ch < channels; ch++) {
+            sum += in[i * channels + ch] * cv->weights[ch];
+        }
+        mono[i] = sum;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 포맷별 변환
+// ---------------------------------------------------------------------------
+
+static void Convert_F32(SampleConverter* cv, const void* in, float* mono, int frames) {
+    Mix(cv, (const float*)in, mono, frames);
+}
+
+static void Convert_S16(SampleConverter* cv, const void* in, float* mono, int frames) {
+    const short* src = (const short*)in;
+    const DspKernels* k = DspKernels_Get();
+    int channels = cv->channels;
+
+    for (int done = 0; done < frames; done += SAMPLE_BLOCK_FRAMES) {
+        int n = frames - done;
+        if (n > SAMPLE_BLOCK_FRAMES) n = SAMPLE_BLOCK_FRAMES;
+        k->int16ToFloat(src + done * channels, cv->scratch, n * channels);
+        Mix(cv, cv->scratch, mono + done, n);
+    }
+}
+
+static void Convert_S32(SampleConverter* cv, const void* in, float* mono, int frames) {
+    const int* src = (const int*)in;
+    const DspKernels* k = DspKernels_Get();
+    int channels = cv->channels;
+
+    for (int done = 0; done < frames; done += SAMPLE_BLOCK_FRAMES) {
+        int n = frames - done;
+        if (n > SAMPLE_BLOCK_FRAMES) n = SAMPLE_BLOCK_FRAMES;
+        k->int32ToFloat(src + done * channels, cv->scratch, n * channels);
+        Mix(cv, cv->scratch, mono + done, n);
+    }
+}
+
+static void Convert_S24(SampleConverter* cv, const void* in, float* mono, int frames) {
+    const unsigned char* src = (const unsigned char*)in;
+    int channels = cv->channels;
+
+    for (int done = 0; done < frames; done += SAMPLE_BLOCK_FRAMES) {
+        int n = frames - done;
+        if (n > SAMPLE_BLOCK_FRAMES) n = SAMPLE_BLOCK_FRAMES;
+
+        // 3바이트를 32비트 상위에 채워서 부호 유지
+        const unsigned char* p = src + (size_t)done * channels * 3;
+        int count = n * channels;
+        for (int i = 0; i < count; i++, p += 3) {
+            int v = (int)(((unsigned int)p[0] << 8) | ((unsigned int)p[1] << 16) | ((unsigned int)p[2] << 24));
+            cv->scratch[i] = (float)v * (1.0f / 2147483648.0f);
+        }
+        Mix(cv, cv->scratch, mono + done, n);
+    }
+}
+
+static void Convert_U8(SampleConverter* cv, const void* in, float* mono, int frames) {
+    const unsigned char* src = (const unsigned char*)in;
+    int channels = cv->channels;
+
+    for (int done = 0; done < frames; done += SAMPLE_BLOCK_FRAMES) {
+        int n = frames - done;
+        if (n > SAMPLE_BLOCK_FRAMES) n = SAMPLE_BLOCK_FRAMES;
+
+        const unsigned char* p = src + (size_t)done * channels;
+        int count = n * channels;
+        for (int i = 0; i < count; i++) {
+            cv->scratch[i] = ((int)p[i] - 128) * (1.0f / 128.0f);
+        }
+        Mix(cv, cv->scratch, mono + done, n);
+    }
+}
+
+static void Convert_F64(SampleConverter* cv, const void* in, float* mono, int frames) {
+    const double* src = (const double*)in;
+    int channels = cv->channels;
+
+    for (int done = 0; done < frames; done += SAMPLE_BLOCK_FRAMES) {
+        int n = frames - done;
+        if (n > SAMPLE_BLOCK_FRAMES) n = SAMPLE_BLOCK_FRAMES;
+
+        const double* p = src + (size_t)done * channels;
+        int count = n * channels;
+        for (int i = 0; i < count; i++) {
+            cv->scratch[i] = (float)p[i];
+        }
+        Mix(cv, cv->scratch, mono + done, n);
+    }
+}
+
+int SampleConverter_Init(SampleConverter* cv, int format, int channels, unsigned int channelMask) {
+    if (!cv || channels < 1 || channels > SAMPLE_MAX_CHANNELS) return 0;
+
+    memset(cv, 0, sizeof(SampleConverter));
+    cv->format = format;
+    cv->channels = channels;
+    cv->bytesPerFrame = SampleFormat_BytesPerSample(format) * channels;
+
+    switch (format) {
+        case SAMPLE_FORMAT_U8:  cv->convert = Convert_U8; break;
+        case SAMPLE_FORMAT_S16: cv->convert = Convert_S16; break;
+        case SAMPLE_FORMAT_S24: cv->convert = Convert_S24; break;
+        case SAMPLE_FORMAT_S32: cv->convert = Convert_S32; break;
+        case SAMPLE_FORMAT_F32: cv->convert = Convert_F32; break;
+        case SAMPLE_FORMAT_F64: cv->convert = Convert_F64; break;
+        default: return 0;
+    }
+
+    // 채널 마스크의 n번째 설정 비트 = n번째 채널, LFE는 스펙트럼에서 제외
+    int included = 0;
+    unsigned int bits = channelMask;
+    for (int ch = 0; ch < channels; ch++) {
+        unsigned int speaker = bits & (~bits + 1);  // 가장 낮은 설정 비트 (없으면 0)
+        bits &= ~speaker;
+
+        int isLfe = (speaker == SAMPLE_SPEAKER_LOW_FREQUENCY);
+        cv->weights[ch] = isLfe ? 0.0f : 1.0f;
+        if (!isLfe) included++;
+    }
+
+    if (included == 0 || included == channels) {
+        // 모든 채널 평균 (SIMD downmix 커널)
+        for (int ch = 0; ch < channels; ch++) cv->weights[ch] = 1.0f / channels;
+        cv->weighted = 0;
+    } else {
+        for (int ch = 0; ch < channels; ch++) cv->weights[ch] /= included;
+        cv->weighted = 1;
+    }
+    return 1;
+}
+
+void SampleConverter_Run(SampleConverter* cv, const void* in, float* mono, int frames) {
+    if (!cv || !cv->convert || frames <= 0) return;
+    cv->convert(cv, in, mono, frames);
+}
@@ -0,0 +1,66 @@
+/*
+ * sample_convert.h - PCM / Float Sample Conversion + Downmix (platform-neutral)
+ *
+ * 장치 믹스 포맷(WAVEFORMATEX / WAVEFORMATEXTENSIBLE)이나 WAV 파일 포맷을
+ * 모노 float로 바꿈. 포맷별 변환 함수는 초기화 때 한 번만 고름
+ */
+
+#ifndef SAMPLE_CONVERT_H
+#define SAMPLE_CONVERT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SAMPLE_MAX_CHANNELS 16
+#define SAMPLE_BLOCK_FRAMES 256     // 변환 블록 크기 (프레임)
+
+// WAVE 포맷 태그 / 스피커 위치 (mmreg.h / ksmedia.h와 같은 값)
+#define SAMPLE_WAVE_FORMAT_PCM 0x0001
+#define SAMPLE_WAVE_FORMAT_IEEE_FLOAT 0x0003
+#define SAMPLE_WAVE_FORMAT_EXTENSIBLE 0xFFFE
+#define SAMPLE_SPEAKER_LOW_FREQUENCY 0x8
+
+// 샘플 포맷 (리틀 엔디언, 인터리브)
+typedef enum {
+    SAMPLE_FORMAT_UNKNOWN = 0,
+    SAMPLE_FORMAT_U8,           // 8비트 부호 없음
+    SAMPLE_FORMAT_S16,
+    SAMPLE_FORMAT_S24,          // 3바이트 packed
+    SAMPLE_FORMAT_S32,          // 32비트 컨테이너 (24-in-32 왼쪽 정렬 포함)
+    SAMPLE_FORMAT_F32,
+    SAMPLE_FORMAT_F64
+} SampleFormat;
+
+// WAVE 헤더 값 -> SampleFormat
+// formatTag가 EXTENSIBLE이면 subFormat = SubFormat GUID의 앞 4바이트 (PCM = 1, IEEE_FLOAT = 3)
+int SampleFormat_FromWave(int formatTag, int bitsPerSample, int subFormat);
+int SampleFormat_BytesPerSample(int format);
+const char* SampleFormat_Name(int format);
+
+typedef struct SampleConverter SampleConverter;
+
+struct SampleConverter {
+    int format;
+    int channels;
+    int bytesPerFrame;
+    int weighted;                           // 0 = 모든 채널 평균 (downmix 커널)
+    float weights[SAMPLE_MAX_CHANNELS];     // 채널별 모노 가중치 (LFE = 0)
+
+    // 포맷별 변환 (초기화 때 선택)
+    void (*convert)(SampleConverter* cv, const void* in, float* mono, int frames);
+
+    float scratch[SAMPLE_BLOCK_FRAMES * SAMPLE_MAX_CHANNELS];   // 인터리브 float 임시 버퍼
+};
+
+// 초기화 (channelMask = dwChannelMask, 0이면 모든 채널 같은 가중치)
+int SampleConverter_Init(SampleConverter* cv, int format, int channels, unsigned int channelMask);
+
+// 인터리브 입력 frames개 -> 모노 float frames개
+void SampleConverter_Run(SampleConverter* cv, const void* in, float* mono, int frames);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SAMPLE_CONVERT_H
@@ -3,6 +3,7 @@
  */
 
 #include "settings.h"
+#include "audio_capture.h"
 #include <shlobj.h>
 #include <stdio.h>
 
@@ -36,6 +37,17 @@ int Settings_Load(AppSettings* settings) {
     settings->widgetY = -1;
     settings->gifCount = 0;
     settings->gifSpeedMultiplier = 1.0f;
+    settings->gifPlaybackMode = 0;
+    settings->gifBeatsPerLoop = 0;
+    settings->gifTempo = 0.0f;
+    settings->gifCacheBudgetMB = 256;
+    settings->audioGateDb = -70.0f;
+    settings->audioIdleTimeout = 5000;
+    settings->audioAutoGain = 1;
+    settings->audioAutoGainWindow = 5.0f;
+    settings->audioDualResolution = 0;
+    settings->audioHpss = 0;
+    settings->audioOutputLatency = -1.0f;
     settings->autoStart = 0;
     
     for (int i = 0; i < MAX_GIFS; i++) {
@@ -62,6 +74,26 @@ int Settings_Load(AppSettings* settings) {
         // GIF 속도
         if (sscanf(line, "gifSpeed=%f", &settings->gifSpeedMultiplier) == 1) continue;
         
+        // GIF 재생 방식
+        if (sscanf(line, "gifPlayback=%d", &settings->gifPlaybackMode) == 1) continue;
+        if (sscanf(line, "gifBeatsPerLoop=%d", &settings->gifBeatsPerLoop) == 1) continue;
+        if (sscanf(line, "gifTempo=%f", &settings->gifTempo) == 1) continue;
+        if (sscanf(line, "gifCacheBudget=%d", &settings->gifCacheBudgetMB) == 1) continue;
+        
+        // 오디오 캡처
+        if (sscanf(line, "audioGate=%f", &settings->audioGateDb) == 1) continue;
+        if (sscanf(line, "audioIdleTimeout=%d", &settings->audioIdleTimeout) == 1) continue;
+        if (sscanf(line, "audioAutoGain=%d", &settings->audioAutoGain) == 1) continue;
+        if (sscanf(line, "audioAutoGainWindow=%f", &settings->audioAutoGainWindow) == 1) {
+            float* window = &settings->audioAutoGainWindow;
+            if (!(*window >= AUDIO_AUTO_GAIN_MIN_WINDOW_SEC)) *window = AUDIO_AUTO_GAIN_MIN_WINDOW_SEC;
+            if (*window > AUDIO_AUTO_GAIN_MAX_WINDOW_SEC) *window = AUDIO_AUTO_GAIN_MAX_WINDOW_SEC;
+            continue;
+        }
+        if (sscanf(line, "audioDualResolution=%d", &settings->audioDualResolution) == 1) continue;
+        if (sscanf(line, "audioHpss=%d", &settings->audioHpss) == 1) continue;
+        if (sscanf(line, "audioOutputLatency=%f", &settings->audioOutputLatency) == 1) continue;
+        
         // 자동 실행
         if (sscanf(line, "autoStart=%d", &settings->autoStart) == 1) continue;
         
@@ -109,6 +141,17 @@ int Settings_Save(const AppSettings* settings) {
     fprintf(file, "widgetX=%d\n", settings->widgetX);
     fprintf(file, "widgetY=%d\n", settings->widgetY);
     fprintf(file, "gifSpeed=%f\n", settings->gifSpeedMultiplier);
+    fprintf(file, "gifPlayback=%d\n", settings->gifPlaybackMode);
+    fprintf(file, "gifBeatsPerLoop=%d\n", settings->gifBeatsPerLoop);
+    fprintf(file, "gifTempo=%f\n", settings->gifTempo);
+    fprintf(file, "gifCacheBudget=%d\n", settings->gifCacheBudgetMB);
+    fprintf(file, "audioGate=%f\n", settings->audioGateDb);
+    fprintf(file, "audioIdleTimeout=%d\n", settings->audioIdleTimeout);
+    fprintf(file, "audioAutoGain=%d\n", settings->audioAutoGain);
+    fprintf(file, "audioAutoGainWindow=%f\n", settings->audioAutoGainWindow);
+    fprintf(file, "audioDualResolution=%d\n", settings->audioDualResolution);
+    fprintf(file, "audioHpss=%d\n", settings->audioHpss);
+    fprintf(file, "audioOutputLatency=%f\n", settings->audioOutputLatency);
     fprintf(file, "autoStart=%d\n", settings->autoStart);
     
     // GIF 위치 및 Z-order
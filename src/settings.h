@@ -31,6 +31,31 @@ typedef struct {
     // GIF 속도 배율
     float gifSpeedMultiplier;
     
+    // GIF 재생 방식 (GifPlaybackMode), 박자 모드 루프 길이 (0 = 자동), 고정 템포 (0 = 감지)
+    int gifPlaybackMode;
+    int gifBeatsPerLoop;
+    float gifTempo;
+    
+    // GIF 프레임 캐시 예산 (모든 GIF 합계, MB)
+    int gifCacheBudgetMB;
+    
+    // 오디오 무음 게이트 (dBFS), 조용할 때 캡처를 멈출 때까지 시간 (ms, 0 = 멈추지 않음)
+    float audioGateDb;
+    int audioIdleTimeout;
+    
+    // 막대별 자동 게인 (0 = 고정 -60 ~ 0dB), 분포를 볼 시간 (초)
+    int audioAutoGain;
+    float audioAutoGainWindow;
+    
+    // 이중 해상도 (저역은 데시메이션한 작은 FFT, 메인 FFT는 1024로)
+    int audioDualResolution;
+    
+    // 화성 / 타악 분리 (박자 추적은 타악 성분으로)
+    int audioHpss;
+    
+    // 캡처 -> 스피커 출력 지연 보정 (ms, 음수 = 장치 스트림 지연 사용)
+    float audioOutputLatency;
+    
     // 자동 실행 여부
     int autoStart;
 } AppSettings;
@@ -0,0 +1,117 @@
+/*
+ * spectral_features.cpp - Spectral Features
+ * 빈마다 한 번씩만 읽으면서 모든 합을 누적 (롤오프만 누적 배열에서 이진 탐색)
+ * 파이프라인 FFT는 사각 창이라 누설이 1/k로 느리게 줄어듦: 크기 대신 파워로 가중해야 중심 / 롤오프가 안 밀림
+ */
+
+#include "spectral_features.h"
+
+#include <string.h>
+#include <math.h>
+
+#define POWER_FLOOR 1e-10f          // log(0) 방지 (-100dB)
+
+// 빠른 log2 (지수 + 2차 근사, 오차 약 0.005 - 평탄도에는 충분)
+static inline float FastLog2(float x) {
+    unsigned int bits;
+    memcpy(&bits, &x, sizeof(bits));
+    float exponent = (float)((int)(bits >> 23) - 127);
+    bits = (bits & 0x007FFFFF) | 0x3F800000;
+    float m;
+    memcpy(&m, &bits, sizeof(m));   // [1, 2)
+    return exponent + (-0.34484843f * m + 2.02466578f) * m - 0.67487759f;
+}
+
+int FeatureExtractor_Init(FeatureExtractor* fe, int fftSize, int sampleRate) {
+    if (!fe || fftSize < 4 || fftSize / 2 > FEATURE_MAX_BINS || sampleRate <= 0) return 0;
+
+    memset(fe, 0, sizeof(FeatureExtractor));
+    fe->numBins = fftSize / 2;
+    fe->binHz = (float)sampleRate / fftSize;
+    fe->firstBin = 1;
+
+    // 빈 폭이 반음 간격보다 넓은 저역은 음을 구분할 수 없으므로 크로마에서 제외
+    float minHz = fe->binHz / (powf(2.0f, 1.0f / 12.0f) - 1.0f);
+    if (minHz < FEATURE_CHROMA_MIN_HZ) minHz = FEATURE_CHROMA_MIN_HZ;
+    float maxHz = FEATURE_CHROMA_MAX_HZ;
+    if (maxHz > (fe->numBins - 1) * fe->binHz) maxHz = (fe->numBins - 1) * fe->binHz;
+
+    fe->chromaFirst = (int)ceilf(minHz / fe->binHz);
+    fe->chromaLast = (int)floorf(maxHz / fe->binHz);
+    if (fe->chromaFirst < fe->firstBin) fe->chromaFirst = fe->firstBin;
+    if (fe->chromaLast < fe->chromaFirst) fe->chromaLast = fe->chromaFirst - 1;  // 크로마 없음
+
+    for (int k = fe->chromaFirst; k <= fe->chromaLast; k++) {
+        // A4 = 440Hz = 9번 음 (C = 0), 가장 가까운 반음
+        float semitone = 12.0f * log2f(k * fe->binHz / 440.0f) + 9.0f;
+        int pc = (int)lrintf(semitone) % 12;
+        if (pc < 0) pc += 12;
+        fe->pitchClass[k] = (unsigned char)pc;
+    }
+    return 1;
+}
+
+// 합 누적 (구간별로 나눠서 크로마 범위 판정 분기를 루프 밖으로)
+typedef struct {
+    float power;        // 파워 합
+    float weighted;     // 빈 번호 * 파워 합
+    float logPower;     // log2(파워) 합
+} FeatureSums;
+
+static inline void Accumulate(FeatureExtractor* fe, const float* mag, int from, int to,
+                              FeatureSums* s, float* chroma) {
+    float power = s->power, weighted = s->weighted, logPower = s->logPower;
+    float* cumulative = fe->cumulative;
+    const unsigned char* pitchClass = fe->pitchClass;
+
+    for (int k = from; k < to; k++) {
+        float m = mag[k];
+        float p = m * m + POWER_FLOOR;
+        power += p;
+        weighted += k * p;
+        logPower += FastLog2(p);
+        cumulative[k] = power;
+        if (chroma) chroma[pitchClass[k]] += p;
+    }
+
+    s->power = power;
+    s->weighted = weighted;
+    s->logPower = logPower;
+}
+
+void FeatureExtractor_Process(FeatureExtractor* fe, const float* magnitudes, SpectralFeatures* out) {
+    if (!fe || !magnitudes || !out) return;
+
+    memset(out, 0, sizeof(SpectralFeatures));
+    FeatureSums s = { 0.0f, 0.0f, 0.0f };
+
+    Accumulate(fe, magnitudes, fe->firstBin, fe->chromaFirst, &s, NULL);
+    Accumulate(fe, magnitudes, fe->chromaFirst, fe->chromaLast + 1, &s, out->chroma);
+    Accumulate(fe, magnitudes, fe->chromaLast + 1, fe->numBins, &s, NULL);
+
+    int count = fe->numBins - fe->firstBin;
+    if (count <= 0) return;
+
+    out->centroid = s.weighted / s.power * fe->binHz;
+    out->flatness = exp2f(s.logPower / count) / (s.power / count);
+    if (out->flatness > 1.0f) out->flatness = 1.0f;  // 근사 오차
+
+    // 누적 파워가 처음으로 목표 이상이 되는 빈
+    float target = FEATURE_ROLLOFF_RATIO * s.power;
+    int lo = fe->firstBin, hi = fe->numBins - 1;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (fe->cumulative[mid] < target) lo = mid + 1;
+        else hi = mid;
+    }
+    out->rolloff = lo * fe->binHz;
+
+    float maxChroma = 0.0f;
+    for (int i = 0; i < FEATURE_CHROMA_BINS; i++) {
+        if (out->chroma[i] > maxChroma) maxChroma = out->chroma[i];
+    }
+    if (maxChroma > 0.0f) {
+        float scale = 1.0f / maxChroma;
+        for (int i = 0; i < FEATURE_CHROMA_BINS; i++) out->chroma[i] *= scale;
+    }
+}
@@ -0,0 +1,49 @@
+/*
+ * spectral_features.h - Spectral Features (platform-neutral)
+ *
+ * 막대용으로 이미 계산한 FFT 크기 스펙트럼에서 음색 특징을 한 번의 순회로 계산
+ * 중심 주파수 / 롤오프 / 평탄도 / 12음 크로마 (밝은 곡 / 어두운 곡 구분, GIF 전환 등)
+ */
+
+#ifndef SPECTRAL_FEATURES_H
+#define SPECTRAL_FEATURES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FEATURE_MAX_BINS 4096       // FFT_MAX_SIZE / 2
+#define FEATURE_CHROMA_BINS 12
+#define FEATURE_ROLLOFF_RATIO 0.85f // 파워 합의 이 비율까지 들어가는 주파수 = 롤오프
+#define FEATURE_CHROMA_MIN_HZ 55.0f // 크로마에 쓰는 범위 (A1 ~ 약 D#8)
+#define FEATURE_CHROMA_MAX_HZ 5000.0f
+
+// 프레임별 특징 (UI에 전달)
+typedef struct {
+    float centroid;                 // 스펙트럼 중심 (Hz, 파워 가중 평균)
+    float rolloff;                  // 파워 합의 85%가 들어가는 주파수 (Hz)
+    float flatness;                 // 0.0 (순음) ~ 1.0 (백색 잡음), 파워 기하평균 / 산술평균
+    float chroma[FEATURE_CHROMA_BINS];  // C, C#, ..., B (가장 큰 음 = 1.0)
+} SpectralFeatures;
+
+typedef struct {
+    int numBins;
+    float binHz;
+    int firstBin;                   // 분석 범위 (DC 제외 ~ numBins - 1)
+    int chromaFirst;                // 크로마 범위 (이 밖의 빈은 pitchClass 없음)
+    int chromaLast;
+    unsigned char pitchClass[FEATURE_MAX_BINS];     // 빈 -> 음 (0 = C)
+    float cumulative[FEATURE_MAX_BINS];             // 누적 파워 (롤오프 탐색용, 작업 공간)
+} FeatureExtractor;
+
+// 초기화 (FFT 크기가 바뀔 때만, 빈 -> 음 테이블 계산)
+int FeatureExtractor_Init(FeatureExtractor* fe, int fftSize, int sampleRate);
+
+// 크기 스펙트럼 (fftSize / 2개) -> 특징
+void FeatureExtractor_Process(FeatureExtractor* fe, const float* magnitudes, SpectralFeatures* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SPECTRAL_FEATURES_H
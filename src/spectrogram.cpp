@@ -0,0 +1,126 @@
+/*
+ * spectrogram.cpp - Spectrum History Ring
+ * 행 번호는 계속 증가하는 카운터, 슬롯 = 번호 % capacity
+ * 읽기 구간의 첫 행은 쓰는 쪽이 번호 start + capacity를 쓰기 시작할 때 덮어쓰임 -> Validate로 확인
+ */
+
+#include "spectrogram.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SPECTROGRAM_CAPACITY (SPECTROGRAM_MAX_ROWS + SPECTROGRAM_GUARD_ROWS)
+
+void Spectrogram_Init(Spectrogram* sg) {
+    if (!sg) return;
+    sg->data = NULL;
+    sg->generation.store(0, std::memory_order_relaxed);
+    sg->rows.store(0, std::memory_order_relaxed);
+    sg->barCount.store(0, std::memory_order_relaxed);
+    sg->capacity.store(0, std::memory_order_relaxed);
+    sg->written.store(0, std::memory_order_relaxed);
+}
+
+void Spectrogram_Free(Spectrogram* sg) {
+    if (!sg) return;
+    free(sg->data);
+    Spectrogram_Init(sg);
+}
+
+int Spectrogram_Configure(Spectrogram* sg, int rows, int barCount) {
+    if (!sg || rows < 0 || rows > SPECTROGRAM_MAX_ROWS) return 0;
+    if (rows > 0 && (barCount <= 0 || barCount > SPECTRUM_MAX_BARS)) return 0;
+
+    // 크기가 바뀌어도 다시 할당하지 않음: 읽는 쪽이 예전 구간을 들고 있을 수 있음
+    if (rows > 0 && !sg->data) {
+        sg->data = (float*)calloc((size_t)SPECTROGRAM_CAPACITY * SPECTRUM_MAX_BARS, sizeof(float));
+        if (!sg->data) return 0;
+    }
+
+    unsigned int generation = sg->generation.load(std::memory_order_relaxed);
+    sg->generation.store(generation + 1, std::memory_order_relaxed);     // 홀수 = 바꾸는 중
+    std::atomic_thread_fence(std::memory_order_release);
+
+    sg->rows.store(rows, std::memory_order_relaxed);
+    sg->barCount.store(rows > 0 ? barCount : 0, std::memory_order_relaxed);
+    sg->capacity.store(rows > 0 ? rows + SPECTROGRAM_GUARD_ROWS : 0, std::memory_order_relaxed);
+    sg->written.store(0, std::memory_order_relaxed);
+
+    sg->generation.store(generation + 2, std::memory_order_release);
+    return 1;
+}
+
+void Spectrogram_Push(Spectrogram* sg, const float* bars, int count) {
+    if (!sg || !bars || count <= 0) return;
+
+    int capacity = sg->capacity.load(std::memory_order_relaxed);
+    if (capacity == 0) return;
+    int barCount = sg->barCount.load(std::memory_order_relaxed);
+
+    unsigned long long n = sg->written.load(std::memory_order_relaxed);
+    float* row = sg->data + (size_t)(n % (unsigned long long)capacity) * barCount;
+
+    // 막대 수 맞추기 (줄일 때는 인접 막대 평균, 늘릴 때는 같은 값 반복)
+    if (count == barCount) {
+        memcpy(row, bars, sizeof(float) * barCount);
+    } else if (count > barCount) {
+        for (int i = 0; i < barCount; i++) {
+            int start = i * count / barCount;
+            int end = (i + 1) * count / barCount;
+            float sum = 0.0f;
+            for (int j = start; j < end; j++) sum += bars[j];
+            row[i] = sum / (end - start);
+        }
+    } else {
+        for (int i = 0; i < barCount; i++) row[i] = bars[i * count / barCount];
+    }
+
+    sg->written.store(n + 1, std::memory_order_release);
+}
+
+int Spectrogram_Read(Spectrogram* sg, int maxRows, SpectrogramView* view) {
+    if (!sg || !view) return 0;
+    memset(view, 0, sizeof(SpectrogramView));
+
+    unsigned int generation = sg->generation.load(std::memory_order_acquire);
+    if (generation & 1) return 0;
+
+    int rows = sg->rows.load(std::memory_order_relaxed);
+    int barCount = sg->barCount.load(std::memory_order_relaxed);
+    int capacity = sg->capacity.load(std::memory_order_relaxed);
+    unsigned long long written = sg->written.load(std::memory_order_acquire);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sg->generation.load(std::memory_order_relaxed) != generation) return 0;
+    if (rows == 0 || written == 0) return 0;
+
+    // 가드 행만큼 여유를 두고 최근 rows개까지만
+    unsigned long long count = written < (unsigned long long)rows ? written : (unsigned long long)rows;
+    if (maxRows > 0 && count > (unsigned long long)maxRows) count = (unsigned long long)maxRows;
+
+    unsigned long long start = written - count;
+    int slot = (int)(start % (unsigned long long)capacity);
+    int first = capacity - slot;
+    if ((unsigned long long)first > count) first = (int)count;
+
+    view->first = sg->data + (size_t)slot * barCount;
+    view->firstRows = first;
+    view->second = (int)count > first ? sg->data : NULL;
+    view->secondRows = (int)count - first;
+    view->barCount = barCount;
+    view->start = start;
+    view->generation = generation;
+    return (int)count;
+}
+
+int Spectrogram_Validate(Spectrogram* sg, const SpectrogramView* view) {
+    if (!sg || !view || view->firstRows + view->secondRows == 0) return 0;
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    unsigned long long written = sg->written.load(std::memory_order_relaxed);
+    if (sg->generation.load(std::memory_order_relaxed) != view->generation) return 0;
+
+    // 쓰는 쪽이 start + capacity번 행을 쓰기 시작했으면 첫 행이 덮어쓰였을 수 있음
+    int capacity = sg->capacity.load(std::memory_order_relaxed);
+    return written - view->start < (unsigned long long)capacity;
+}
@@ -0,0 +1,44 @@
+/*
+ * spectrogram.h - Spectrum History Ring (platform-neutral, C++ 전용)
+ *
+ * 워터폴 / 스펙트로그램용: 최근 프레임의 막대 값을 행 단위로 연속 메모리에 보관
+ * 쓰는 쪽(DSP 스레드) 하나, 읽는 쪽 여럿, 읽기는 복사 없이 링 안을 가리키는 두 구간
+ * 새 행은 가장 오래된 행 자리에 덮어쓰므로 프레임마다 memmove 없음 (그리는 쪽이 두 구간을 이어 붙임)
+ */
+
+#ifndef SPECTROGRAM_H
+#define SPECTROGRAM_H
+
+#include "audio_capture.h"
+
+#include <atomic>
+
+// 읽는 동안 쓰는 쪽이 덮어쓰지 못하게 보이는 행 수보다 이만큼 더 큰 링 (홉 512 / 48kHz에서 약 85ms)
+#define SPECTROGRAM_GUARD_ROWS 8
+
+typedef struct {
+    float* data;                    // 처음 켤 때 최대 크기로 한 번만 할당 (읽는 쪽이 구간을 들고 있어도 안전)
+    std::atomic<unsigned int> generation;   // 배치를 바꿀 때마다 +2 (홀수 = 바꾸는 중)
+    std::atomic<int> rows;          // 읽을 수 있는 행 수 (0 = 꺼짐)
+    std::atomic<int> barCount;      // 행 길이
+    std::atomic<int> capacity;      // 링 행 수 (rows + SPECTROGRAM_GUARD_ROWS)
+    alignas(64) std::atomic<unsigned long long> written;   // 지금까지 쓴 행 수
+} Spectrogram;
+
+// 초기화 (메모리는 Configure에서 처음 켤 때) / 정리 (읽는 쪽이 모두 끝난 뒤)
+void Spectrogram_Init(Spectrogram* sg);
+void Spectrogram_Free(Spectrogram* sg);
+
+// 쓰는 쪽: 행 수 / 행 길이 변경 (rows = 0이면 끔, 기록은 처음부터 다시), 반환값 = 적용했는지
+int Spectrogram_Configure(Spectrogram* sg, int rows, int barCount);
+
+// 쓰는 쪽: 막대 값 한 행 추가 (막대 수가 다르면 행 길이에 맞춰 합치거나 나눔)
+void Spectrogram_Push(Spectrogram* sg, const float* bars, int count);
+
+// 읽는 쪽: 최근 maxRows개 행 (0 이하 = 전부), 반환값 = 행 수 (꺼져 있거나 비었으면 0)
+int Spectrogram_Read(Spectrogram* sg, int maxRows, SpectrogramView* view);
+
+// 읽는 쪽: 구간을 다 쓴 뒤 그동안 덮어쓰이거나 배치가 바뀌지 않았는지 (0이면 버리고 다시 읽기)
+int Spectrogram_Validate(Spectrogram* sg, const SpectrogramView* view);
+
+#endif // SPECTROGRAM_H
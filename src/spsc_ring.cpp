@@ -0,0 +1,107 @@
+/*
+ * spsc_ring.cpp - Wait-free SPSC Ring
+ * head/tail은 계속 증가하는 카운터, 인덱스는 mask로 자름 (오버플로도 안전)
+ */
+
+#include "spsc_ring.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+int SpscRing_Init(SpscRing* ring, unsigned int elementSize, unsigned int capacity) {
+    if (!ring || elementSize == 0 || capacity == 0 || capacity > 0x40000000u) return 0;
+
+    unsigned int cap = 1;
+    while (cap < capacity) cap <<= 1;
+
+    ring->data = (unsigned char*)calloc(cap, elementSize);
+    if (!ring->data) return 0;
+
+    ring->elementSize = elementSize;
+    ring->capacity = cap;
+    ring->mask = cap - 1;
+    ring->head.store(0, std::memory_order_relaxed);
+    ring->tail.store(0, std::memory_order_relaxed);
+    return 1;
+}
+
+void SpscRing_Free(SpscRing* ring) {
+    if (!ring) return;
+    free(ring->data);
+    ring->data = NULL;
+    ring->capacity = 0;
+    ring->mask = 0;
+    ring->head.store(0, std::memory_order_relaxed);
+    ring->tail.store(0, std::memory_order_relaxed);
+}
+
+unsigned int SpscRing_Write(SpscRing* ring, const void* items, unsigned int count) {
+    if (!ring || !ring->data || count == 0) return 0;
+
+    unsigned int head = ring->head.load(std::memory_order_relaxed);
+    unsigned int tail = ring->tail.load(std::memory_order_acquire);
+    unsigned int space = ring->capacity - (head - tail);
+    if (count > space) count = space;
+    if (count == 0) return 0;
+
+    // 버퍼 끝에서 잘라 최대 두 번 복사
+    unsigned int start = head & ring->mask;
+    unsigned int first = ring->capacity - start;
+    if (first > count) first = count;
+
+    size_t es = ring->elementSize;
+    unsigned char* dst = ring->data + start * es;
+    if (items) {
+        const unsigned char* src = (const unsigned char*)items;
+        memcpy(dst, src, first * es);
+        memcpy(ring->data, src + first * es, (count - first) * es);
+    } else {
+        memset(dst, 0, first * es);
+        memset(ring->data, 0, (count - first) * es);
+    }
+
+    ring->head.store(head + count, std::memory_order_release);
+    return count;
+}
+
+unsigned int SpscRing_Read(SpscRing* ring, void* items, unsigned int maxCount) {
+    if (!ring || !ring->data || maxCount == 0) return 0;
+
+    unsigned int tail = ring->tail.load(std::memory_order_relaxed);
+    unsigned int head = ring->head.load(std::memory_order_acquire);
+    unsigned int count = head - tail;
+    if (count > maxCount) count = maxCount;
+    if (count == 0) return 0;
+
+    unsigned int start = tail & ring->mask;
+    unsigned int first = ring->capacity - start;
+    if (first > count) first = count;
+
+    size_t es = ring->elementSize;
+    if (items) {
+        unsigned char* dst = (unsigned char*)items;
+        memcpy(dst, ring->data + start * es, first * es);
+        memcpy(dst + first * es, ring->data, (count - first) * es);
+    }
+
+    ring->tail.store(tail + count, std::memory_order_release);
+    return count;
+}
+
+int SpscRing_Peek(SpscRing* ring, void* item) {
+    if (!ring || !ring->data || !item) return 0;
+
+    unsigned int tail = ring->tail.load(std::memory_order_relaxed);
+    unsigned int head = ring->head.load(std::memory_order_acquire);
+    if (head == tail) return 0;
+
+    memcpy(item, ring->data + (tail & ring->mask) * ring->elementSize, ring->elementSize);
+    return 1;
+}
+
+unsigned int SpscRing_Available(SpscRing* ring) {
+    if (!ring) return 0;
+    unsigned int tail = ring->tail.load(std::memory_order_relaxed);
+    unsigned int head = ring->head.load(std::memory_order_acquire);
+    return head - tail;
+}
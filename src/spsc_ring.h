@@ -0,0 +1,37 @@
+/*
+ * spsc_ring.h - Wait-free Single-Producer/Single-Consumer Ring (platform-neutral, C++ 전용)
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+
+// 생산자 스레드 하나, 소비자 스레드 하나 사이의 고정 크기 큐
+// 락도 재시도 루프도 없음: 쓰기/읽기는 가능한 만큼만 처리하고 개수를 돌려줌
+typedef struct {
+    unsigned char* data;
+    unsigned int elementSize;
+    unsigned int capacity;                  // 2의 거듭제곱
+    unsigned int mask;
+    alignas(64) std::atomic<unsigned int> head;   // 생산자가 쓴 전체 개수
+    alignas(64) std::atomic<unsigned int> tail;   // 소비자가 읽은 전체 개수
+} SpscRing;
+
+// 초기화 / 정리 (capacity는 2의 거듭제곱으로 올림)
+int SpscRing_Init(SpscRing* ring, unsigned int elementSize, unsigned int capacity);
+void SpscRing_Free(SpscRing* ring);
+
+// 생산자: 최대 count개 쓰기 (items가 NULL이면 0으로 채움), 반환값 = 실제로 쓴 개수
+unsigned int SpscRing_Write(SpscRing* ring, const void* items, unsigned int count);
+
+// 소비자: 최대 maxCount개 읽기, 반환값 = 실제로 읽은 개수
+unsigned int SpscRing_Read(SpscRing* ring, void* items, unsigned int maxCount);
+
+// 소비자: 맨 앞 항목을 꺼내지 않고 보기 (없으면 0)
+int SpscRing_Peek(SpscRing* ring, void* item);
+
+// 읽을 수 있는 개수 (소비자 쪽에서 호출)
+unsigned int SpscRing_Available(SpscRing* ring);
+
+#endif // SPSC_RING_H
@@ -0,0 +1,103 @@
+/*
+ * stft.cpp - Overlapping STFT Sample Ring
+ * 미러링 버퍼: 샘플을 pos와 pos+N 두 곳에 써서 ring[pos .. pos+N) 이 항상 연속된 윈도우가 됨
+ */
+
+#include "stft.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+int STFT_Init(STFTBuffer* stft, int windowSize, int hopSize, int incremental) {
+    if (!stft || windowSize <= 0 || hopSize <= 0 || hopSize > windowSize) return 0;
+
+    memset(stft, 0, sizeof(STFTBuffer));
+    stft->windowSize = windowSize;
+    stft->hopSize = hopSize;
+    stft->incremental = incremental ? 1 : 0;
+
+    int ringSize = stft->incremental ? windowSize * 2 : windowSize;
+    stft->ring = (float*)calloc(ringSize, sizeof(float));
+    if (!stft->incremental) {
+        stft->frame = (float*)calloc(windowSize, sizeof(float));
+    }
+
+    if (!stft->ring || (!stft->incremental && !stft->frame)) {
+        STFT_Free(stft);
+        return 0;
+    }
+    return 1;
+}
+
+void STFT_Free(STFTBuffer* stft) {
+    if (!stft) return;
+    free(stft->ring);
+    free(stft->frame);
+    memset(stft, 0, sizeof(STFTBuffer));
+}
+
+void STFT_Reset(STFTBuffer* stft) {
+    if (!stft || !stft->ring) return;
+    int ringSize = stft->incremental ? stft->windowSize * 2 : stft->windowSize;
+    memset(stft->ring, 0, sizeof(float) * ringSize);
+    stft->writePos = 0;
+    stft->filled = 0;
+    stft->sinceHop = 0;
+    stft->totalSamples = 0;
+}
+
+int STFT_Push(STFTBuffer* stft, const float* samples, int count, const float** frameOut) {
+    if (frameOut) *frameOut = NULL;
+    if (!stft || !stft->ring || count <= 0) return 0;
+
+    int n = stft->windowSize;
+
+    // 다음 프레임까지 남은 샘플 수 (처음엔 윈도우가 다 찰 때까지)
+    int needed = (stft->filled < n) ? (n - stft->filled) : (stft->hopSize - stft->sinceHop);
+    int take = (count < needed) ? count : needed;
+
+    // 원형 버퍼 끝에서 잘라서 최대 두 덩어리로 복사
+    int done = 0;
+    while (done < take) {
+        int chunk = n - stft->writePos;
+        if (chunk > take - done) chunk = take - done;
+
+        float* dst = stft->ring + stft->writePos;
+        if (samples) {
+            memcpy(dst, samples + done, sizeof(float) * chunk);
+        } else {
+            memset(dst, 0, sizeof(float) * chunk);
+        }
+        if (stft->incremental) {
+            memcpy(dst + n, dst, sizeof(float) * chunk);  // 미러
+        }
+
+        stft->writePos += chunk;
+        if (stft->writePos == n) stft->writePos = 0;
+        done += chunk;
+    }
+
+    stft->totalSamples += take;
+    if (stft->filled < n) {
+        stft->filled += take;
+        if (stft->filled == n) stft->sinceHop = stft->hopSize;  // 첫 프레임
+    } else {
+        stft->sinceHop += take;
+    }
+
+    if (stft->filled == n && stft->sinceHop >= stft->hopSize) {
+        stft->sinceHop = 0;
+
+        // writePos = 가장 오래된 샘플 위치
+        if (stft->incremental) {
+            if (frameOut) *frameOut = stft->ring + stft->writePos;
+        } else {
+            int tail = n - stft->writePos;
+            memcpy(stft->frame, stft->ring + stft->writePos, sizeof(float) * tail);
+            memcpy(stft->frame + tail, stft->ring, sizeof(float) * stft->writePos);
+            if (frameOut) *frameOut = stft->frame;
+        }
+    }
+
+    return take;
+}
@@ -0,0 +1,42 @@
+/*
+ * stft.h - Overlapping STFT Sample Ring (platform-neutral)
+ */
+
+#ifndef STFT_H
+#define STFT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 겹치는 분석 윈도우용 원형 샘플 버퍼
+// hopSize 샘플이 들어올 때마다 최근 windowSize 샘플로 된 프레임 하나를 내보냄
+typedef struct {
+    int windowSize;     // 분석 윈도우 길이 (FFT 크기)
+    int hopSize;        // 프레임 간격 (샘플)
+    int incremental;    // 1 = 미러링 버퍼에서 바로 읽기 (복사 없음), 0 = 매 홉마다 선형 버퍼로 복사
+    float* ring;        // [windowSize * 2] 미러링 원형 버퍼 (incremental) 또는 [windowSize]
+    float* frame;       // [windowSize] 선형 프레임 버퍼 (incremental이 아닐 때)
+    int writePos;       // 다음에 쓸 위치 (0 ~ windowSize-1)
+    int filled;         // 채워진 샘플 수 (windowSize까지)
+    int sinceHop;       // 마지막 프레임 이후 들어온 샘플 수
+    unsigned long long totalSamples;  // 지금까지 들어온 전체 샘플 수
+} STFTBuffer;
+
+// 초기화 / 정리
+int STFT_Init(STFTBuffer* stft, int windowSize, int hopSize, int incremental);
+void STFT_Free(STFTBuffer* stft);
+
+// 버퍼 비우기 (설정은 유지)
+void STFT_Reset(STFTBuffer* stft);
+
+// 샘플 추가 (samples가 NULL이면 무음으로 채움)
+// 홉 경계에 도달하면 그 자리에서 멈추고 *frameOut에 windowSize 길이 프레임을 돌려줌
+// 반환값 = 사용한 샘플 수 (count보다 작으면 나머지를 다시 넣어야 함)
+int STFT_Push(STFTBuffer* stft, const float* samples, int count, const float** frameOut);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STFT_H